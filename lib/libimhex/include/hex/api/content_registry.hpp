@@ -6,9 +6,11 @@
 #include <pl/pattern_language.hpp>
 #include <hex/api/imhex_api.hpp>
 #include <hex/api/event.hpp>
+#include <hex/helpers/crypto.hpp>
 
 #include <functional>
 #include <map>
+#include <memory>
 #include <span>
 #include <string>
 #include <string_view>
@@ -748,7 +750,7 @@ namespace hex {
 
                 class Function {
                 public:
-                    using Callback = std::function<std::vector<u8>(const Region&, prv::Provider *)>;
+                    using Callback = std::function<std::unique_ptr<crypt::Hasher>()>;
 
                     Function(Hash *type, std::string name, Callback callback)
                         : m_type(type), m_name(std::move(name)), m_callback(std::move(callback)) {
@@ -759,24 +761,19 @@ namespace hex {
                     [[nodiscard]] const Hash *getType() const { return this->m_type; }
                     [[nodiscard]] const std::string &getName() const { return this->m_name; }
 
-                    const std::vector<u8>& get(const Region& region, prv::Provider *provider) {
-                        if (this->m_cache.empty()) {
-                            this->m_cache = this->m_callback(region, provider);
-                        }
-
-                        return this->m_cache;
-                    }
-
-                    void reset() {
-                        this->m_cache.clear();
+                    /**
+                     * @brief Creates a hasher that calculates the hash with the settings this function was created with
+                     * Hashers are independent of each other and of the function so they can be used on any thread
+                     * @return New hasher
+                     */
+                    [[nodiscard]] std::unique_ptr<crypt::Hasher> createHasher() const {
+                        return this->m_callback();
                     }
 
                 private:
                     Hash *m_type;
                     std::string m_name;
                     Callback m_callback;
-
-                    std::vector<u8> m_cache;
                 };
 
                 virtual void draw() { }
@@ -70,11 +70,28 @@ namespace hex {
             namespace impl {
 
                 using HighlightingFunction = std::function<std::optional<color_t>(u64, const u8*, size_t, bool)>;
+                using HighlightingRegionFunction = std::function<std::vector<Highlighting>(const Region &)>;
 
                 std::map<u32, Highlighting> &getBackgroundHighlights();
                 std::map<u32, HighlightingFunction> &getBackgroundHighlightingFunctions();
+                std::map<u32, HighlightingRegionFunction> &getBackgroundHighlightingRegionFunctions();
                 std::map<u32, Highlighting> &getForegroundHighlights();
                 std::map<u32, HighlightingFunction> &getForegroundHighlightingFunctions();
+                std::map<u32, HighlightingRegionFunction> &getForegroundHighlightingRegionFunctions();
+
+                /**
+                 * @brief Finds all static background highlightings overlapping a region using an interval tree
+                 * @param region Region to search
+                 * @return Highlightings in the order they were added
+                 */
+                std::vector<Highlighting> findBackgroundHighlights(const Region &region);
+
+                /**
+                 * @brief Finds all static foreground highlightings overlapping a region using an interval tree
+                 * @param region Region to search
+                 * @return Highlightings in the order they were added
+                 */
+                std::vector<Highlighting> findForegroundHighlights(const Region &region);
                 std::map<u32, Tooltip> &getTooltips();
                 std::map<u32, TooltipFunction> &getTooltipFunctions();
 
@@ -154,6 +171,22 @@ namespace hex {
             void removeBackgroundHighlightingProvider(u32 id);
 
 
+            /**
+             * @brief Adds a background color highlighting to the Hex Editor using a callback function that handles a whole region at once
+             * The function gets called once for all rows that are visible and returns all highlightings overlapping them.
+             * Earlier highlightings take precedence over later ones. The results are cached until EventHighlightingChanged is posted
+             * @param function Function returning the highlightings overlapping the given region
+             * @return Unique ID used to remove the highlighting again later
+             */
+            u32 addBackgroundHighlightingRegionProvider(const impl::HighlightingRegionFunction &function);
+
+            /**
+             * @brief Removes a region background color highlighting from the Hex Editor
+             * @param id The ID of the highlighting to remove
+             */
+            void removeBackgroundHighlightingRegionProvider(u32 id);
+
+
             /**
              * @brief Adds a foreground color highlighting to the Hex Editor using a callback function
              * @param function Function that draws the highlighting based on the hovered region
@@ -167,6 +200,22 @@ namespace hex {
              */
             void removeForegroundHighlightingProvider(u32 id);
 
+
+            /**
+             * @brief Adds a foreground color highlighting to the Hex Editor using a callback function that handles a whole region at once
+             * The function gets called once for all rows that are visible and returns all highlightings overlapping them.
+             * Earlier highlightings take precedence over later ones. The results are cached until EventHighlightingChanged is posted
+             * @param function Function returning the highlightings overlapping the given region
+             * @return Unique ID used to remove the highlighting again later
+             */
+            u32 addForegroundHighlightingRegionProvider(const impl::HighlightingRegionFunction &function);
+
+            /**
+             * @brief Removes a region foreground color highlighting from the Hex Editor
+             * @param id The ID of the highlighting to remove
+             */
+            void removeForegroundHighlightingRegionProvider(u32 id);
+
             /**
              * @brief Checks if there's a valid selection in the Hex Editor right now
              */
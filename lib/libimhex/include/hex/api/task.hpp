@@ -9,7 +9,10 @@
 #include <mutex>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <list>
+#include <vector>
+#include <atomic>
 #include <condition_variable>
 
 namespace hex {
@@ -17,13 +20,23 @@ namespace hex {
     class TaskHolder;
     class TaskManager;
 
+    /**
+     * @brief Order in which queued tasks get picked up by the worker threads
+     * Tasks that are already running are never preempted
+     */
+    enum class TaskPriority : u8 {
+        Interactive,    // Short tasks the user is actively waiting for, e.g. updating the data inspector
+        Normal,
+        Background      // Long running tasks that may wait until everything else is done
+    };
+
     /**
      * @brief A type representing a running asynchronous task
      */
     class Task {
     public:
         Task() = default;
-        Task(std::string unlocalizedName, u64 maxValue, bool background, std::function<void(Task &)> function);
+        Task(std::string unlocalizedName, u64 maxValue, bool background, std::function<void(Task &)> function, TaskPriority priority = TaskPriority::Normal);
 
         Task(const Task&) = delete;
         Task(Task &&other) noexcept;
@@ -55,6 +68,19 @@ namespace hex {
          */
         void setInterruptCallback(std::function<void()> callback);
 
+        /**
+         * @brief Splits a region into chunks and processes them in parallel on all worker threads
+         * Each chunk gets its own subtask. Progress reported by a subtask gets added to the progress of this task,
+         * and once a chunk is done, the progress of this task has advanced by the size of the chunk.
+         * Interrupting this task interrupts all subtasks as well.
+         * The calling thread works on chunks too and only returns once all of them have been processed.
+         * Exceptions thrown by a chunk cancel the remaining chunks and are rethrown on the calling thread
+         * @param region Region to split
+         * @param chunkSize Maximum size of each chunk
+         * @param function Function called for every chunk with the subtask that's processing it
+         */
+        void parallelFor(Region region, u64 chunkSize, const std::function<void(Task &subtask, Region chunk)> &function);
+
         [[nodiscard]] bool isBackgroundTask() const;
         [[nodiscard]] bool isFinished() const;
         [[nodiscard]] bool hadException() const;
@@ -67,8 +93,12 @@ namespace hex {
         [[nodiscard]] const std::string &getUnlocalizedName();
         [[nodiscard]] u64 getValue() const;
         [[nodiscard]] u64 getMaxValue() const;
+        [[nodiscard]] TaskPriority getPriority() const;
 
     private:
+        explicit Task(Task &parent);
+
+        void addProgress(u64 value);
         void finish();
         void interruption();
         void exception(const char *message);
@@ -83,6 +113,10 @@ namespace hex {
 
         std::atomic<bool> m_shouldInterrupt = false;
         std::atomic<bool> m_background = true;
+        TaskPriority m_priority = TaskPriority::Normal;
+
+        // Task this task is a subtask of, if any
+        Task *m_parent = nullptr;
 
         std::atomic<bool> m_interrupted = false;
         std::atomic<bool> m_finished = false;
@@ -130,17 +164,19 @@ namespace hex {
          * @param name Name of the task
          * @param maxValue Maximum value of the task
          * @param function Function to be executed
+         * @param priority Priority of the task
          * @return A TaskHolder holding a weak reference to the task
          */
-        static TaskHolder createTask(std::string name, u64 maxValue, std::function<void(Task &)> function);
+        static TaskHolder createTask(std::string name, u64 maxValue, std::function<void(Task &)> function, TaskPriority priority = TaskPriority::Normal);
 
         /**
          * @brief Creates a new asynchronous task that does not get displayed in the Task Manager
          * @param name Name of the task
          * @param function Function to be executed
+         * @param priority Priority of the task
          * @return A TaskHolder holding a weak reference to the task
          */
-        static TaskHolder createBackgroundTask(std::string name, std::function<void(Task &)> function);
+        static TaskHolder createBackgroundTask(std::string name, std::function<void(Task &)> function, TaskPriority priority = TaskPriority::Normal);
 
 
         /**
@@ -165,18 +201,32 @@ namespace hex {
         static void runDeferredCalls();
 
     private:
+        using Job = std::function<void()>;
+        struct WorkerQueue;
+
         static std::mutex s_deferredCallsMutex, s_tasksFinishedMutex;
 
         static std::list<std::shared_ptr<Task>> s_tasks;
-        static std::list<std::shared_ptr<Task>> s_taskQueue;
         static std::list<std::function<void()>> s_deferredCalls;
         static std::list<std::function<void()>> s_tasksFinishedCallbacks;
 
+        // Every worker has its own queue. Jobs queued by a worker go into its own queue, all other jobs into the shared one.
+        // Idle workers steal jobs from the queues of other workers
+        static std::unique_ptr<WorkerQueue> s_sharedQueue;
+        static std::vector<std::unique_ptr<WorkerQueue>> s_workerQueues;
+        static std::atomic<size_t> s_queuedJobCount;
+
         static std::mutex s_queueMutex;
         static std::condition_variable s_jobCondVar;
         static std::vector<std::jthread> s_workers;
 
-        static void runner(const std::stop_token &stopToken);
+        static void runner(const std::stop_token &stopToken, size_t workerIndex);
+        static void runTask(const std::shared_ptr<Task> &task);
+
+        static void queueJob(Job job, TaskPriority priority);
+        static std::optional<Job> takeJob(size_t workerIndex);
+
+        friend class Task;
     };
 
 }
\ No newline at end of file
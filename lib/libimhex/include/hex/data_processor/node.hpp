@@ -4,7 +4,7 @@
 #include <hex/helpers/intrinsics.hpp>
 #include <hex/data_processor/attribute.hpp>
 
-#include <set>
+#include <optional>
 #include <span>
 #include <string_view>
 #include <vector>
@@ -44,6 +44,13 @@ namespace hex::dp {
         virtual void drawNode() { }
         virtual void process() = 0;
 
+        /**
+         * @brief Whether the node's output depends on more than its settings and inputs, e.g. on the provider's data
+         * Volatile nodes get processed in every evaluation. Nodes connected to their outputs only get processed again if the output changed
+         * @return True if the node is volatile
+         */
+        [[nodiscard]] virtual bool isVolatile() const { return false; }
+
         virtual void store(nlohmann::json &j) const { hex::unused(j); }
         virtual void load(const nlohmann::json &j) { hex::unused(j); }
 
@@ -57,10 +64,33 @@ namespace hex::dp {
                 attribute.clearOutputData();
         }
 
-        void resetProcessedInputs() {
-            this->m_processedInputs.clear();
+        /**
+         * @brief Processes the node unless its settings and the data on its inputs didn't change since it was last processed
+         * Nodes connected to the inputs get evaluated first. Every node is processed at most once per evaluation
+         */
+        void evaluate();
+
+        /**
+         * @brief Forces the node to be processed again in the next evaluation
+         */
+        void invalidate() {
+            this->m_cacheKey.reset();
         }
 
+        /**
+         * @brief Compiles a graph into an execution plan
+         * @param endNodes Nodes at the end of the graph
+         * @return All nodes the end nodes depend on, ordered so every node comes after the nodes connected to its inputs
+         */
+        static std::vector<Node *> createExecutionPlan(std::span<Node * const> endNodes);
+
+        /**
+         * @brief Evaluates all nodes of an execution plan in order
+         * May be called from within a node's process function to execute a nested graph
+         * @param plan Execution plan created by createExecutionPlan
+         */
+        static void execute(std::span<Node * const> plan);
+
         void setPosition(ImVec2 pos) {
             this->m_position = pos;
         }
@@ -86,11 +116,17 @@ namespace hex::dp {
         int m_id;
         std::string m_unlocalizedTitle, m_unlocalizedName;
         std::vector<Attribute> m_attributes;
-        std::set<u32> m_processedInputs;
         prv::Overlay *m_overlay = nullptr;
         ImVec2 m_position;
 
+        // Hash of the settings and input data the current outputs were computed from
+        std::optional<u64> m_cacheKey;
+        u64 m_evaluationId = 0;
+        bool m_evaluating = false;
+
         static int s_idCounter;
+        static u64 s_evaluationIdCounter;
+        static u64 s_currentEvaluationId;
 
         Attribute& getAttribute(u32 index) {
             if (index >= this->getAttributes().size())
@@ -108,12 +144,6 @@ namespace hex::dp {
             return connectedAttribute.begin()->second;
         }
 
-        void markInputProcessed(u32 index) {
-            const auto &[iter, inserted] = this->m_processedInputs.insert(index);
-            if (!inserted)
-                throwNodeError("Recursion detected!");
-        }
-
     protected:
         [[noreturn]] void throwNodeError(const std::string &message) {
             throw NodeError { this, message };
@@ -123,6 +153,7 @@ namespace hex::dp {
 
         void setAttributes(std::vector<Attribute> attributes) {
             this->m_attributes = std::move(attributes);
+            this->invalidate();
 
             for (auto &attr : this->m_attributes)
                 attr.setParentNode(this);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <vector>
+
+namespace hex {
+
+    class Task;
+
+    namespace prv {
+        class Provider;
+    }
+
+}
+
+namespace hex::diff {
+
+    enum class DifferenceType : u8 {
+        Added,      // Data only present in the first provider
+        Removed,    // Data only present in the second provider
+        Modified    // Data present in both providers but with different content
+    };
+
+    /**
+     * @brief Difference between two providers
+     * Both regions are addresses in their respective provider. Data that only exists in one of them is described by an empty
+     * region in the other one, located where the data would have to be inserted
+     */
+    struct Difference {
+        Region regionA, regionB;
+        DifferenceType type;
+
+        bool operator==(const Difference &) const = default;
+    };
+
+    /**
+     * @brief Content defined chunk of data
+     * Chunk boundaries only depend on the bytes right before them, so equal data results in equal chunks
+     * even if it's located at different addresses
+     */
+    struct Chunk {
+        u64 address;
+        u64 size;
+        u64 hash;
+    };
+
+    /**
+     * @brief Splits a region into content defined chunks using a rolling hash
+     * The region is split into large segments which are chunked in parallel
+     * @param task Task to run on. Its progress advances by the number of bytes processed
+     * @param provider Provider to read from
+     * @param region Region to split
+     * @return Chunks covering the whole region
+     */
+    std::vector<Chunk> splitIntoChunks(Task &task, prv::Provider *provider, Region region);
+
+    /**
+     * @brief Compares two regions, detecting data that got inserted or removed
+     * Both regions get split into content defined chunks. Chunks that appear exactly once in both regions are used as anchors
+     * to align the two regions, and equal chunks next to the anchors are aligned as well. Chunks only get aligned if their
+     * bytes are equal, not just their hashes. Only the data between the aligned
+     * chunks gets compared byte by byte, in parallel.
+     * @param task Task to run on
+     * @param providerA First provider
+     * @param regionA Region of the first provider to compare
+     * @param providerB Second provider
+     * @param regionB Region of the second provider to compare
+     * @return Differences ordered by their address in the first provider
+     */
+    std::vector<Difference> compare(Task &task, prv::Provider *providerA, Region regionA, prv::Provider *providerB, Region regionB);
+
+}
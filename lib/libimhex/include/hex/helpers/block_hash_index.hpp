@@ -0,0 +1,108 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace hex {
+
+    class Task;
+
+    namespace prv {
+        class Provider;
+    }
+
+    /**
+     * @brief Merkle tree of SHA-256 hashes over fixed size blocks of a provider's data
+     * Every block of the data gets hashed individually and pairs of hashes get combined level by level up to a single root hash.
+     * When the data gets modified, only the blocks overlapping the modification need to be hashed again, and comparing two
+     * indices only needs to descend into subtrees whose hashes differ to find the blocks that changed.
+     *
+     * All regions passed to and returned from the index are offsets into the data, not addresses.
+     */
+    class BlockHashIndex {
+    public:
+        using Hash = std::array<u8, 32>;
+
+        constexpr static u64 DefaultBlockSize = 0x1'0000;
+
+        explicit BlockHashIndex(u64 blockSize = DefaultBlockSize);
+
+        /**
+         * @brief Marks all blocks overlapping a region as out of date
+         * @param region Modified region of the data
+         */
+        void invalidate(Region region);
+
+        /**
+         * @brief Hashes all blocks that are out of date and updates the tree
+         * The index gets resized to the current size of the provider's data first.
+         * Blocks are hashed in parallel and the progress of the task advances by the number of bytes hashed
+         * @param task Task to run the hashing on
+         * @param provider Provider to read the data from
+         */
+        void update(Task &task, prv::Provider *provider);
+
+        /**
+         * @brief Changes the size of the indexed data. Blocks that got added or whose size changed are marked as out of date
+         * @param dataSize New size of the data
+         */
+        void resize(u64 dataSize);
+
+        /**
+         * @brief Gets the number of bytes that need to be hashed to bring the index up to date
+         * @return Number of bytes
+         */
+        [[nodiscard]] u64 getOutdatedSize() const;
+
+        /**
+         * @brief Finds the regions of the data that differ between two indices
+         * Subtrees with equal hashes are skipped entirely. Adjacent blocks are merged into a single region.
+         * Both indices need to use the same block size
+         * @param other Index to compare against
+         * @return Differing regions, clamped to the larger of the two data sizes
+         */
+        [[nodiscard]] std::vector<Region> getChangedRegions(const BlockHashIndex &other) const;
+
+        [[nodiscard]] u64 getBlockSize() const { return this->m_blockSize; }
+        [[nodiscard]] u64 getDataSize() const { return this->m_dataSize; }
+        [[nodiscard]] size_t getBlockCount() const { return this->getLeaves().size(); }
+        [[nodiscard]] bool isUpToDate() const { return this->m_outdatedBlocks.empty(); }
+
+        [[nodiscard]] const Hash &getBlockHash(size_t index) const { return this->getLeaves()[index]; }
+        [[nodiscard]] Hash getRootHash() const;
+
+        /**
+         * @brief Serializes the block hashes of an up to date index
+         * @return Serialized index
+         */
+        [[nodiscard]] std::vector<u8> serialize() const;
+
+        /**
+         * @brief Restores an index from its serialized form
+         * @param data Serialized index
+         * @return Index or std::nullopt if the data is invalid
+         */
+        static std::optional<BlockHashIndex> deserialize(std::span<const u8> data);
+
+    private:
+        [[nodiscard]] const std::vector<Hash> &getLeaves() const { return this->m_levels.front(); }
+
+        void updateParents(std::vector<size_t> changedIndices);
+
+    private:
+        u64 m_blockSize;
+        u64 m_dataSize = 0;
+
+        // m_levels[0] holds the hashes of all blocks, every following level the hashes of pairs of nodes of the previous level.
+        // A node without a sibling gets carried to the next level unchanged. The last level only contains the root
+        std::vector<std::vector<Hash>> m_levels = { { } };
+
+        // Sorted indices of all blocks that need to be hashed again
+        std::vector<size_t> m_outdatedBlocks;
+    };
+
+}
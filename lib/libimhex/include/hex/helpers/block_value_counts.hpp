@@ -0,0 +1,66 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace hex {
+
+    /**
+     * @brief Byte value counts of a region, kept separately for every fixed size block of it
+     * When parts of the region get modified, only the blocks touched by the modification need to be counted again.
+     * The counts of the whole region are then corrected using the difference between the old and new counts of those blocks
+     */
+    class BlockValueCounts {
+    public:
+        using Counts      = std::array<u64, 256>;
+        using BlockCounts = std::array<u32, 256>;
+
+        BlockValueCounts() = default;
+
+        /**
+         * @brief Creates counts for a region with all values set to zero
+         * @param region Region the counts are kept for
+         * @param blockSize Size of the blocks the region gets split into
+         */
+        BlockValueCounts(Region region, u64 blockSize);
+
+        /**
+         * @brief Replaces the counts of a single block
+         * Different blocks may not be set from multiple threads at the same time as they all correct the same totals
+         * @param address Start address of the block
+         * @param counts New byte value counts of the block
+         */
+        void setBlock(u64 address, const Counts &counts);
+
+        /**
+         * @brief Replaces the counts of all blocks, e.g. when loading previously stored results
+         * @param blocks Counts of every block
+         * @return False if the number of blocks doesn't match the region
+         */
+        bool setBlocks(std::vector<BlockCounts> blocks);
+
+        /**
+         * @brief Finds all blocks touched by a list of modifications
+         * @param modifications Modified regions in any order. Parts outside of the counted region are ignored
+         * @return Continuous ranges of modified blocks sorted by address
+         */
+        [[nodiscard]] std::vector<Region> getModifiedBlocks(std::span<const Region> modifications) const;
+
+        [[nodiscard]] const Counts &getTotals() const { return this->m_totals; }
+        [[nodiscard]] const std::vector<BlockCounts> &getBlocks() const { return this->m_blocks; }
+
+        [[nodiscard]] Region getRegion() const { return this->m_region; }
+        [[nodiscard]] u64 getBlockSize() const { return this->m_blockSize; }
+
+    private:
+        Region m_region = { 0, 0 };
+        u64 m_blockSize = 0;
+
+        std::vector<BlockCounts> m_blocks;
+        Counts m_totals = { };
+    };
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace hex {
+
+    /**
+     * @brief Sequence of bytes that can contain wildcards, searched for using the fastest vector instructions the CPU supports
+     * Every byte of the pattern is compared under its own mask so exact sequences, wildcard bytes and wildcard nibbles
+     * can all be searched for using the same matcher
+     */
+    class BytePattern {
+    public:
+        struct Byte {
+            u8 mask, value;
+        };
+
+        enum class Implementation {
+            Scalar,
+            SSE2,
+            AVX2
+        };
+
+        BytePattern() = default;
+
+        /**
+         * @brief Creates a pattern that matches an exact sequence of bytes
+         * @param sequence Bytes to match
+         */
+        explicit BytePattern(std::span<const u8> sequence);
+
+        /**
+         * @brief Creates a pattern that matches every byte under a mask
+         * @param bytes Mask and value pairs. A byte matches if (byte & mask) == value
+         */
+        explicit BytePattern(std::span<const Byte> bytes);
+
+        /**
+         * @brief Searches for the first occurrence of the pattern that fully lies inside the data
+         * @param data Data to search
+         * @param offset Offset to start searching at
+         * @return Offset of the occurrence or std::nullopt if there is none
+         */
+        [[nodiscard]] std::optional<size_t> find(std::span<const u8> data, size_t offset = 0) const;
+        [[nodiscard]] std::optional<size_t> find(Implementation implementation, std::span<const u8> data, size_t offset = 0) const;
+
+        /**
+         * @brief Searches for the last occurrence of the pattern that fully lies inside the data
+         * @param data Data to search
+         * @return Offset of the occurrence or std::nullopt if there is none
+         */
+        [[nodiscard]] std::optional<size_t> findLast(std::span<const u8> data) const;
+
+        [[nodiscard]] size_t size() const { return this->m_size; }
+        [[nodiscard]] bool empty() const { return this->m_size == 0; }
+
+        [[nodiscard]] static bool isSupported(Implementation implementation);
+        [[nodiscard]] static Implementation getBestImplementation();
+
+    private:
+        [[nodiscard]] bool matchesAt(const u8 *data) const;
+
+        [[nodiscard]] std::optional<size_t> findScalar(std::span<const u8> data, size_t offset) const;
+        [[nodiscard]] std::optional<size_t> findSSE2(std::span<const u8> data, size_t offset) const;
+        [[nodiscard]] std::optional<size_t> findAVX2(std::span<const u8> data, size_t offset) const;
+
+    private:
+        std::vector<u8> m_masks, m_values;
+        size_t m_size = 0;
+
+        // Candidates get filtered on the first and last byte of the pattern that isn't a complete wildcard
+        size_t m_firstAnchor = 0, m_lastAnchor = 0;
+        bool m_matchesEverything = true;
+    };
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <bitset>
+#include <expected>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hex {
+
+    /**
+     * @brief Regular expression that operates on raw bytes instead of text
+     * Patterns get compiled into an NFA once. While searching, that NFA gets turned into a DFA step by step so every byte of the data
+     * is only looked at once, no matter how complex the pattern is.
+     *
+     * Supported syntax:
+     *  - Literal characters and escapes: \xHH, \n, \r, \t, \f, \v, \0 and escaped symbols like \. or \(
+     *  - Character classes: [abc], [^a-z], \d, \D, \w, \W, \s, \S and '.' which matches any byte
+     *  - Groups: (...) and (?:...)
+     *  - Alternation: a|b
+     *  - Greedy quantifiers: *, +, ?, {n}, {n,} and {n,m}
+     *
+     * Matches are leftmost-longest, never overlap and are never empty
+     */
+    class ByteRegex {
+    public:
+        struct Instruction {
+            enum class Type : u8 {
+                Bytes,
+                Split,
+                Jump,
+                Match
+            } type = Type::Bytes;
+
+            u32 first = 0, second = 0;
+            std::bitset<256> bytes = { };
+        };
+
+        /**
+         * @brief Layout of the characters matched by the pattern
+         * In the UTF-16 encodings every character of the pattern matches a 16 bit code unit. '.' matches any code unit,
+         * all other characters and classes only match code units below 0x100
+         */
+        enum class Encoding : u8 {
+            Bytes,
+            UTF16LE,
+            UTF16BE
+        };
+
+        constexpr static size_t MaxProgramSize = 0x1'0000;
+
+        /**
+         * @brief Compiles a pattern
+         * @param pattern Pattern to compile
+         * @param encoding Layout of the characters the pattern should match
+         * @return Compiled regex or a description of what's wrong with the pattern
+         */
+        static std::expected<ByteRegex, std::string> compile(std::string_view pattern, Encoding encoding = Encoding::Bytes);
+
+        [[nodiscard]] const std::vector<Instruction> &getProgram() const { return this->m_program; }
+        [[nodiscard]] u32 getStart() const { return this->m_start; }
+
+        /**
+         * @brief Searches a stream of data for matches of a regex
+         * The data can be fed in pieces of any size, matches crossing the boundaries between them are found as well
+         */
+        class Matcher {
+        public:
+            using Callback = std::function<void(Region match)>;
+
+            /**
+             * @brief Creates a new matcher
+             * @param regex Regex to search for. Has to outlive the matcher
+             * @param address Address of the first byte that will be fed to the matcher
+             * @param callback Function called for every match in ascending order
+             */
+            Matcher(const ByteRegex &regex, u64 address, Callback callback);
+
+            void feed(std::span<const u8> data);
+
+            /**
+             * @brief Reports all matches that were still waiting to be extended. Has to be called after the last piece of data got fed
+             */
+            void finish();
+
+        private:
+            struct State {
+                // Program counters of all running threads, ordered by the address they started at
+                std::vector<u32> threads = { };
+                bool acceptsNewThreads = false;
+
+                // Index of the first thread that reached a match or -1
+                i32 firstMatch = -1;
+
+                // Index into m_transitions for every possible next byte or -1 if that transition wasn't needed yet
+                std::array<i32, 256> transitions = { };
+            };
+
+            struct Transition {
+                u32 target = 0;
+
+                // Index of the thread every thread of the target state continues or -1 for threads starting at the next byte
+                std::vector<i32> sources = { };
+            };
+
+            constexpr static size_t MaxCachedStates = 0x1000;
+
+            u32 getState(std::vector<u32> threads, bool acceptsNewThreads);
+            const Transition &getTransition(u8 byte);
+            void addThread(std::vector<u32> &threads, u32 pc, bool allowMatch);
+            void clearCache();
+
+            void restart(u64 address);
+            bool consume(u8 byte);
+            size_t run(std::span<const u8> data);
+            void reportCandidate();
+
+        private:
+            const ByteRegex &m_regex;
+            Callback m_callback;
+
+            std::vector<State> m_states;
+            std::vector<Transition> m_transitions;
+            std::map<std::pair<bool, std::vector<u32>>, u32> m_stateLookup;
+            std::vector<u32> m_visited;
+            u32 m_visitGeneration = 0;
+
+            u32 m_initialState = 0, m_currState = 0;
+            u64 m_address = 0;
+            std::vector<u64> m_starts, m_nextStarts;
+
+            std::optional<Region> m_candidate;
+            std::vector<u8> m_pending, m_rescan;
+        };
+
+    private:
+        std::vector<Instruction> m_program;
+        u32 m_start = 0;
+    };
+
+}
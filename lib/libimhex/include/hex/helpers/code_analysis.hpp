@@ -0,0 +1,134 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/helpers/disassembler.hpp>
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace hex {
+
+    class Task;
+
+    namespace prv {
+        class Provider;
+    }
+
+    /**
+     * @brief Result of a recursive descent disassembly
+     * Starting at a set of entry points, control flow is followed through all direct jumps and calls. Every call target is
+     * analyzed as a function of its own, and functions discovered in the same round get analyzed in parallel.
+     * The decoded instructions are grouped into basic blocks and every branch, call and data reference is stored in a
+     * cross reference table sorted by the referenced address, so finding all references to an address is a binary search.
+     *
+     * All addresses are addresses in the disassembled code's address space, i.e. the base address the code is loaded at.
+     */
+    class CodeAnalysis {
+    public:
+        enum class FlowType : u8 {
+            Normal,             // Execution continues with the next instruction
+            Call,               // Execution continues with the next instruction once the call target returns
+            Jump,               // Execution continues at the branch target only
+            ConditionalJump,    // Execution continues at the branch target or with the next instruction
+            Return              // Execution doesn't continue in this function
+        };
+
+        struct Instruction {
+            u64 address;
+            u8 size;
+            FlowType flow;
+
+            // Direct target of calls and jumps. Indirect branches don't have one
+            std::optional<u64> branchTarget;
+
+            // Addresses of data the instruction accesses
+            std::vector<u64> dataReferences;
+        };
+
+        /**
+         * @brief Function decoding the instruction at an address
+         * Returns std::nullopt if the address is outside of the code or no valid instruction is located there
+         */
+        using Decoder = std::function<std::optional<Instruction>(u64 address)>;
+
+        enum class ReferenceType : u8 {
+            Call,
+            Jump,
+            ConditionalJump,
+            FallThrough,
+            Data
+        };
+
+        struct Reference {
+            u64 from;
+            u64 to;
+            ReferenceType type;
+
+            bool operator==(const Reference &) const = default;
+        };
+
+        struct BasicBlock {
+            u64 address;
+            u64 size;
+            u32 instructionCount;
+        };
+
+        /**
+         * @brief Analyzes code starting at the given entry points
+         * @param task Task to run the analysis on
+         * @param createDecoder Function creating a new decoder. Every worker thread creates its own one
+         * @param entryPoints Addresses to start the analysis at. Each one is treated as a function
+         * @return Analysis result
+         */
+        static CodeAnalysis analyze(Task &task, const std::function<Decoder()> &createDecoder, const std::vector<u64> &entryPoints);
+
+        /**
+         * @brief Creates a decoder for code stored in a provider using capstone
+         * @param architecture Architecture of the code
+         * @param mode Capstone mode to use
+         * @param provider Provider containing the code
+         * @param codeRegion Region of the provider containing the code
+         * @param baseAddress Address the code is loaded at
+         * @return Decoder
+         */
+        static Decoder createCapstoneDecoder(Architecture architecture, cs_mode mode, prv::Provider *provider, Region codeRegion, u64 baseAddress);
+
+        /**
+         * @brief Finds all references to an address
+         * @param address Referenced address
+         * @return References sorted by the address they originate from
+         */
+        [[nodiscard]] std::span<const Reference> getReferencesTo(u64 address) const;
+
+        /**
+         * @brief Finds the basic block containing an address
+         * @param address Address to search
+         * @return Basic block or nullptr if the address isn't part of any analyzed code
+         */
+        [[nodiscard]] const BasicBlock *findBasicBlock(u64 address) const;
+
+        /**
+         * @brief Finds all basic blocks overlapping a region
+         * @param region Region to search
+         * @return Basic blocks sorted by address
+         */
+        [[nodiscard]] std::span<const BasicBlock> getBasicBlocks(Region region) const;
+
+        [[nodiscard]] const std::vector<u64> &getFunctions() const { return this->m_functions; }
+        [[nodiscard]] const std::vector<BasicBlock> &getBasicBlocks() const { return this->m_basicBlocks; }
+        [[nodiscard]] const std::vector<Reference> &getReferences() const { return this->m_references; }
+
+    private:
+        // Addresses of all functions that could be decoded, sorted
+        std::vector<u64> m_functions;
+
+        // Basic blocks sorted by address
+        std::vector<BasicBlock> m_basicBlocks;
+
+        // References sorted by the referenced address first and the referencing address second
+        std::vector<Reference> m_references;
+    };
+
+}
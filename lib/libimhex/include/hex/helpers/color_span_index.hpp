@@ -0,0 +1,49 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <span>
+#include <vector>
+
+namespace hex {
+
+    /**
+     * @brief Index of colored, possibly overlapping regions flattened into disjoint spans
+     * Where regions overlap, their colors get alpha blended in the order the regions were given in. Finding the colors
+     * of a region is a binary search followed by a scan over the spans inside of it.
+     */
+    class ColorSpanIndex {
+    public:
+        struct Span {
+            Region region;
+            color_t color;
+
+            bool operator==(const Span &) const = default;
+        };
+
+        ColorSpanIndex() = default;
+
+        /**
+         * @brief Builds the index
+         * @param highlights Colored regions. Later regions get blended on top of earlier ones where they overlap
+         */
+        explicit ColorSpanIndex(std::vector<Span> highlights);
+
+        /**
+         * @brief Finds all spans overlapping a region
+         * @param region Region to search
+         * @return Spans sorted by address
+         */
+        [[nodiscard]] std::span<const Span> find(const Region &region) const;
+
+        [[nodiscard]] const std::vector<Span> &getSpans() const { return this->m_spans; }
+        [[nodiscard]] bool empty() const { return this->m_spans.empty(); }
+
+    private:
+        void append(u64 address, u64 size, color_t color);
+
+        // Disjoint spans sorted by address
+        std::vector<Span> m_spans;
+    };
+
+}
@@ -3,7 +3,9 @@
 #include <hex.hpp>
 
 #include <array>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -27,6 +29,33 @@ namespace hex::crypt {
     std::array<u8, 48> sha384(prv::Provider *&data, u64 offset, size_t size);
     std::array<u8, 64> sha512(prv::Provider *&data, u64 offset, size_t size);
 
+    /**
+     * @brief Hash or checksum that gets calculated from data fed to it piece by piece
+     */
+    class Hasher {
+    public:
+        virtual ~Hasher() = default;
+
+        virtual void update(std::span<const u8> data) = 0;
+
+        /**
+         * @brief Finishes the calculation. The hasher can't be used anymore afterwards
+         * @return Hash of all data passed to update()
+         */
+        [[nodiscard]] virtual std::vector<u8> finish() = 0;
+    };
+
+    std::unique_ptr<Hasher> crc8Hasher(u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut);
+    std::unique_ptr<Hasher> crc16Hasher(u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut);
+    std::unique_ptr<Hasher> crc32Hasher(u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut);
+
+    std::unique_ptr<Hasher> md5Hasher();
+    std::unique_ptr<Hasher> sha1Hasher();
+    std::unique_ptr<Hasher> sha224Hasher();
+    std::unique_ptr<Hasher> sha256Hasher();
+    std::unique_ptr<Hasher> sha384Hasher();
+    std::unique_ptr<Hasher> sha512Hasher();
+
     std::array<u8, 16> md5(const std::vector<u8> &data);
     std::array<u8, 20> sha1(const std::vector<u8> &data);
     std::array<u8, 28> sha224(const std::vector<u8> &data);
@@ -2,7 +2,8 @@
 
 #include <hex.hpp>
 
-#include <map>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <vector>
 #include <span>
@@ -23,8 +24,8 @@ namespace hex {
         EncodingFile() = default;
         EncodingFile(Type type, const std::fs::path &path);
 
-        [[nodiscard]] std::pair<std::string_view, size_t> getEncodingFor(std::span<u8> buffer) const;
-        [[nodiscard]] size_t getEncodingLengthFor(std::span<u8> buffer) const;
+        [[nodiscard]] std::pair<std::string_view, size_t> getEncodingFor(std::span<const u8> buffer) const;
+        [[nodiscard]] size_t getEncodingLengthFor(std::span<const u8> buffer) const;
         [[nodiscard]] size_t getLongestSequence() const { return this->m_longestSequence; }
 
         [[nodiscard]] bool valid() const { return this->m_valid; }
@@ -32,9 +33,29 @@ namespace hex {
     private:
         void parseThingyFile(wolv::io::File &file);
 
+        /**
+         * @brief Finds the longest byte sequence with a mapping at the start of a buffer
+         * @param buffer Buffer to decode
+         * @return Index of the sequence's string and the length of the sequence, or std::nullopt if no sequence matches
+         */
+        [[nodiscard]] std::optional<std::pair<u32, size_t>> findLongestMatch(std::span<const u8> buffer) const;
+
         bool m_valid = false;
 
-        std::map<size_t, std::map<std::vector<u8>, std::string>> m_mapping;
+        // All byte sequences are stored in a trie. The edges to a node's children are stored next to each other, sorted by their byte
+        struct TrieNode {
+            u32 edgesBegin = 0, edgesEnd = 0;
+            std::optional<u32> value;
+        };
+
+        struct TrieEdge {
+            u8 byte;
+            u32 node;
+        };
+
+        std::vector<TrieNode> m_nodes;
+        std::vector<TrieEdge> m_edges;
+        std::vector<std::string> m_values;
         size_t m_longestSequence = 0;
     };
 
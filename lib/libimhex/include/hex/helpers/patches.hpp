@@ -3,12 +3,96 @@
 #include <hex.hpp>
 
 #include <map>
+#include <optional>
 #include <vector>
 #include <expected>
 
 namespace hex {
 
-    using Patches = std::map<u64, u8>;
+    /**
+     * @brief Sparse storage for modified bytes
+     * Contiguous modified bytes are stored as a single extent (start address + byte buffer) so that the
+     * memory usage and lookup cost scale with the number of modified runs instead of the number of modified bytes.
+     * Extents never overlap and are never directly adjacent to each other, adjacent writes get merged.
+     */
+    class Patches {
+    public:
+        using Extents = std::map<u64, std::vector<u8>>;
+
+        Patches() = default;
+
+        /**
+         * @brief Sets a range of patched bytes, merging it with any overlapping or adjacent extents
+         * @param address Address of the first byte
+         * @param buffer Patched bytes
+         * @param size Number of bytes
+         */
+        void set(u64 address, const void *buffer, size_t size);
+        void set(u64 address, u8 value) { this->set(address, &value, sizeof(u8)); }
+
+        /**
+         * @brief Removes all patched bytes in a range, splitting extents that only partially overlap it
+         * @param address Address of the first byte
+         * @param size Number of bytes
+         */
+        void erase(u64 address, size_t size = 1);
+        void clear();
+
+        /**
+         * @brief Moves all patched bytes at or after an address forward to make space for newly inserted bytes
+         * @param address Address the bytes got inserted at
+         * @param size Number of inserted bytes
+         */
+        void insert(u64 address, size_t size);
+
+        /**
+         * @brief Removes all patched bytes in a range and moves all patches after it backwards
+         * @param address Address of the first removed byte
+         * @param size Number of removed bytes
+         */
+        void remove(u64 address, size_t size);
+
+        /**
+         * @brief Copies all patched bytes that overlap a range into a buffer
+         * @param address Address of the first byte in the buffer
+         * @param buffer Buffer to overlay the patches onto
+         * @param size Size of the buffer
+         */
+        void apply(u64 address, void *buffer, size_t size) const;
+
+        /**
+         * @brief Creates a copy of all patched bytes inside a range
+         * @param address Address of the first byte
+         * @param size Number of bytes
+         * @return Patches containing only the bytes inside the range
+         */
+        [[nodiscard]] Patches slice(u64 address, size_t size) const;
+
+        [[nodiscard]] std::optional<u8> get(u64 address) const;
+        [[nodiscard]] bool contains(u64 address) const;
+        [[nodiscard]] bool overlaps(u64 address, size_t size) const;
+
+        [[nodiscard]] const Extents &getExtents() const { return this->m_extents; }
+        [[nodiscard]] size_t getExtentCount() const { return this->m_extents.size(); }
+
+        /**
+         * @brief Returns the total number of patched bytes
+         */
+        [[nodiscard]] size_t size() const { return this->m_byteCount; }
+        [[nodiscard]] bool empty() const { return this->m_extents.empty(); }
+
+        [[nodiscard]] auto begin() const { return this->m_extents.begin(); }
+        [[nodiscard]] auto end() const { return this->m_extents.end(); }
+
+        [[nodiscard]] bool operator==(const Patches &other) const = default;
+
+    private:
+        void mergeWithNext(Extents::iterator iter);
+
+    private:
+        Extents m_extents;
+        size_t m_byteCount = 0;
+    };
 
     enum class IPSError {
         AddressOutOfRange,
@@ -23,4 +107,4 @@ namespace hex {
 
     std::expected<Patches, IPSError> loadIPSPatch(const std::vector<u8> &ipsPatch);
     std::expected<Patches, IPSError> loadIPS32Patch(const std::vector<u8> &ipsPatch);
-}
\ No newline at end of file
+}
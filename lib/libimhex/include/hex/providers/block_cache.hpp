@@ -0,0 +1,97 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace hex::prv {
+
+    /**
+     * @brief Thread-safe least recently used cache of fixed size, block aligned chunks of a provider's data
+     * Meant to sit in front of backends that are slow to access, like disks, network connections or debuggers,
+     * so that repeated reads of the same area don't have to go through the backend every time
+     */
+    class BlockCache {
+    public:
+        /**
+         * @brief Function used to fetch data from the backend
+         * Always gets called with a block aligned offset and a size that's a multiple of the block size
+         */
+        using ReadFunction = std::function<void(u64 offset, u8 *buffer, size_t size)>;
+
+        /**
+         * @brief Creates a new block cache
+         * @param readFunction Function used to fetch data from the backend
+         * @param blockSize Size of a single block in bytes
+         * @param blockCount Maximum number of blocks kept in the cache
+         * @param readAheadBlockCount Number of additional blocks fetched after a miss if the data is being accessed sequentially
+         */
+        BlockCache(ReadFunction readFunction, size_t blockSize, size_t blockCount, size_t readAheadBlockCount = 0);
+
+        /**
+         * @brief Reads data through the cache, fetching all blocks that aren't cached yet from the backend
+         * The backend is only ever accessed by one thread at a time
+         * @param offset Offset of the first byte
+         * @param buffer Buffer to read the data into
+         * @param size Number of bytes to read
+         */
+        void read(u64 offset, void *buffer, size_t size);
+
+        /**
+         * @brief Removes all blocks that overlap a range from the cache. Has to be called whenever the underlying data changes
+         * @param offset Offset of the first modified byte
+         * @param size Number of modified bytes
+         */
+        void invalidate(u64 offset, size_t size);
+        void invalidateAll();
+
+        /**
+         * @brief Sets how long a block may be served from the cache before it has to be fetched again.
+         * Useful for data that can change without the provider knowing about it, like the memory of a running process
+         * @param maxAge Maximum age of a block or std::nullopt to keep blocks until they get evicted or invalidated
+         */
+        void setMaxBlockAge(std::optional<std::chrono::milliseconds> maxAge);
+
+        [[nodiscard]] size_t getBlockSize() const { return this->m_blockSize; }
+        [[nodiscard]] size_t getBlockCount() const { return this->m_blockCount; }
+        [[nodiscard]] size_t getCachedBlockCount() const;
+
+        [[nodiscard]] u64 getHitCount() const { return this->m_hitCount; }
+        [[nodiscard]] u64 getMissCount() const { return this->m_missCount; }
+        void resetCounters();
+
+    private:
+        struct Block {
+            u64 address;
+            std::vector<u8> data;
+            std::chrono::steady_clock::time_point fetchTime;
+        };
+
+        using BlockList = std::list<Block>;
+
+        BlockList::iterator findBlock(u64 address);
+        void insertBlock(u64 address, const u8 *data);
+
+    private:
+        ReadFunction m_readFunction;
+        size_t m_blockSize, m_blockCount, m_readAheadBlockCount;
+        std::optional<std::chrono::milliseconds> m_maxBlockAge;
+
+        // Most recently used block at the front
+        BlockList m_blocks;
+        std::unordered_map<u64, BlockList::iterator> m_blockLookup;
+
+        u64 m_sequentialAddress = 0;
+
+        mutable std::mutex m_mutex;
+        std::atomic<u64> m_hitCount = 0, m_missCount = 0;
+    };
+
+}
@@ -4,18 +4,36 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 #include <hex/api/imhex_api.hpp>
 #include <hex/providers/overlay.hpp>
 #include <hex/helpers/fs.hpp>
+#include <hex/helpers/patches.hpp>
+#include <hex/providers/block_cache.hpp>
+#include <hex/providers/undo_stack.hpp>
 
 #include <nlohmann/json.hpp>
 
 namespace hex::prv {
 
+    /**
+     * @brief View of a provider's data returned by Provider::getDataView
+     * Holds a reference to the memory backing the view so it cannot be released while the view is still in use
+     */
+    class DataView : public std::span<const u8> {
+    public:
+        DataView() = default;
+        DataView(std::span<const u8> data, std::shared_ptr<const void> owner = nullptr) : std::span<const u8>(data), m_owner(std::move(owner)) { }
+
+    private:
+        std::shared_ptr<const void> m_owner;
+    };
+
     class Provider {
     public:
         constexpr static size_t PageSize = 0x1000'0000;
@@ -43,10 +61,21 @@ namespace hex::prv {
         virtual void writeRaw(u64 offset, const void *buffer, size_t size) = 0;
         [[nodiscard]] virtual size_t getActualSize() const                 = 0;
 
+        /**
+         * @brief Gets direct access to the provider's data without copying it
+         * The returned view contains the same bytes read() would return. Its memory stays alive for as long as the view exists,
+         * even if the provider gets resized or closed in the meantime, but its contents are undefined after the data got modified
+         * @param offset Address of the first byte
+         * @param size Number of bytes
+         * @return View of the data or std::nullopt if the data is not directly addressable, e.g. because patches or overlays lie on top of it
+         */
+        [[nodiscard]] virtual std::optional<DataView> getDataView(u64 offset, size_t size);
+
         void applyOverlays(u64 offset, void *buffer, size_t size);
+        [[nodiscard]] bool hasModifications(u64 offset, size_t size) const;
 
-        [[nodiscard]] std::map<u64, u8> &getPatches();
-        [[nodiscard]] const std::map<u64, u8> &getPatches() const;
+        [[nodiscard]] Patches &getPatches();
+        [[nodiscard]] const Patches &getPatches() const;
         void applyPatches();
 
         [[nodiscard]] Overlay *newOverlay();
@@ -106,13 +135,41 @@ namespace hex::prv {
         void setErrorMessage(const std::string &errorMessage) { this->m_errorMessage = errorMessage; }
         [[nodiscard]] const std::string& getErrorMessage() const { return this->m_errorMessage; }
 
+        /**
+         * @brief Gets the block cache of this provider
+         * @return Block cache or nullptr if the provider doesn't use one
+         */
+        [[nodiscard]] const BlockCache *getBlockCache() const { return this->m_blockCache.get(); }
+
+    protected:
+        /**
+         * @brief Puts a block cache in front of readRaw(). Only worth it for providers whose backend is slow to access
+         * The cache gets invalidated automatically by write(), resize(), insert(), remove() and applyPatches().
+         * Providers that change their data in any other way need to call invalidateBlockCache() themselves
+         * @param blockSize Size of a single block in bytes
+         * @param blockCount Maximum number of blocks kept in the cache
+         * @param readAheadBlockCount Number of additional blocks fetched on sequential access
+         * @return The newly created block cache
+         */
+        BlockCache &enableBlockCache(size_t blockSize, size_t blockCount, size_t readAheadBlockCount = 0);
+        void disableBlockCache();
+
+        /**
+         * @brief Reads data through the block cache if one is enabled, otherwise directly through readRaw()
+         */
+        void readRawCached(u64 offset, void *buffer, size_t size);
+
+        void invalidateBlockCache(u64 offset, size_t size);
+        void invalidateBlockCache();
+
     protected:
         u32 m_currPage    = 0;
         u64 m_baseAddress = 0;
 
-        u32 m_patchTreeOffset = 0;
-        std::list<std::map<u64, u8>> m_patches;
+        Patches m_patches;
+        UndoStack m_undoStack;
         std::list<Overlay *> m_overlays;
+        std::unique_ptr<BlockCache> m_blockCache;
 
         u32 m_id;
 
@@ -122,6 +179,9 @@ namespace hex::prv {
         std::string m_errorMessage;
 
     private:
+        // Region from the given address up to the end of the data
+        [[nodiscard]] Region getRegionFrom(u64 address) const;
+
         static u32 s_idCounter;
     };
 
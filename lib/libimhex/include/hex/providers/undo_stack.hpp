@@ -0,0 +1,94 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/patches.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace hex::prv {
+
+    /**
+     * @brief Journal of all modifications made to the patches of a provider
+     * Every undo step only stores the state of the patches inside the region it modified, once from before and once from after the modification.
+     * Undoing or redoing a step therefore only costs time proportional to the size of that modification instead of the total number of patches.
+     */
+    class UndoStack {
+    public:
+        struct Operation {
+            Region region = Region::Invalid();
+            Patches before, after;
+
+            bool mergeable = false;
+            std::chrono::steady_clock::time_point lastModified;
+
+            [[nodiscard]] size_t getMemoryUsage() const;
+        };
+
+        constexpr static auto MergeTimeout  = std::chrono::seconds(1);
+        constexpr static auto MaxMergedSize = 0x1000;
+
+        /**
+         * @brief Has to be called right before a region of the patches gets modified
+         * @param patches Patches that are about to be modified
+         * @param region Region that is about to be modified
+         * @param standalone If true, the modification forms its own undo step. Directly adjacent standalone modifications made
+         * in quick succession, like typing multiple bytes in a row, get merged into a single step.
+         * If false, the modification gets collected into one undo step together with all other such modifications until commit() is called
+         */
+        void prepare(const Patches &patches, Region region, bool standalone);
+
+        /**
+         * @brief Finishes the currently open undo step
+         * @param patches Patches after the modification
+         */
+        void commit(const Patches &patches);
+
+        /**
+         * @brief Reverts the most recent undo step
+         * @param patches Patches to revert the step on
+         * @return Region that got modified or std::nullopt if there was nothing to undo
+         */
+        std::optional<Region> undo(Patches &patches);
+
+        /**
+         * @brief Reapplies the most recently undone step
+         * @param patches Patches to reapply the step on
+         * @return Region that got modified or std::nullopt if there was nothing to redo
+         */
+        std::optional<Region> redo(Patches &patches);
+
+        [[nodiscard]] bool canUndo() const;
+        [[nodiscard]] bool canRedo() const;
+
+        void clear();
+
+        [[nodiscard]] size_t getMemoryUsage() const;
+
+        /**
+         * @brief Sets the maximum amount of memory the undo history of every provider may use.
+         * The oldest undo steps get discarded once this limit is exceeded
+         * @param limit Memory limit in bytes
+         */
+        static void setMemoryLimit(size_t limit);
+        [[nodiscard]] static size_t getMemoryLimit();
+
+    private:
+        void clearRedoOperations();
+        void enforceMemoryLimit();
+
+    private:
+        std::deque<Operation> m_undoOperations;
+        std::vector<Operation> m_redoOperations;
+        std::optional<Operation> m_pendingOperation;
+
+        size_t m_memoryUsage = 0;
+
+        static std::atomic<size_t> s_memoryLimit;
+    };
+
+}
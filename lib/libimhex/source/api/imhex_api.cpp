@@ -8,6 +8,7 @@
 #include <unistd.h>
 
 #include <imgui.h>
+#include <IntervalTree.h>
 
 #include <nlohmann/json.hpp>
 
@@ -32,6 +33,10 @@ namespace hex {
 
         namespace impl {
 
+            // Interval trees mapping the static highlightings to their IDs. They get rebuilt lazily after highlightings were added or removed
+            using HighlightingTree = interval_tree::IntervalTree<u64, u32>;
+            static std::optional<HighlightingTree> s_backgroundHighlightTree, s_foregroundHighlightTree;
+
             static std::map<u32, Highlighting> s_backgroundHighlights;
             std::map<u32, Highlighting> &getBackgroundHighlights() {
                 return s_backgroundHighlights;
@@ -42,6 +47,11 @@ namespace hex {
                 return s_backgroundHighlightingFunctions;
             }
 
+            static std::map<u32, HighlightingRegionFunction> s_backgroundHighlightingRegionFunctions;
+            std::map<u32, HighlightingRegionFunction> &getBackgroundHighlightingRegionFunctions() {
+                return s_backgroundHighlightingRegionFunctions;
+            }
+
             static std::map<u32, Highlighting> s_foregroundHighlights;
             std::map<u32, Highlighting> &getForegroundHighlights() {
                 return s_foregroundHighlights;
@@ -52,6 +62,45 @@ namespace hex {
                 return s_foregroundHighlightingFunctions;
             }
 
+            static std::map<u32, HighlightingRegionFunction> s_foregroundHighlightingRegionFunctions;
+            std::map<u32, HighlightingRegionFunction> &getForegroundHighlightingRegionFunctions() {
+                return s_foregroundHighlightingRegionFunctions;
+            }
+
+            static std::vector<Highlighting> findHighlights(const std::map<u32, Highlighting> &highlights, std::optional<HighlightingTree> &tree, const Region &region) {
+                if (region.getSize() == 0)
+                    return { };
+
+                if (!tree.has_value()) {
+                    HighlightingTree::interval_vector intervals;
+                    for (const auto &[id, highlighting] : highlights) {
+                        if (highlighting.getRegion().getSize() != 0)
+                            intervals.emplace_back(highlighting.getRegion().getStartAddress(), highlighting.getRegion().getEndAddress(), id);
+                    }
+
+                    tree = HighlightingTree(std::move(intervals));
+                }
+
+                auto overlapping = tree->findOverlapping(region.getStartAddress(), region.getEndAddress());
+                std::sort(overlapping.begin(), overlapping.end(), [](const auto &left, const auto &right) { return left.value < right.value; });
+
+                std::vector<Highlighting> result;
+                for (const auto &interval : overlapping) {
+                    if (auto it = highlights.find(interval.value); it != highlights.end())
+                        result.push_back(it->second);
+                }
+
+                return result;
+            }
+
+            std::vector<Highlighting> findBackgroundHighlights(const Region &region) {
+                return findHighlights(s_backgroundHighlights, s_backgroundHighlightTree, region);
+            }
+
+            std::vector<Highlighting> findForegroundHighlights(const Region &region) {
+                return findHighlights(s_foregroundHighlights, s_foregroundHighlightTree, region);
+            }
+
             static std::map<u32, Tooltip> s_tooltips;
             std::map<u32, Tooltip> &getTooltips() {
                 return s_tooltips;
@@ -77,6 +126,7 @@ namespace hex {
             impl::getBackgroundHighlights().insert({
                 id, Highlighting {region, color}
             });
+            impl::s_backgroundHighlightTree.reset();
 
             EventManager::post<EventHighlightingChanged>();
 
@@ -85,6 +135,7 @@ namespace hex {
 
         void removeBackgroundHighlight(u32 id) {
             impl::getBackgroundHighlights().erase(id);
+            impl::s_backgroundHighlightTree.reset();
 
             EventManager::post<EventHighlightingChanged>();
         }
@@ -107,6 +158,24 @@ namespace hex {
             EventManager::post<EventHighlightingChanged>();
         }
 
+        u32 addBackgroundHighlightingRegionProvider(const impl::HighlightingRegionFunction &function) {
+            static u32 id = 0;
+
+            id++;
+
+            impl::getBackgroundHighlightingRegionFunctions().insert({ id, function });
+
+            EventManager::post<EventHighlightingChanged>();
+
+            return id;
+        }
+
+        void removeBackgroundHighlightingRegionProvider(u32 id) {
+            impl::getBackgroundHighlightingRegionFunctions().erase(id);
+
+            EventManager::post<EventHighlightingChanged>();
+        }
+
         u32 addForegroundHighlight(const Region &region, color_t color) {
             static u32 id = 0;
 
@@ -115,6 +184,7 @@ namespace hex {
             impl::getForegroundHighlights().insert({
                 id, Highlighting {region, color}
             });
+            impl::s_foregroundHighlightTree.reset();
 
             EventManager::post<EventHighlightingChanged>();
 
@@ -123,6 +193,7 @@ namespace hex {
 
         void removeForegroundHighlight(u32 id) {
             impl::getForegroundHighlights().erase(id);
+            impl::s_foregroundHighlightTree.reset();
 
             EventManager::post<EventHighlightingChanged>();
         }
@@ -145,6 +216,24 @@ namespace hex {
             EventManager::post<EventHighlightingChanged>();
         }
 
+        u32 addForegroundHighlightingRegionProvider(const impl::HighlightingRegionFunction &function) {
+            static u32 id = 0;
+
+            id++;
+
+            impl::getForegroundHighlightingRegionFunctions().insert({ id, function });
+
+            EventManager::post<EventHighlightingChanged>();
+
+            return id;
+        }
+
+        void removeForegroundHighlightingRegionProvider(u32 id) {
+            impl::getForegroundHighlightingRegionFunctions().erase(id);
+
+            EventManager::post<EventHighlightingChanged>();
+        }
+
         static u32 tooltipId = 0;
         u32 addTooltip(Region region, std::string value, color_t color) {
             tooltipId++;
@@ -4,22 +4,41 @@
 #include <hex/helpers/logger.hpp>
 
 #include <algorithm>
+#include <array>
+#include <deque>
+#include <exception>
 #include <ranges>
+#include <utility>
 
 namespace hex {
 
+    struct TaskManager::WorkerQueue {
+        std::mutex mutex;
+        std::array<std::deque<Job>, 3> jobs;
+    };
+
     std::mutex TaskManager::s_deferredCallsMutex, TaskManager::s_tasksFinishedMutex;
 
-    std::list<std::shared_ptr<Task>> TaskManager::s_tasks, TaskManager::s_taskQueue;
+    std::list<std::shared_ptr<Task>> TaskManager::s_tasks;
     std::list<std::function<void()>> TaskManager::s_deferredCalls;
     std::list<std::function<void()>> TaskManager::s_tasksFinishedCallbacks;
 
+    std::unique_ptr<TaskManager::WorkerQueue> TaskManager::s_sharedQueue = std::make_unique<TaskManager::WorkerQueue>();
+    std::vector<std::unique_ptr<TaskManager::WorkerQueue>> TaskManager::s_workerQueues;
+    std::atomic<size_t> TaskManager::s_queuedJobCount = 0;
+
     std::mutex TaskManager::s_queueMutex;
     std::condition_variable TaskManager::s_jobCondVar;
     std::vector<std::jthread> TaskManager::s_workers;
 
-    Task::Task(std::string unlocalizedName, u64 maxValue, bool background, std::function<void(Task &)> function)
-    : m_unlocalizedName(std::move(unlocalizedName)), m_currValue(0), m_maxValue(maxValue), m_function(std::move(function)), m_background(background) { }
+    // Index of the worker the current thread belongs to
+    static thread_local std::optional<size_t> s_currWorkerIndex;
+
+    Task::Task(std::string unlocalizedName, u64 maxValue, bool background, std::function<void(Task &)> function, TaskPriority priority)
+    : m_unlocalizedName(std::move(unlocalizedName)), m_currValue(0), m_maxValue(maxValue), m_function(std::move(function)), m_background(background), m_priority(priority) { }
+
+    Task::Task(Task &parent)
+    : m_unlocalizedName(parent.m_unlocalizedName), m_currValue(0), m_maxValue(0), m_background(bool(parent.m_background)), m_priority(parent.m_priority), m_parent(&parent) { }
 
     Task::Task(hex::Task &&other) noexcept {
         {
@@ -33,6 +52,9 @@ namespace hex {
         this->m_maxValue    = u64(other.m_maxValue);
         this->m_currValue   = u64(other.m_currValue);
 
+        this->m_priority    = other.m_priority;
+        this->m_parent      = other.m_parent;
+
         this->m_finished        = bool(other.m_finished);
         this->m_hadException    = bool(other.m_hadException);
         this->m_interrupted     = bool(other.m_interrupted);
@@ -40,17 +62,28 @@ namespace hex {
     }
 
     Task::~Task() {
-        if (!this->isFinished())
+        if (!this->isFinished() && this->m_parent == nullptr)
             this->interrupt();
     }
 
     void Task::update(u64 value) {
+        if (this->m_parent != nullptr)
+            this->m_parent->addProgress(value - this->m_currValue);
+
         this->m_currValue = value;
 
-        if (this->m_shouldInterrupt) [[unlikely]]
+        if (this->shouldInterrupt()) [[unlikely]]
             throw TaskInterruptor();
     }
 
+    void Task::addProgress(u64 value) {
+        // Values wrap around so progress can go backwards as well
+        this->m_currValue += value;
+
+        if (this->m_parent != nullptr)
+            this->m_parent->addProgress(value);
+    }
+
     void Task::setMaxValue(u64 value) {
         this->m_maxValue = value;
     }
@@ -80,7 +113,7 @@ namespace hex {
     }
 
     bool Task::shouldInterrupt() const {
-        return this->m_shouldInterrupt;
+        return this->m_shouldInterrupt || (this->m_parent != nullptr && this->m_parent->shouldInterrupt());
     }
 
     bool Task::wasInterrupted() const {
@@ -109,6 +142,83 @@ namespace hex {
         return this->m_maxValue;
     }
 
+    TaskPriority Task::getPriority() const {
+        return this->m_priority;
+    }
+
+    void Task::parallelFor(Region region, u64 chunkSize, const std::function<void(Task &, Region)> &function) {
+        if (region.getSize() == 0)
+            return;
+
+        chunkSize = std::max<u64>(chunkSize, 1);
+
+        // Helper jobs may only get to run after this function already returned, so all state they access is shared with them
+        struct State {
+            Region region;
+            u64 chunkSize;
+            u64 chunkCount;
+
+            std::atomic<u64> nextChunk = 0, finishedChunks = 0;
+            std::atomic<bool> abort = false;
+
+            std::mutex exceptionMutex;
+            std::exception_ptr exception;
+        };
+
+        auto state = std::make_shared<State>();
+        state->region       = region;
+        state->chunkSize    = chunkSize;
+        state->chunkCount   = (region.getSize() + chunkSize - 1) / chunkSize;
+
+        auto processChunks = [this, &function](State &state) {
+            while (true) {
+                const u64 chunkIndex = state.nextChunk++;
+                if (chunkIndex >= state.chunkCount)
+                    break;
+
+                if (!state.abort && !this->shouldInterrupt()) {
+                    const u64 chunkAddress = state.region.getStartAddress() + chunkIndex * state.chunkSize;
+                    const Region chunk = { chunkAddress, std::min<u64>(state.chunkSize, state.region.getEndAddress() - chunkAddress + 1) };
+
+                    Task subtask(*this);
+                    try {
+                        function(subtask, chunk);
+                        subtask.update(chunk.getSize());
+                    } catch (const TaskInterruptor &) {
+                        state.abort = true;
+                    } catch (...) {
+                        std::scoped_lock lock(state.exceptionMutex);
+                        if (state.exception == nullptr)
+                            state.exception = std::current_exception();
+
+                        state.abort = true;
+                    }
+                }
+
+                if (++state.finishedChunks == state.chunkCount)
+                    state.finishedChunks.notify_all();
+            }
+        };
+
+        const auto helperCount = std::min<u64>(TaskManager::s_workers.size(), state->chunkCount - 1);
+        for (u64 i = 0; i < helperCount; i++) {
+            // Helpers that only get to run once all chunks have been claimed return right away without touching anything but the shared state
+            TaskManager::queueJob([state, processChunks] { processChunks(*state); }, this->m_priority);
+        }
+
+        processChunks(*state);
+
+        // Wait for the chunks other threads are still working on
+        for (u64 finished = state->finishedChunks; finished != state->chunkCount; finished = state->finishedChunks)
+            state->finishedChunks.wait(finished);
+
+        if (state->exception != nullptr)
+            std::rethrow_exception(state->exception);
+
+        if (this->shouldInterrupt())
+            throw TaskInterruptor();
+    }
+
     void Task::finish() {
         this->m_finished = true;
     }
@@ -167,8 +277,13 @@ namespace hex {
 
 
     void TaskManager::init() {
-        for (u32 i = 0; i < std::thread::hardware_concurrency(); i++)
-            TaskManager::s_workers.emplace_back(TaskManager::runner);
+        const auto workerCount = std::max(std::thread::hardware_concurrency(), 1U);
+
+        for (u32 i = 0; i < workerCount; i++)
+            TaskManager::s_workerQueues.push_back(std::make_unique<WorkerQueue>());
+
+        for (u32 i = 0; i < workerCount; i++)
+            TaskManager::s_workers.emplace_back(TaskManager::runner, i);
     }
 
     void TaskManager::exit() {
@@ -178,64 +293,125 @@ namespace hex {
         for (auto &thread : TaskManager::s_workers)
             thread.request_stop();
 
-        s_jobCondVar.notify_all();
+        {
+            std::scoped_lock lock(s_queueMutex);
+            s_jobCondVar.notify_all();
+        }
 
         TaskManager::s_workers.clear();
+        TaskManager::s_workerQueues.clear();
     }
 
-    void TaskManager::runner(const std::stop_token &stopToken) {
-        std::mutex mutex;
-        while (true) {
-            std::shared_ptr<Task> task;
-            {
-                std::unique_lock lock(s_queueMutex);
-                s_jobCondVar.wait(lock, [&] {
-                    return !s_taskQueue.empty() || stopToken.stop_requested();
-                });
-                if (stopToken.stop_requested())
-                    break;
+    void TaskManager::queueJob(Job job, TaskPriority priority) {
+        auto &queue = s_currWorkerIndex.has_value() ? *s_workerQueues[*s_currWorkerIndex] : *s_sharedQueue;
 
-                task = std::move(s_taskQueue.front());
-                s_taskQueue.pop_front();
-            }
+        {
+            std::scoped_lock lock(queue.mutex);
+            queue.jobs[std::to_underlying(priority)].push_back(std::move(job));
+        }
+
+        {
+            std::scoped_lock lock(s_queueMutex);
+            s_queuedJobCount++;
+        }
+
+        s_jobCondVar.notify_one();
+    }
+
+    std::optional<TaskManager::Job> TaskManager::takeJob(size_t workerIndex) {
+        auto take = [](WorkerQueue &queue, size_t priority, bool newest) -> std::optional<Job> {
+            std::scoped_lock lock(queue.mutex);
+
+            auto &jobs = queue.jobs[priority];
+            if (jobs.empty())
+                return std::nullopt;
 
-            try {
-                task->m_function(*task);
-            } catch (const Task::TaskInterruptor &) {
-                task->interruption();
-            } catch (const std::exception &e) {
-                log::error("Exception in task {}: {}", task->m_unlocalizedName, e.what());
-                task->exception(e.what());
-            } catch (...) {
-                log::error("Exception in task {}", task->m_unlocalizedName);
-                task->exception("Unknown Exception");
+            Job job;
+            if (newest) {
+                job = std::move(jobs.back());
+                jobs.pop_back();
+            } else {
+                job = std::move(jobs.front());
+                jobs.pop_front();
             }
 
-            task->finish();
+            s_queuedJobCount--;
+
+            return job;
+        };
+
+        for (size_t priority = 0; priority < s_sharedQueue->jobs.size(); priority++) {
+            // Work on the most recently queued jobs of our own queue first, their data is most likely still in the cache
+            if (auto job = take(*s_workerQueues[workerIndex], priority, true))
+                return job;
+
+            if (auto job = take(*s_sharedQueue, priority, false))
+                return job;
+
+            // Steal the oldest jobs of the other workers
+            for (size_t i = 1; i < s_workerQueues.size(); i++) {
+                if (auto job = take(*s_workerQueues[(workerIndex + i) % s_workerQueues.size()], priority, false))
+                    return job;
+            }
         }
+
+        return std::nullopt;
     }
 
-    TaskHolder TaskManager::createTask(std::string name, u64 maxValue, std::function<void(Task &)> function) {
-        std::unique_lock lock(s_queueMutex);
-        auto task = std::make_shared<Task>(std::move(name), maxValue, false, std::move(function));
-        s_tasks.emplace_back(task);
-        s_taskQueue.emplace_back(task);
+    void TaskManager::runner(const std::stop_token &stopToken, size_t workerIndex) {
+        s_currWorkerIndex = workerIndex;
 
-        s_jobCondVar.notify_one();
+        while (!stopToken.stop_requested()) {
+            if (auto job = takeJob(workerIndex); job.has_value()) {
+                (*job)();
+                continue;
+            }
 
-        return TaskHolder(s_tasks.back());
+            std::unique_lock lock(s_queueMutex);
+            s_jobCondVar.wait(lock, [&] {
+                return s_queuedJobCount > 0 || stopToken.stop_requested();
+            });
+        }
     }
 
-    TaskHolder TaskManager::createBackgroundTask(std::string name, std::function<void(Task &)> function) {
-        std::unique_lock lock(s_queueMutex);
+    void TaskManager::runTask(const std::shared_ptr<Task> &task) {
+        try {
+            task->m_function(*task);
+        } catch (const Task::TaskInterruptor &) {
+            task->interruption();
+        } catch (const std::exception &e) {
+            log::error("Exception in task {}: {}", task->m_unlocalizedName, e.what());
+            task->exception(e.what());
+        } catch (...) {
+            log::error("Exception in task {}", task->m_unlocalizedName);
+            task->exception("Unknown Exception");
+        }
 
-        auto task = std::make_shared<Task>(std::move(name), 0, true, std::move(function));
-        s_tasks.emplace_back(task);
-        s_taskQueue.emplace_back(task);
+        task->finish();
+    }
 
-        s_jobCondVar.notify_one();
+    TaskHolder TaskManager::createTask(std::string name, u64 maxValue, std::function<void(Task &)> function, TaskPriority priority) {
+        auto task = std::make_shared<Task>(std::move(name), maxValue, false, std::move(function), priority);
+        {
+            std::unique_lock lock(s_queueMutex);
+            s_tasks.emplace_back(task);
+        }
+
+        queueJob([task] { runTask(task); }, priority);
+
+        return TaskHolder(task);
+    }
+
+    TaskHolder TaskManager::createBackgroundTask(std::string name, std::function<void(Task &)> function, TaskPriority priority) {
+        auto task = std::make_shared<Task>(std::move(name), 0, true, std::move(function), priority);
+        {
+            std::unique_lock lock(s_queueMutex);
+            s_tasks.emplace_back(task);
+        }
+
+        queueJob([task] { runTask(task); }, priority);
 
-        return TaskHolder(s_tasks.back());
+        return TaskHolder(task);
     }
 
     void TaskManager::collectGarbage() {
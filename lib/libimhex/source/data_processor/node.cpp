@@ -5,9 +5,40 @@
 #include <hex/api/localization.hpp>
 #include <hex/providers/provider.hpp>
 
+#include <wolv/utils/guards.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <unordered_set>
+
 namespace hex::dp {
 
+    namespace {
+
+        constexpr static u64 HashSeed = 0xCBF2'9CE4'8422'2325;
+
+        // FNV-1a. Only used to detect changes of a node's settings and inputs
+        u64 hashBytes(u64 hash, std::span<const u8> data) {
+            for (u8 byte : data) {
+                hash ^= byte;
+                hash *= 0x0100'0000'01B3;
+            }
+
+            return hash;
+        }
+
+        u64 hashBuffer(u64 hash, std::span<const u8> data) {
+            const u64 size = data.size();
+            hash = hashBytes(hash, { reinterpret_cast<const u8 *>(&size), sizeof(size) });
+
+            return hashBytes(hash, data);
+        }
+
+    }
+
     int Node::s_idCounter = 1;
+    u64 Node::s_evaluationIdCounter = 0;
+    u64 Node::s_currentEvaluationId = 0;
 
     Node::Node(std::string unlocalizedTitle, std::vector<Attribute> attributes) : m_id(Node::s_idCounter++), m_unlocalizedTitle(std::move(unlocalizedTitle)), m_attributes(std::move(attributes)) {
         for (auto &attr : this->m_attributes)
@@ -23,8 +54,7 @@ namespace hex::dp {
         if (attribute->getType() != Attribute::Type::Buffer)
             throwNodeError("Tried to read buffer from non-buffer attribute");
 
-        markInputProcessed(index);
-        attribute->getParentNode()->process();
+        attribute->getParentNode()->evaluate();
 
         auto &outputData = attribute->getOutputData();
 
@@ -42,8 +72,7 @@ namespace hex::dp {
                 if (attribute->getType() != Attribute::Type::Integer)
                     throwNodeError("Tried to read integer from non-integer attribute");
 
-                markInputProcessed(index);
-                attribute->getParentNode()->process();
+                attribute->getParentNode()->evaluate();
 
                 return attribute->getOutputData();
             } else {
@@ -68,8 +97,7 @@ namespace hex::dp {
                 if (attribute->getType() != Attribute::Type::Float)
                     throwNodeError("Tried to read integer from non-float attribute");
 
-                markInputProcessed(index);
-                attribute->getParentNode()->process();
+                attribute->getParentNode()->evaluate();
 
                 return attribute->getOutputData();
             } else {
@@ -86,6 +114,95 @@ namespace hex::dp {
         return *reinterpret_cast<long double *>(outputData.data());
     }
 
+    void Node::evaluate() {
+        if (Node::s_currentEvaluationId != 0 && this->m_evaluationId == Node::s_currentEvaluationId)
+            return;
+
+        if (this->m_evaluating)
+            throwNodeError("Recursion detected!");
+
+        this->m_evaluating = true;
+        ON_SCOPE_EXIT { this->m_evaluating = false; };
+
+        // The outputs only need to be computed again if the node's settings or the data on any of its inputs changed
+        u64 key = HashSeed;
+        if (!this->isVolatile()) {
+            nlohmann::json settings;
+            this->store(settings);
+
+            const auto serializedSettings = settings.dump();
+            key = hashBuffer(key, { reinterpret_cast<const u8 *>(serializedSettings.data()), serializedSettings.size() });
+        }
+
+        for (auto &attribute : this->m_attributes) {
+            if (attribute.getIOType() != Attribute::IOType::In)
+                continue;
+
+            const auto &connectedAttributes = attribute.getConnectedAttributes();
+            if (connectedAttributes.empty()) {
+                key = hashBuffer(key, attribute.getOutputData());
+            } else {
+                auto connectedAttribute = connectedAttributes.begin()->second;
+                connectedAttribute->getParentNode()->evaluate();
+
+                key = hashBuffer(key, connectedAttribute->getOutputData());
+            }
+        }
+
+        if (this->isVolatile() || this->m_cacheKey != key) {
+            this->m_cacheKey.reset();
+            this->resetOutputData();
+
+            this->process();
+
+            this->m_cacheKey = key;
+        }
+
+        this->m_evaluationId = Node::s_currentEvaluationId;
+    }
+
+    std::vector<Node *> Node::createExecutionPlan(std::span<Node * const> endNodes) {
+        std::vector<Node *> plan;
+        std::unordered_set<Node *> visited, visiting;
+
+        // Depth first search along the inputs. A node is added once all nodes connected to its inputs have been added
+        auto visit = [&](auto &&visit, Node *node) -> void {
+            if (visited.contains(node))
+                return;
+
+            if (!visiting.insert(node).second)
+                node->throwNodeError("Recursion detected!");
+
+            for (auto &attribute : node->getAttributes()) {
+                if (attribute.getIOType() != Attribute::IOType::In)
+                    continue;
+
+                for (auto &[linkId, connectedAttribute] : attribute.getConnectedAttributes())
+                    visit(visit, connectedAttribute->getParentNode());
+            }
+
+            visiting.erase(node);
+            visited.insert(node);
+            plan.push_back(node);
+        };
+
+        for (auto endNode : endNodes)
+            visit(visit, endNode);
+
+        return plan;
+    }
+
+    void Node::execute(std::span<Node * const> plan) {
+        // Custom nodes execute their inner graph while processing. Restore the id of the outer evaluation afterwards,
+        // otherwise the nodes of the outer graph that were already evaluated would be evaluated a second time
+        const auto outerEvaluationId = Node::s_currentEvaluationId;
+        Node::s_currentEvaluationId = ++Node::s_evaluationIdCounter;
+        ON_SCOPE_EXIT { Node::s_currentEvaluationId = outerEvaluationId; };
+
+        for (auto node : plan)
+            node->evaluate();
+    }
+
     void Node::setBufferOnOutput(u32 index, std::span<const u8> data) {
         if (index >= this->getAttributes().size())
             throwNodeError("Attribute index out of bounds!");
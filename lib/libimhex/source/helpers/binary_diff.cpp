@@ -0,0 +1,455 @@
+#include <hex/helpers/binary_diff.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__SSE2__)
+    #define BINARY_DIFF_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace hex::diff {
+
+    namespace {
+
+        // Chunks are between MinChunkSize and MaxChunkSize bytes long. In between, a chunk ends wherever all bits of the rolling hash
+        // selected by ChunkBoundaryMask are zero, which happens every 2 KiB on average
+        constexpr static u64 MinChunkSize = 0x200, MaxChunkSize = 0x4000;
+        constexpr static u64 ChunkBoundaryMask = 0xFFE0'0000'0000'0000;
+
+        // Amount of data chunked by each subtask
+        constexpr static u64 SegmentSize = 0x100'0000;
+
+        // Amount of data read at once
+        constexpr static u64 ReadSize = 0x10'0000;
+
+        // Number of aligned chunk pairs each subtask compares byte by byte
+        constexpr static u64 VerifyBatchSize = 0x100;
+
+        // Random value every byte contributes to the rolling hash, generated using splitmix64
+        constexpr static auto GearTable = [] {
+            std::array<u64, 256> table = { };
+
+            u64 state = 0x1337'C0DE'D1FF'0000;
+            for (auto &value : table) {
+                state += 0x9E37'79B9'7F4A'7C15;
+
+                u64 z = state;
+                z = (z ^ (z >> 30)) * 0xBF58'476D'1CE4'E5B9;
+                z = (z ^ (z >> 27)) * 0x94D0'49BB'1331'11EB;
+                value = z ^ (z >> 31);
+            }
+
+            return table;
+        }();
+
+        // Chunk contents are identified using their size and their 64 bit FNV-1a hash. Chunks only get aligned once their bytes were compared as well
+        constexpr static u64 FnvOffsetBasis = 0xCBF2'9CE4'8422'2325, FnvPrime = 0x0000'0100'0000'01B3;
+
+        using Gap = std::pair<Region, Region>;
+
+        prv::DataView readPiece(prv::Provider *provider, u64 address, size_t size, std::vector<u8> &buffer) {
+            if (auto view = provider->getDataView(address, size); view.has_value())
+                return std::move(*view);
+
+            buffer.resize(size);
+            provider->read(address, buffer.data(), size);
+
+            return prv::DataView(buffer);
+        }
+
+        bool haveSameHash(const Chunk &a, const Chunk &b) {
+            return a.size == b.size && a.hash == b.hash;
+        }
+
+        /**
+         * @brief Finds the first position at which the bytes of two buffers are either equal or different
+         * @param a First buffer
+         * @param b Second buffer
+         * @param size Size of both buffers
+         * @param offset Position to start searching at
+         * @param equal Search for equal bytes instead of different ones
+         * @return Position or size if there is none
+         */
+        size_t findNext(const u8 *a, const u8 *b, size_t size, size_t offset, bool equal) {
+            #if defined(BINARY_DIFF_SSE2)
+                for (; offset + sizeof(__m128i) <= size; offset += sizeof(__m128i)) {
+                    const auto equalBytes = u32(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + offset)),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + offset))
+                    )));
+
+                    if (const auto bits = equal ? equalBytes : ~equalBytes & 0xFFFF; bits != 0)
+                        return offset + std::countr_zero(bits);
+                }
+            #endif
+
+            for (; offset < size; offset++) {
+                if ((a[offset] == b[offset]) == equal)
+                    return offset;
+            }
+
+            return size;
+        }
+
+        /**
+         * @brief Counts the equal bytes at the end of two buffers
+         * @param a First buffer
+         * @param b Second buffer
+         * @param size Size of both buffers
+         * @return Number of equal bytes
+         */
+        size_t countEqualSuffix(const u8 *a, const u8 *b, size_t size) {
+            size_t length = 0;
+
+            #if defined(BINARY_DIFF_SSE2)
+                for (; length + sizeof(__m128i) <= size; length += sizeof(__m128i)) {
+                    const auto position = size - length - sizeof(__m128i);
+                    const auto differentBytes = ~u32(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + position)),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + position))
+                    ))) & 0xFFFF;
+
+                    if (differentBytes != 0)
+                        return length + std::countl_zero(differentBytes << 16);
+                }
+            #endif
+
+            while (length < size && a[size - length - 1] == b[size - length - 1])
+                length++;
+
+            return length;
+        }
+
+        /**
+         * @brief Removes all pairs of chunks whose bytes differ even though their size and hash are the same
+         * The chunks of all pairs are compared in parallel. The task's progress advances by one for every pair
+         * @param pairs Indices of chunks with the same hash, ascending in both lists
+         */
+        void removeHashCollisions(Task &task, prv::Provider *providerA, const std::vector<Chunk> &chunksA, prv::Provider *providerB, const std::vector<Chunk> &chunksB, std::vector<std::pair<size_t, size_t>> &pairs) {
+            std::vector<u8> equal(pairs.size(), false);
+
+            task.parallelFor({ 0, pairs.size() }, VerifyBatchSize, [&](Task &, Region batch) {
+                std::vector<u8> bufferA, bufferB;
+
+                for (u64 i = batch.getStartAddress(); i <= batch.getEndAddress(); i++) {
+                    const auto &chunkA = chunksA[pairs[i].first], &chunkB = chunksB[pairs[i].second];
+                    const auto a = readPiece(providerA, chunkA.address, chunkA.size, bufferA);
+                    const auto b = readPiece(providerB, chunkB.address, chunkB.size, bufferB);
+
+                    equal[i] = findNext(a.data(), b.data(), chunkA.size, 0, false) == chunkA.size;
+                }
+            });
+
+            size_t count = 0;
+            for (size_t i = 0; i < pairs.size(); i++) {
+                if (equal[i])
+                    pairs[count++] = pairs[i];
+            }
+            pairs.resize(count);
+        }
+
+        void splitSegment(Task &task, prv::Provider *provider, Region segment, std::vector<Chunk> &chunks) {
+            std::vector<u8> buffer;
+
+            u64 gear = 0, hash = FnvOffsetBasis;
+            u64 chunkStart = segment.getStartAddress();
+            for (u64 address = segment.getStartAddress(); address <= segment.getEndAddress(); address += ReadSize) {
+                const auto data = readPiece(provider, address, std::min<u64>(ReadSize, segment.getEndAddress() - address + 1), buffer);
+
+                for (size_t i = 0; i < data.size(); i++) {
+                    gear = (gear << 1) + GearTable[data[i]];
+                    hash = (hash ^ data[i]) * FnvPrime;
+
+                    const u64 chunkSize = address + i + 1 - chunkStart;
+                    if ((chunkSize >= MinChunkSize && (gear & ChunkBoundaryMask) == 0) || chunkSize == MaxChunkSize) {
+                        chunks.push_back({ chunkStart, chunkSize, hash });
+
+                        chunkStart += chunkSize;
+                        hash = FnvOffsetBasis;
+                    }
+                }
+
+                task.update(address + data.size() - segment.getStartAddress());
+            }
+
+            if (chunkStart <= segment.getEndAddress())
+                chunks.push_back({ chunkStart, segment.getEndAddress() - chunkStart + 1, hash });
+        }
+
+        /**
+         * @brief Aligns two lists of chunks
+         * Chunks that appear exactly once in both lists are used as anchors. The longest sequence of anchors that's in the same order
+         * in both lists gets aligned, together with all equal chunks directly following or preceding the aligned chunks.
+         * Chunks whose bytes turn out to differ despite their equal hash are never aligned and end up in the gaps instead
+         * @return Indices of aligned chunks, ascending in both lists
+         */
+        std::vector<std::pair<size_t, size_t>> alignChunks(Task &task, prv::Provider *providerA, const std::vector<Chunk> &chunksA, prv::Provider *providerB, const std::vector<Chunk> &chunksB) {
+            struct Occurrences {
+                u32 countA = 0, countB = 0;
+                size_t indexA = 0, indexB = 0;
+            };
+
+            const auto getKey = [](const Chunk &chunk) { return chunk.hash ^ std::rotl(chunk.size, 32); };
+
+            std::unordered_map<u64, Occurrences> occurrences;
+            for (size_t i = 0; i < chunksA.size(); i++) {
+                auto &entry = occurrences[getKey(chunksA[i])];
+                entry.countA += 1;
+                entry.indexA = i;
+            }
+            for (size_t i = 0; i < chunksB.size(); i++) {
+                auto &entry = occurrences[getKey(chunksB[i])];
+                entry.countB += 1;
+                entry.indexB = i;
+            }
+
+            std::vector<std::pair<size_t, size_t>> anchors;
+            for (const auto &[key, entry] : occurrences) {
+                if (entry.countA == 1 && entry.countB == 1 && haveSameHash(chunksA[entry.indexA], chunksB[entry.indexB]))
+                    anchors.emplace_back(entry.indexA, entry.indexB);
+            }
+            std::ranges::sort(anchors);
+            removeHashCollisions(task, providerA, chunksA, providerB, chunksB, anchors);
+
+            // Longest increasing subsequence of the anchors' indices in the second list
+            constexpr static auto NoPrevious = std::numeric_limits<size_t>::max();
+            std::vector<size_t> tails, previous(anchors.size(), NoPrevious);
+            for (size_t i = 0; i < anchors.size(); i++) {
+                auto it = std::ranges::lower_bound(tails, anchors[i].second, { }, [&](size_t tail) { return anchors[tail].second; });
+                if (it != tails.begin())
+                    previous[i] = *(it - 1);
+
+                if (it == tails.end())
+                    tails.push_back(i);
+                else
+                    *it = i;
+            }
+
+            std::vector<std::pair<size_t, size_t>> orderedAnchors;
+            for (size_t i = tails.empty() ? NoPrevious : tails.back(); i != NoPrevious; i = previous[i])
+                orderedAnchors.push_back(anchors[i]);
+            std::ranges::reverse(orderedAnchors);
+
+            // Extend the alignment to the equal chunks around the anchors
+            std::vector<std::pair<size_t, size_t>> extension;
+            size_t nextA = 0, nextB = 0;
+            const auto alignUpTo = [&](size_t endA, size_t endB) {
+                while (nextA < endA && nextB < endB && haveSameHash(chunksA[nextA], chunksB[nextB])) {
+                    extension.emplace_back(nextA, nextB);
+                    nextA++;
+                    nextB++;
+                }
+
+                size_t a = endA, b = endB;
+                while (a > nextA && b > nextB && haveSameHash(chunksA[a - 1], chunksB[b - 1])) {
+                    a--;
+                    b--;
+                }
+
+                for (; a < endA; a++, b++)
+                    extension.emplace_back(a, b);
+            };
+
+            for (const auto &[indexA, indexB] : orderedAnchors) {
+                alignUpTo(indexA, indexB);
+
+                nextA = indexA + 1;
+                nextB = indexB + 1;
+            }
+            alignUpTo(chunksA.size(), chunksB.size());
+
+            // The anchors were already verified, only the chunks around them still need to be compared
+            removeHashCollisions(task, providerA, chunksA, providerB, chunksB, extension);
+
+            std::vector<std::pair<size_t, size_t>> result;
+            std::ranges::merge(orderedAnchors, extension, std::back_inserter(result));
+
+            return result;
+        }
+
+        /**
+         * @brief Collects the data between aligned chunks
+         * @return Pairs of regions that aren't aligned, at least one of which isn't empty
+         */
+        std::vector<Gap> findGaps(const std::vector<Chunk> &chunksA, Region regionA, const std::vector<Chunk> &chunksB, Region regionB, const std::vector<std::pair<size_t, size_t>> &alignment) {
+            const auto getAddress = [](const std::vector<Chunk> &chunks, Region region, size_t index) {
+                return index < chunks.size() ? chunks[index].address : region.getStartAddress() + region.getSize();
+            };
+
+            std::vector<Gap> result;
+            size_t nextA = 0, nextB = 0;
+            const auto addGap = [&](size_t endA, size_t endB) {
+                if (endA == nextA && endB == nextB)
+                    return;
+
+                const auto startA = getAddress(chunksA, regionA, nextA), startB = getAddress(chunksB, regionB, nextB);
+                result.emplace_back(
+                    Region { startA, getAddress(chunksA, regionA, endA) - startA },
+                    Region { startB, getAddress(chunksB, regionB, endB) - startB }
+                );
+            };
+
+            for (const auto &[indexA, indexB] : alignment) {
+                addGap(indexA, indexB);
+
+                nextA = indexA + 1;
+                nextB = indexB + 1;
+            }
+            addGap(chunksA.size(), chunksB.size());
+
+            return result;
+        }
+
+        u64 countEqualPrefix(Task &task, prv::Provider *providerA, u64 addressA, prv::Provider *providerB, u64 addressB, u64 size) {
+            std::vector<u8> bufferA, bufferB;
+
+            for (u64 offset = 0; offset < size; offset += ReadSize) {
+                const auto pieceSize = std::min<u64>(ReadSize, size - offset);
+                const auto a = readPiece(providerA, addressA + offset, pieceSize, bufferA);
+                const auto b = readPiece(providerB, addressB + offset, pieceSize, bufferB);
+
+                if (const auto position = findNext(a.data(), b.data(), pieceSize, 0, false); position < pieceSize)
+                    return offset + position;
+
+                task.update();
+            }
+
+            return size;
+        }
+
+        u64 countEqualSuffix(Task &task, prv::Provider *providerA, u64 endAddressA, prv::Provider *providerB, u64 endAddressB, u64 size) {
+            std::vector<u8> bufferA, bufferB;
+
+            for (u64 offset = 0; offset < size; offset += ReadSize) {
+                const auto pieceSize = std::min<u64>(ReadSize, size - offset);
+                const auto a = readPiece(providerA, endAddressA - offset - pieceSize, pieceSize, bufferA);
+                const auto b = readPiece(providerB, endAddressB - offset - pieceSize, pieceSize, bufferB);
+
+                if (const auto length = countEqualSuffix(a.data(), b.data(), pieceSize); length < pieceSize)
+                    return offset + length;
+
+                task.update();
+            }
+
+            return size;
+        }
+
+        std::vector<Difference> findModifiedRuns(Task &task, prv::Provider *providerA, Region regionA, prv::Provider *providerB, Region regionB) {
+            std::vector<Difference> result;
+            std::vector<u8> bufferA, bufferB;
+
+            std::optional<u64> runStart;
+            const auto addRun = [&](u64 end) {
+                result.push_back({
+                    Region { regionA.getStartAddress() + *runStart, end - *runStart },
+                    Region { regionB.getStartAddress() + *runStart, end - *runStart },
+                    DifferenceType::Modified
+                });
+                runStart.reset();
+            };
+
+            for (u64 offset = 0; offset < regionA.getSize(); offset += ReadSize) {
+                const auto pieceSize = std::min<u64>(ReadSize, regionA.getSize() - offset);
+                const auto a = readPiece(providerA, regionA.getStartAddress() + offset, pieceSize, bufferA);
+                const auto b = readPiece(providerB, regionB.getStartAddress() + offset, pieceSize, bufferB);
+
+                for (size_t i = 0; i < pieceSize;) {
+                    if (!runStart.has_value()) {
+                        i = findNext(a.data(), b.data(), pieceSize, i, false);
+                        if (i < pieceSize)
+                            runStart = offset + i;
+                    } else {
+                        i = findNext(a.data(), b.data(), pieceSize, i, true);
+                        if (i < pieceSize)
+                            addRun(offset + i);
+                    }
+                }
+
+                task.update();
+            }
+
+            if (runStart.has_value())
+                addRun(regionA.getSize());
+
+            return result;
+        }
+
+        std::vector<Difference> compareGap(Task &task, prv::Provider *providerA, Region regionA, prv::Provider *providerB, Region regionB) {
+            // Chunk boundaries of equal data can differ near changes, so the gap may start and end with equal data
+            const auto commonSize = std::min(regionA.getSize(), regionB.getSize());
+            const auto prefix = countEqualPrefix(task, providerA, regionA.getStartAddress(), providerB, regionB.getStartAddress(), commonSize);
+            const auto suffix = countEqualSuffix(task, providerA, regionA.getStartAddress() + regionA.getSize(), providerB, regionB.getStartAddress() + regionB.getSize(), commonSize - prefix);
+
+            const Region remainingA = { regionA.getStartAddress() + prefix, regionA.getSize() - prefix - suffix };
+            const Region remainingB = { regionB.getStartAddress() + prefix, regionB.getSize() - prefix - suffix };
+
+            if (remainingA.getSize() == 0 && remainingB.getSize() == 0)
+                return { };
+            else if (remainingA.getSize() == 0)
+                return { { remainingA, remainingB, DifferenceType::Removed } };
+            else if (remainingB.getSize() == 0)
+                return { { remainingA, remainingB, DifferenceType::Added } };
+            else if (remainingA.getSize() != remainingB.getSize())
+                return { { remainingA, remainingB, DifferenceType::Modified } };
+            else
+                return findModifiedRuns(task, providerA, remainingA, providerB, remainingB);
+        }
+
+    }
+
+    std::vector<Chunk> splitIntoChunks(Task &task, prv::Provider *provider, Region region) {
+        std::vector<std::vector<Chunk>> segmentChunks((region.getSize() + SegmentSize - 1) / SegmentSize);
+
+        task.parallelFor(region, SegmentSize, [&](Task &subtask, Region segment) {
+            splitSegment(subtask, provider, segment, segmentChunks[(segment.getStartAddress() - region.getStartAddress()) / SegmentSize]);
+        });
+
+        std::vector<Chunk> result;
+        for (const auto &chunks : segmentChunks)
+            result.insert(result.end(), chunks.begin(), chunks.end());
+
+        return result;
+    }
+
+    std::vector<Difference> compare(Task &task, prv::Provider *providerA, Region regionA, prv::Provider *providerB, Region regionB) {
+        task.setMaxValue(regionA.getSize() + regionB.getSize());
+        task.update(0);
+
+        const auto chunksA = splitIntoChunks(task, providerA, regionA);
+        const auto chunksB = splitIntoChunks(task, providerB, regionB);
+
+        // Aligning the chunks advances the progress by one for every pair of chunks compared, each chunk is part of at most two of them
+        task.setMaxValue(chunksA.size() + chunksB.size());
+        task.update(0);
+
+        const auto gaps = findGaps(chunksA, regionA, chunksB, regionB, alignChunks(task, providerA, chunksA, providerB, chunksB));
+
+        // Gaps are independent of each other so they can be compared in parallel
+        task.setMaxValue(gaps.size());
+        task.update(0);
+
+        std::vector<std::vector<Difference>> gapDifferences(gaps.size());
+        task.parallelFor({ 0, gaps.size() }, 1, [&](Task &subtask, Region chunk) {
+            const auto &[gapA, gapB] = gaps[chunk.getStartAddress()];
+            gapDifferences[chunk.getStartAddress()] = compareGap(subtask, providerA, gapA, providerB, gapB);
+        });
+
+        std::vector<Difference> result;
+        for (const auto &differences : gapDifferences)
+            result.insert(result.end(), differences.begin(), differences.end());
+
+        return result;
+    }
+
+}
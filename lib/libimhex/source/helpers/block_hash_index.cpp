@@ -0,0 +1,270 @@
+#include <hex/helpers/block_hash_index.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/helpers/crypto.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace hex {
+
+    namespace {
+
+        // Leaves and inner nodes get hashed with different prefixes so a block can never have the same hash as a pair of nodes
+        constexpr static u8 LeafPrefix = 0x00, NodePrefix = 0x01;
+
+        // Amount of data hashed by each subtask while updating the index
+        constexpr static u64 ChunkSize = 0x10'0000;
+
+        BlockHashIndex::Hash hashBlock(std::span<const u8> data) {
+            auto hasher = crypt::sha256Hasher();
+            hasher->update({ &LeafPrefix, 1 });
+            hasher->update(data);
+
+            BlockHashIndex::Hash result = { };
+            std::ranges::copy(hasher->finish(), result.begin());
+
+            return result;
+        }
+
+        BlockHashIndex::Hash hashNodes(const BlockHashIndex::Hash &left, const BlockHashIndex::Hash &right) {
+            auto hasher = crypt::sha256Hasher();
+            hasher->update({ &NodePrefix, 1 });
+            hasher->update(left);
+            hasher->update(right);
+
+            BlockHashIndex::Hash result = { };
+            std::ranges::copy(hasher->finish(), result.begin());
+
+            return result;
+        }
+
+    }
+
+    BlockHashIndex::BlockHashIndex(u64 blockSize) : m_blockSize(std::max<u64>(blockSize, 1)) { }
+
+    void BlockHashIndex::invalidate(Region region) {
+        if (region.getSize() == 0 || region.getStartAddress() >= this->m_dataSize)
+            return;
+
+        const auto firstBlock = region.getStartAddress() / this->m_blockSize;
+        const auto lastBlock  = std::min<u64>(region.getEndAddress() / this->m_blockSize, this->getBlockCount() - 1);
+
+        for (u64 block = firstBlock; block <= lastBlock; block++)
+            this->m_outdatedBlocks.push_back(block);
+
+        std::ranges::sort(this->m_outdatedBlocks);
+        auto duplicates = std::ranges::unique(this->m_outdatedBlocks);
+        this->m_outdatedBlocks.erase(duplicates.begin(), duplicates.end());
+    }
+
+    void BlockHashIndex::resize(u64 dataSize) {
+        if (dataSize == this->m_dataSize)
+            return;
+
+        const auto prevBlockCount = this->getBlockCount();
+        const auto newBlockCount  = (dataSize + this->m_blockSize - 1) / this->m_blockSize;
+
+        this->m_dataSize = dataSize;
+        this->m_levels.front().resize(newBlockCount);
+
+        std::erase_if(this->m_outdatedBlocks, [&](size_t block) { return block >= newBlockCount; });
+
+        // The size of the last block of the smaller of the two versions may have changed as well
+        if (newBlockCount > 0) {
+            const auto firstChangedOffset = (std::max<u64>(std::min<u64>(prevBlockCount, newBlockCount), 1) - 1) * this->m_blockSize;
+            this->invalidate({ firstChangedOffset, dataSize - firstChangedOffset });
+        } else {
+            this->updateParents({ });
+        }
+    }
+
+    u64 BlockHashIndex::getOutdatedSize() const {
+        u64 size = 0;
+        for (auto block : this->m_outdatedBlocks)
+            size += std::min<u64>(this->m_blockSize, this->m_dataSize - block * this->m_blockSize);
+
+        return size;
+    }
+
+    void BlockHashIndex::update(Task &task, prv::Provider *provider) {
+        this->resize(provider->getActualSize());
+
+        if (this->m_outdatedBlocks.empty())
+            return;
+
+        auto &leaves = this->m_levels.front();
+        const auto blocksPerChunk = std::max<u64>(ChunkSize / this->m_blockSize, 1);
+
+        // Hash every run of consecutive outdated blocks in parallel
+        for (size_t runStart = 0; runStart < this->m_outdatedBlocks.size();) {
+            size_t runEnd = runStart + 1;
+            while (runEnd < this->m_outdatedBlocks.size() && this->m_outdatedBlocks[runEnd] == this->m_outdatedBlocks[runEnd - 1] + 1)
+                runEnd++;
+
+            const u64 startOffset = this->m_outdatedBlocks[runStart] * this->m_blockSize;
+            const u64 endOffset   = std::min<u64>((this->m_outdatedBlocks[runEnd - 1] + 1) * this->m_blockSize, this->m_dataSize);
+
+            task.parallelFor({ startOffset, endOffset - startOffset }, blocksPerChunk * this->m_blockSize, [&](Task &subtask, Region chunk) {
+                std::vector<u8> buffer;
+
+                for (u64 offset = chunk.getStartAddress(); offset <= chunk.getEndAddress(); offset += this->m_blockSize) {
+                    const auto size    = std::min<u64>(this->m_blockSize, chunk.getEndAddress() - offset + 1);
+                    const auto address = provider->getBaseAddress() + offset;
+
+                    if (auto view = provider->getDataView(address, size); view.has_value()) {
+                        leaves[offset / this->m_blockSize] = hashBlock(*view);
+                    } else {
+                        buffer.resize(size);
+                        provider->read(address, buffer.data(), size);
+                        leaves[offset / this->m_blockSize] = hashBlock(buffer);
+                    }
+
+                    subtask.update(offset + size - chunk.getStartAddress());
+                }
+            });
+
+            runStart = runEnd;
+        }
+
+        // Only forget about the outdated blocks once everything has been hashed so an interrupted update can be resumed later
+        this->updateParents(std::move(this->m_outdatedBlocks));
+        this->m_outdatedBlocks.clear();
+    }
+
+    void BlockHashIndex::updateParents(std::vector<size_t> changedIndices) {
+        // Adjust the number of levels and nodes per level to the number of blocks
+        size_t levelCount = 1;
+        for (size_t nodeCount = this->getBlockCount(); nodeCount > 1; nodeCount = (nodeCount + 1) / 2)
+            levelCount++;
+
+        this->m_levels.resize(levelCount);
+        for (size_t level = 1; level < levelCount; level++)
+            this->m_levels[level].resize((this->m_levels[level - 1].size() + 1) / 2);
+
+        for (size_t level = 1; level < levelCount; level++) {
+            const auto &children = this->m_levels[level - 1];
+            auto &nodes = this->m_levels[level];
+
+            for (auto &index : changedIndices)
+                index /= 2;
+
+            auto duplicates = std::ranges::unique(changedIndices);
+            changedIndices.erase(duplicates.begin(), duplicates.end());
+
+            for (auto index : changedIndices) {
+                if (index * 2 + 1 < children.size())
+                    nodes[index] = hashNodes(children[index * 2], children[index * 2 + 1]);
+                else
+                    nodes[index] = children[index * 2];
+            }
+        }
+    }
+
+    BlockHashIndex::Hash BlockHashIndex::getRootHash() const {
+        if (this->getBlockCount() == 0)
+            return { };
+
+        return this->m_levels.back().front();
+    }
+
+    std::vector<Region> BlockHashIndex::getChangedRegions(const BlockHashIndex &other) const {
+        const auto dataSize = std::max(this->m_dataSize, other.m_dataSize);
+        if (this->m_blockSize != other.m_blockSize)
+            return { Region { 0, dataSize } };
+
+        const auto getNode = [](const BlockHashIndex &index, size_t level, size_t node) -> const Hash * {
+            if (level < index.m_levels.size() && node < index.m_levels[level].size())
+                return &index.m_levels[level][node];
+            else
+                return nullptr;
+        };
+
+        const auto blockCount = std::max(this->getBlockCount(), other.getBlockCount());
+
+        std::vector<Region> result;
+        const auto addBlock = [&](size_t block) {
+            const auto offset = block * this->m_blockSize;
+            const auto size   = std::min<u64>(this->m_blockSize, dataSize - offset);
+
+            if (!result.empty() && result.back().getEndAddress() + 1 == offset)
+                result.back().size += size;
+            else
+                result.push_back({ offset, size });
+        };
+
+        std::function<void(size_t, size_t)> compare = [&](size_t level, size_t node) {
+            const auto firstBlock = node << level;
+            if (firstBlock >= blockCount)
+                return;
+
+            // Nodes are only equal if they cover the same blocks in both trees
+            const auto lastBlock = (node + 1) << level;
+            const bool sameCoverage = std::min(lastBlock, this->getBlockCount()) == std::min(lastBlock, other.getBlockCount());
+
+            const auto ours = getNode(*this, level, node), theirs = getNode(other, level, node);
+            if (sameCoverage && ours != nullptr && theirs != nullptr && *ours == *theirs)
+                return;
+
+            if (level == 0) {
+                addBlock(node);
+            } else {
+                compare(level - 1, node * 2);
+                compare(level - 1, node * 2 + 1);
+            }
+        };
+
+        compare(std::max(this->m_levels.size(), other.m_levels.size()) - 1, 0);
+
+        return result;
+    }
+
+    std::vector<u8> BlockHashIndex::serialize() const {
+        if (!this->isUpToDate())
+            return { };
+
+        std::vector<u8> result(sizeof(u64) * 2 + this->getBlockCount() * sizeof(Hash));
+        std::memcpy(result.data(), &this->m_blockSize, sizeof(u64));
+        std::memcpy(result.data() + sizeof(u64), &this->m_dataSize, sizeof(u64));
+
+        for (size_t block = 0; block < this->getBlockCount(); block++)
+            std::ranges::copy(this->getLeaves()[block], result.begin() + sizeof(u64) * 2 + block * sizeof(Hash));
+
+        return result;
+    }
+
+    std::optional<BlockHashIndex> BlockHashIndex::deserialize(std::span<const u8> data) {
+        if (data.size() < sizeof(u64) * 2)
+            return std::nullopt;
+
+        u64 blockSize = 0, dataSize = 0;
+        std::memcpy(&blockSize, data.data(), sizeof(u64));
+        std::memcpy(&dataSize, data.data() + sizeof(u64), sizeof(u64));
+
+        if (blockSize == 0)
+            return std::nullopt;
+
+        const auto blockCount = dataSize / blockSize + (dataSize % blockSize != 0 ? 1 : 0);
+        if (blockCount != (data.size() - sizeof(u64) * 2) / sizeof(Hash) || (data.size() - sizeof(u64) * 2) % sizeof(Hash) != 0)
+            return std::nullopt;
+
+        BlockHashIndex index(blockSize);
+        index.m_dataSize = dataSize;
+
+        auto &leaves = index.m_levels.front();
+        leaves.resize(blockCount);
+
+        std::vector<size_t> blocks(blockCount);
+        for (size_t block = 0; block < blockCount; block++) {
+            std::copy_n(data.begin() + sizeof(u64) * 2 + block * sizeof(Hash), sizeof(Hash), leaves[block].begin());
+            blocks[block] = block;
+        }
+
+        index.updateParents(std::move(blocks));
+
+        return index;
+    }
+
+}
@@ -0,0 +1,71 @@
+#include <hex/helpers/block_value_counts.hpp>
+
+#include <algorithm>
+
+namespace hex {
+
+    BlockValueCounts::BlockValueCounts(Region region, u64 blockSize) : m_region(region), m_blockSize(blockSize) {
+        if (blockSize > 0)
+            this->m_blocks.resize((region.getSize() + blockSize - 1) / blockSize);
+    }
+
+    void BlockValueCounts::setBlock(u64 address, const Counts &counts) {
+        auto &previousCounts = this->m_blocks[(address - this->m_region.getStartAddress()) / this->m_blockSize];
+
+        for (u32 value = 0; value < counts.size(); value++) {
+            this->m_totals[value] = this->m_totals[value] - previousCounts[value] + counts[value];
+            previousCounts[value] = u32(counts[value]);
+        }
+    }
+
+    bool BlockValueCounts::setBlocks(std::vector<BlockCounts> blocks) {
+        if (blocks.size() != this->m_blocks.size())
+            return false;
+
+        this->m_blocks = std::move(blocks);
+
+        this->m_totals = { };
+        for (const auto &block : this->m_blocks) {
+            for (u32 value = 0; value < block.size(); value++)
+                this->m_totals[value] += block[value];
+        }
+
+        return true;
+    }
+
+    std::vector<Region> BlockValueCounts::getModifiedBlocks(std::span<const Region> modifications) const {
+        if (this->m_blocks.empty())
+            return { };
+
+        const u64 regionStart = this->m_region.getStartAddress();
+
+        std::vector<std::pair<u64, u64>> blockRanges;
+        for (const auto &modification : modifications) {
+            if (modification.getSize() == 0 || !modification.overlaps(this->m_region))
+                continue;
+
+            const u64 startAddress = std::max(modification.getStartAddress(), regionStart);
+            const u64 endAddress   = std::min(modification.getEndAddress(), this->m_region.getEndAddress());
+
+            blockRanges.emplace_back((startAddress - regionStart) / this->m_blockSize, (endAddress - regionStart) / this->m_blockSize);
+        }
+
+        std::sort(blockRanges.begin(), blockRanges.end());
+
+        // Merge overlapping and adjacent block ranges so every block gets counted only once
+        std::vector<Region> result;
+        for (auto it = blockRanges.begin(); it != blockRanges.end();) {
+            auto [firstBlock, lastBlock] = *it;
+            for (++it; it != blockRanges.end() && it->first <= lastBlock + 1; ++it)
+                lastBlock = std::max(lastBlock, it->second);
+
+            const u64 startOffset = firstBlock * this->m_blockSize;
+            const u64 endOffset   = std::min<u64>((lastBlock + 1) * this->m_blockSize, this->m_region.getSize());
+
+            result.push_back({ regionStart + startOffset, endOffset - startOffset });
+        }
+
+        return result;
+    }
+
+}
@@ -0,0 +1,254 @@
+#include <hex/helpers/byte_pattern.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define BYTE_PATTERN_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+namespace hex {
+
+    BytePattern::BytePattern(std::span<const u8> sequence) {
+        std::vector<Byte> bytes;
+        bytes.reserve(sequence.size());
+        for (u8 byte : sequence)
+            bytes.push_back({ 0xFF, byte });
+
+        *this = BytePattern(bytes);
+    }
+
+    BytePattern::BytePattern(std::span<const Byte> bytes) : m_size(bytes.size()) {
+        this->m_masks.reserve(bytes.size());
+        this->m_values.reserve(bytes.size());
+
+        for (const auto &[mask, value] : bytes) {
+            this->m_masks.push_back(mask);
+            this->m_values.push_back(value & mask);
+        }
+
+        auto isAnchor = [](const Byte &byte) { return byte.mask != 0x00; };
+
+        auto first = std::find_if(bytes.begin(), bytes.end(), isAnchor);
+        auto last  = std::find_if(bytes.rbegin(), bytes.rend(), isAnchor);
+
+        this->m_matchesEverything = first == bytes.end();
+        if (!this->m_matchesEverything) {
+            this->m_firstAnchor = std::distance(bytes.begin(), first);
+            this->m_lastAnchor  = std::distance(last, bytes.rend()) - 1;
+        }
+    }
+
+    std::optional<size_t> BytePattern::find(std::span<const u8> data, size_t offset) const {
+        return this->find(getBestImplementation(), data, offset);
+    }
+
+    std::optional<size_t> BytePattern::find(Implementation implementation, std::span<const u8> data, size_t offset) const {
+        if (this->m_size == 0 || data.size() < this->m_size || offset > data.size() - this->m_size)
+            return std::nullopt;
+
+        if (this->m_matchesEverything)
+            return offset;
+
+        if (!isSupported(implementation))
+            implementation = Implementation::Scalar;
+
+        switch (implementation) {
+            using enum Implementation;
+
+            case AVX2:  return this->findAVX2(data, offset);
+            case SSE2:  return this->findSSE2(data, offset);
+            default:    return this->findScalar(data, offset);
+        }
+    }
+
+    std::optional<size_t> BytePattern::findLast(std::span<const u8> data) const {
+        if (this->m_size == 0 || data.size() < this->m_size)
+            return std::nullopt;
+
+        if (this->m_matchesEverything)
+            return data.size() - this->m_size;
+
+        // Walk backwards through the data one window at a time and search each window using the vectorized forward search.
+        // The first window from the end that contains an occurrence holds the last one, so the rest of the data never gets looked at
+        constexpr static size_t WindowSize = 0x1'0000;
+
+        size_t windowEnd = data.size() - this->m_size + 1;
+        while (windowEnd > 0) {
+            const size_t windowStart = windowEnd > WindowSize ? windowEnd - WindowSize : 0;
+            const auto window = data.subspan(windowStart, (windowEnd - windowStart) + (this->m_size - 1));
+
+            std::optional<size_t> result;
+            for (auto occurrence = this->find(window); occurrence.has_value(); occurrence = this->find(window, *occurrence + 1))
+                result = occurrence;
+
+            if (result.has_value())
+                return windowStart + *result;
+
+            windowEnd = windowStart;
+        }
+
+        return std::nullopt;
+    }
+
+    bool BytePattern::isSupported(Implementation implementation) {
+        switch (implementation) {
+            using enum Implementation;
+
+            case Scalar:
+                return true;
+            #if defined(BYTE_PATTERN_X86_SIMD)
+                case SSE2:
+                    return __builtin_cpu_supports("sse2");
+                case AVX2:
+                    return __builtin_cpu_supports("avx2");
+            #endif
+            default:
+                return false;
+        }
+    }
+
+    BytePattern::Implementation BytePattern::getBestImplementation() {
+        static const auto implementation = [] {
+            using enum Implementation;
+
+            for (auto implementation : { AVX2, SSE2 }) {
+                if (isSupported(implementation))
+                    return implementation;
+            }
+
+            return Scalar;
+        }();
+
+        return implementation;
+    }
+
+    bool BytePattern::matchesAt(const u8 *data) const {
+        size_t i = 0;
+
+        // Compare eight bytes at once for as long as possible
+        for (; i + sizeof(u64) <= this->m_size; i += sizeof(u64)) {
+            u64 bytes, mask, value;
+            std::memcpy(&bytes, data + i, sizeof(u64));
+            std::memcpy(&mask,  this->m_masks.data() + i, sizeof(u64));
+            std::memcpy(&value, this->m_values.data() + i, sizeof(u64));
+
+            if ((bytes & mask) != value)
+                return false;
+        }
+
+        for (; i < this->m_size; i++) {
+            if ((data[i] & this->m_masks[i]) != this->m_values[i])
+                return false;
+        }
+
+        return true;
+    }
+
+    std::optional<size_t> BytePattern::findScalar(std::span<const u8> data, size_t offset) const {
+        const size_t lastStart = data.size() - this->m_size;
+
+        const u8 firstMask  = this->m_masks[this->m_firstAnchor],  firstValue = this->m_values[this->m_firstAnchor];
+        const u8 lastMask   = this->m_masks[this->m_lastAnchor],   lastValue  = this->m_values[this->m_lastAnchor];
+
+        for (size_t i = offset; i <= lastStart; i++) {
+            // memchr is vectorized by most C libraries, use it to skip ahead if the first anchor is an exact byte
+            if (firstMask == 0xFF) {
+                auto candidate = static_cast<const u8 *>(std::memchr(data.data() + i + this->m_firstAnchor, firstValue, lastStart - i + 1));
+                if (candidate == nullptr)
+                    break;
+
+                i = (candidate - data.data()) - this->m_firstAnchor;
+            } else if ((data[i + this->m_firstAnchor] & firstMask) != firstValue) {
+                continue;
+            }
+
+            if ((data[i + this->m_lastAnchor] & lastMask) != lastValue)
+                continue;
+
+            if (this->matchesAt(data.data() + i))
+                return i;
+        }
+
+        return std::nullopt;
+    }
+
+    #if defined(BYTE_PATTERN_X86_SIMD)
+
+        __attribute__((target("sse2")))
+        std::optional<size_t> BytePattern::findSSE2(std::span<const u8> data, size_t offset) const {
+            constexpr static size_t VectorSize = sizeof(__m128i);
+
+            const size_t lastStart = data.size() - this->m_size;
+
+            const auto firstMask  = _mm_set1_epi8(char(this->m_masks[this->m_firstAnchor]));
+            const auto firstValue = _mm_set1_epi8(char(this->m_values[this->m_firstAnchor]));
+            const auto lastMask   = _mm_set1_epi8(char(this->m_masks[this->m_lastAnchor]));
+            const auto lastValue  = _mm_set1_epi8(char(this->m_values[this->m_lastAnchor]));
+
+            size_t i = offset;
+            for (; i + VectorSize <= lastStart + 1; i += VectorSize) {
+                const auto first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data.data() + i + this->m_firstAnchor));
+                const auto last  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data.data() + i + this->m_lastAnchor));
+
+                const auto candidates = _mm_and_si128(
+                    _mm_cmpeq_epi8(_mm_and_si128(first, firstMask), firstValue),
+                    _mm_cmpeq_epi8(_mm_and_si128(last, lastMask), lastValue)
+                );
+
+                for (u32 bits = _mm_movemask_epi8(candidates); bits != 0; bits &= bits - 1) {
+                    const size_t position = i + std::countr_zero(bits);
+                    if (this->matchesAt(data.data() + position))
+                        return position;
+                }
+            }
+
+            return this->findScalar(data, i);
+        }
+
+        __attribute__((target("avx2")))
+        std::optional<size_t> BytePattern::findAVX2(std::span<const u8> data, size_t offset) const {
+            constexpr static size_t VectorSize = sizeof(__m256i);
+
+            const size_t lastStart = data.size() - this->m_size;
+
+            const auto firstMask  = _mm256_set1_epi8(char(this->m_masks[this->m_firstAnchor]));
+            const auto firstValue = _mm256_set1_epi8(char(this->m_values[this->m_firstAnchor]));
+            const auto lastMask   = _mm256_set1_epi8(char(this->m_masks[this->m_lastAnchor]));
+            const auto lastValue  = _mm256_set1_epi8(char(this->m_values[this->m_lastAnchor]));
+
+            size_t i = offset;
+            for (; i + VectorSize <= lastStart + 1; i += VectorSize) {
+                const auto first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data.data() + i + this->m_firstAnchor));
+                const auto last  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data.data() + i + this->m_lastAnchor));
+
+                const auto candidates = _mm256_and_si256(
+                    _mm256_cmpeq_epi8(_mm256_and_si256(first, firstMask), firstValue),
+                    _mm256_cmpeq_epi8(_mm256_and_si256(last, lastMask), lastValue)
+                );
+
+                for (u32 bits = _mm256_movemask_epi8(candidates); bits != 0; bits &= bits - 1) {
+                    const size_t position = i + std::countr_zero(bits);
+                    if (this->matchesAt(data.data() + position))
+                        return position;
+                }
+            }
+
+            return this->findSSE2(data, i);
+        }
+
+    #else
+
+        std::optional<size_t> BytePattern::findSSE2(std::span<const u8> data, size_t offset) const {
+            return this->findScalar(data, offset);
+        }
+
+        std::optional<size_t> BytePattern::findAVX2(std::span<const u8> data, size_t offset) const {
+            return this->findScalar(data, offset);
+        }
+
+    #endif
+
+}
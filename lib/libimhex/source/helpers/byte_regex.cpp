@@ -0,0 +1,687 @@
+#include <hex/helpers/byte_regex.hpp>
+
+#include <hex/helpers/fmt.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace hex {
+
+    namespace {
+
+        using ByteSet = std::bitset<256>;
+
+        constexpr static u32 Infinite   = std::numeric_limits<u32>::max();
+        constexpr static u32 MaxRepeats = 1000;
+
+        struct Node {
+            enum class Type {
+                Empty,
+                Bytes,
+                Concat,
+                Alternate,
+                Repeat
+            } type = Type::Empty;
+
+            ByteSet bytes = { };
+            std::vector<Node> children = { };
+            u32 min = 0, max = 0;
+        };
+
+        ByteSet makeRange(u8 from, u8 to) {
+            ByteSet result;
+            for (u32 byte = from; byte <= to; byte++)
+                result.set(byte);
+
+            return result;
+        }
+
+        ByteSet makeSet(std::string_view bytes) {
+            ByteSet result;
+            for (char byte : bytes)
+                result.set(u8(byte));
+
+            return result;
+        }
+
+        class Parser {
+        public:
+            explicit Parser(std::string_view pattern) : m_pattern(pattern) { }
+
+            std::expected<Node, std::string> parse() {
+                auto node = this->parseAlternation();
+                if (!node.has_value())
+                    return node;
+
+                if (!this->atEnd())
+                    return this->error("Unmatched ')'");
+
+                return node;
+            }
+
+        private:
+            [[nodiscard]] bool atEnd() const { return this->m_position >= this->m_pattern.size(); }
+            [[nodiscard]] char peek() const { return this->m_pattern[this->m_position]; }
+            char next() { return this->m_pattern[this->m_position++]; }
+
+            std::unexpected<std::string> error(const std::string &message) const {
+                return std::unexpected(hex::format("{} at position {}", message, this->m_position));
+            }
+
+            std::expected<Node, std::string> parseAlternation() {
+                Node node = { .type = Node::Type::Alternate };
+
+                while (true) {
+                    auto concat = this->parseConcatenation();
+                    if (!concat.has_value())
+                        return concat;
+
+                    node.children.push_back(std::move(*concat));
+
+                    if (this->atEnd() || this->peek() != '|')
+                        break;
+
+                    this->next();
+                }
+
+                if (node.children.size() == 1)
+                    return std::move(node.children.front());
+
+                return node;
+            }
+
+            std::expected<Node, std::string> parseConcatenation() {
+                Node node = { .type = Node::Type::Concat };
+
+                while (!this->atEnd() && this->peek() != '|' && this->peek() != ')') {
+                    auto atom = this->parseAtom();
+                    if (!atom.has_value())
+                        return atom;
+
+                    auto repeated = this->parseQuantifiers(std::move(*atom));
+                    if (!repeated.has_value())
+                        return repeated;
+
+                    node.children.push_back(std::move(*repeated));
+                }
+
+                if (node.children.empty())
+                    return Node { .type = Node::Type::Empty };
+                if (node.children.size() == 1)
+                    return std::move(node.children.front());
+
+                return node;
+            }
+
+            std::optional<u32> parseNumber() {
+                const auto start = this->m_position;
+
+                u32 value = 0;
+                while (!this->atEnd() && std::isdigit(u8(this->peek()))) {
+                    value = value * 10 + (this->next() - '0');
+                    if (value > MaxRepeats)
+                        return MaxRepeats + 1;
+                }
+
+                if (start == this->m_position)
+                    return std::nullopt;
+
+                return value;
+            }
+
+            std::expected<Node, std::string> parseQuantifiers(Node atom) {
+                while (!this->atEnd()) {
+                    u32 min, max;
+
+                    const auto quantifierStart = this->m_position;
+                    switch (this->peek()) {
+                        case '*': min = 0; max = Infinite; this->next(); break;
+                        case '+': min = 1; max = Infinite; this->next(); break;
+                        case '?': min = 0; max = 1;        this->next(); break;
+                        case '{': {
+                            this->next();
+
+                            auto lower = this->parseNumber();
+                            if (!lower.has_value()) {
+                                // Not a quantifier, treat the brace as a literal character
+                                this->m_position = quantifierStart;
+                                return atom;
+                            }
+
+                            min = max = *lower;
+                            if (!this->atEnd() && this->peek() == ',') {
+                                this->next();
+                                max = this->parseNumber().value_or(Infinite);
+                            }
+
+                            if (this->atEnd() || this->next() != '}')
+                                return this->error("Expected '}'");
+                            if ((min > MaxRepeats) || (max != Infinite && max > MaxRepeats))
+                                return this->error(hex::format("Repetition count larger than {}", MaxRepeats));
+                            if (max < min)
+                                return this->error("Invalid repetition range");
+
+                            break;
+                        }
+                        default:
+                            return atom;
+                    }
+
+                    if (!this->atEnd() && (this->peek() == '?' || this->peek() == '+'))
+                        return this->error("Lazy and possessive quantifiers are not supported");
+
+                    Node repeat = { .type = Node::Type::Repeat, .min = min, .max = max };
+                    repeat.children.push_back(std::move(atom));
+                    atom = std::move(repeat);
+                }
+
+                return atom;
+            }
+
+            std::expected<Node, std::string> parseAtom() {
+                const char c = this->next();
+
+                switch (c) {
+                    case '(': {
+                        if (!this->atEnd() && this->peek() == '?') {
+                            this->next();
+                            if (this->atEnd() || this->next() != ':')
+                                return this->error("Only non-capturing groups (?:...) are supported");
+                        }
+
+                        auto node = this->parseAlternation();
+                        if (!node.has_value())
+                            return node;
+
+                        if (this->atEnd() || this->next() != ')')
+                            return this->error("Missing ')'");
+
+                        return node;
+                    }
+                    case '[':
+                        return this->parseClass();
+                    case '.':
+                        return Node { .type = Node::Type::Bytes, .bytes = ByteSet().set() };
+                    case '\\': {
+                        auto bytes = this->parseEscape();
+                        if (!bytes.has_value())
+                            return std::unexpected(bytes.error());
+
+                        return Node { .type = Node::Type::Bytes, .bytes = *bytes };
+                    }
+                    case '*':
+                    case '+':
+                    case '?':
+                        return this->error("Nothing to repeat");
+                    case '^':
+                    case '$':
+                        return this->error("Anchors are not supported");
+                    default:
+                        return Node { .type = Node::Type::Bytes, .bytes = ByteSet().set(u8(c)) };
+                }
+            }
+
+            std::expected<ByteSet, std::string> parseEscape() {
+                if (this->atEnd())
+                    return this->error("Incomplete escape sequence");
+
+                const char c = this->next();
+                switch (c) {
+                    case 'n': return ByteSet().set('\n');
+                    case 'r': return ByteSet().set('\r');
+                    case 't': return ByteSet().set('\t');
+                    case 'f': return ByteSet().set('\f');
+                    case 'v': return ByteSet().set('\v');
+                    case '0': return ByteSet().set(0x00);
+                    case 'd': return makeRange('0', '9');
+                    case 'D': return ~makeRange('0', '9');
+                    case 'w': return makeRange('a', 'z') | makeRange('A', 'Z') | makeRange('0', '9') | makeSet("_");
+                    case 'W': return ~(makeRange('a', 'z') | makeRange('A', 'Z') | makeRange('0', '9') | makeSet("_"));
+                    case 's': return makeSet(" \t\n\r\f\v");
+                    case 'S': return ~makeSet(" \t\n\r\f\v");
+                    case 'x': {
+                        u32 value = 0;
+                        for (u32 i = 0; i < 2; i++) {
+                            if (this->atEnd() || !std::isxdigit(u8(this->peek())))
+                                return this->error("Expected two hexadecimal digits after \\x");
+
+                            const char digit = this->next();
+                            value = (value << 4) | (std::isdigit(u8(digit)) ? digit - '0' : (std::tolower(u8(digit)) - 'a' + 10));
+                        }
+
+                        return ByteSet().set(value);
+                    }
+                    default:
+                        if (std::isalnum(u8(c)))
+                            return this->error(hex::format("Unsupported escape sequence \\{}", c));
+
+                        return ByteSet().set(u8(c));
+                }
+            }
+
+            std::expected<Node, std::string> parseClass() {
+                ByteSet bytes;
+
+                bool negated = false;
+                if (!this->atEnd() && this->peek() == '^') {
+                    negated = true;
+                    this->next();
+                }
+
+                bool first = true;
+                while (true) {
+                    if (this->atEnd())
+                        return this->error("Missing ']'");
+
+                    if (this->peek() == ']' && !first) {
+                        this->next();
+                        break;
+                    }
+
+                    first = false;
+
+                    auto parseSingle = [this]() -> std::expected<ByteSet, std::string> {
+                        const char c = this->next();
+                        if (c == '\\')
+                            return this->parseEscape();
+                        else
+                            return ByteSet().set(u8(c));
+                    };
+
+                    auto from = parseSingle();
+                    if (!from.has_value())
+                        return std::unexpected(from.error());
+
+                    // Ranges are only possible between two single bytes
+                    const bool isRange = from->count() == 1 && this->m_position + 1 < this->m_pattern.size() && this->peek() == '-' && this->m_pattern[this->m_position + 1] != ']';
+                    if (!isRange) {
+                        bytes |= *from;
+                        continue;
+                    }
+
+                    this->next();
+
+                    auto to = parseSingle();
+                    if (!to.has_value())
+                        return std::unexpected(to.error());
+                    if (to->count() != 1)
+                        return this->error("Invalid range in character class");
+
+                    u32 fromByte = 0, toByte = 0;
+                    while (!from->test(fromByte)) fromByte++;
+                    while (!to->test(toByte)) toByte++;
+
+                    if (toByte < fromByte)
+                        return this->error("Invalid range in character class");
+
+                    bytes |= makeRange(fromByte, toByte);
+                }
+
+                if (negated)
+                    bytes.flip();
+
+                return Node { .type = Node::Type::Bytes, .bytes = bytes };
+            }
+
+        private:
+            std::string_view m_pattern;
+            size_t m_position = 0;
+        };
+
+        /**
+         * @brief Turns every single byte the node matches into a 16 bit code unit
+         * @param node Node to transform
+         * @param encoding UTF-16 encoding to use
+         */
+        void widenCharacters(Node &node, ByteRegex::Encoding encoding) {
+            if (node.type != Node::Type::Bytes) {
+                for (auto &child : node.children)
+                    widenCharacters(child, encoding);
+
+                return;
+            }
+
+            // Only '.' matches code units outside of the byte range
+            Node low  = { .type = Node::Type::Bytes, .bytes = node.bytes };
+            Node high = { .type = Node::Type::Bytes, .bytes = node.bytes.all() ? ByteSet().set() : ByteSet().set(0x00) };
+
+            node = { .type = Node::Type::Concat };
+            if (encoding == ByteRegex::Encoding::UTF16LE) {
+                node.children.push_back(std::move(low));
+                node.children.push_back(std::move(high));
+            } else {
+                node.children.push_back(std::move(high));
+                node.children.push_back(std::move(low));
+            }
+        }
+
+        class Compiler {
+        public:
+            using Instruction = ByteRegex::Instruction;
+
+            std::expected<std::vector<Instruction>, std::string> compile(const Node &node) {
+                if (!this->emit(node))
+                    return std::unexpected(hex::format("Pattern is too large, it may not compile to more than {} instructions", ByteRegex::MaxProgramSize));
+
+                this->m_program.push_back({ .type = Instruction::Type::Match });
+
+                return std::move(this->m_program);
+            }
+
+        private:
+            u32 add(Instruction instruction) {
+                this->m_program.push_back(instruction);
+                return this->m_program.size() - 1;
+            }
+
+            [[nodiscard]] u32 next() const {
+                return this->m_program.size();
+            }
+
+            bool emit(const Node &node) {
+                if (this->m_program.size() > ByteRegex::MaxProgramSize)
+                    return false;
+
+                switch (node.type) {
+                    using enum Node::Type;
+
+                    case Empty:
+                        return true;
+                    case Bytes:
+                        this->add({ .type = Instruction::Type::Bytes, .bytes = node.bytes });
+                        return true;
+                    case Concat:
+                        return std::all_of(node.children.begin(), node.children.end(), [this](const Node &child) { return this->emit(child); });
+                    case Alternate: {
+                        std::vector<u32> jumps;
+                        for (size_t i = 0; i < node.children.size() - 1; i++) {
+                            const auto split = this->add({ .type = Instruction::Type::Split });
+                            this->m_program[split].first = this->next();
+                            if (!this->emit(node.children[i]))
+                                return false;
+
+                            jumps.push_back(this->add({ .type = Instruction::Type::Jump }));
+                            this->m_program[split].second = this->next();
+                        }
+
+                        if (!this->emit(node.children.back()))
+                            return false;
+
+                        for (auto jump : jumps)
+                            this->m_program[jump].first = this->next();
+
+                        return true;
+                    }
+                    case Repeat: {
+                        const auto &child = node.children.front();
+
+                        for (u32 i = 0; i < node.min; i++) {
+                            if (!this->emit(child))
+                                return false;
+                        }
+
+                        if (node.max == Infinite) {
+                            const auto split = this->add({ .type = Instruction::Type::Split });
+                            this->m_program[split].first = this->next();
+                            if (!this->emit(child))
+                                return false;
+
+                            this->add({ .type = Instruction::Type::Jump, .first = split });
+                            this->m_program[split].second = this->next();
+                        } else {
+                            std::vector<u32> splits;
+                            for (u32 i = node.min; i < node.max; i++) {
+                                splits.push_back(this->add({ .type = Instruction::Type::Split }));
+                                this->m_program[splits.back()].first = this->next();
+                                if (!this->emit(child))
+                                    return false;
+                            }
+
+                            for (auto split : splits)
+                                this->m_program[split].second = this->next();
+                        }
+
+                        return this->m_program.size() <= ByteRegex::MaxProgramSize;
+                    }
+                }
+
+                return false;
+            }
+
+        private:
+            std::vector<Instruction> m_program;
+        };
+
+    }
+
+    std::expected<ByteRegex, std::string> ByteRegex::compile(std::string_view pattern, Encoding encoding) {
+        auto node = Parser(pattern).parse();
+        if (!node.has_value())
+            return std::unexpected(node.error());
+
+        if (encoding != Encoding::Bytes)
+            widenCharacters(*node, encoding);
+
+        auto program = Compiler().compile(*node);
+        if (!program.has_value())
+            return std::unexpected(program.error());
+
+        ByteRegex regex;
+        regex.m_program = std::move(*program);
+        regex.m_start   = 0;
+
+        return regex;
+    }
+
+
+    ByteRegex::Matcher::Matcher(const ByteRegex &regex, u64 address, Callback callback) : m_regex(regex), m_callback(std::move(callback)) {
+        this->m_visited.resize(regex.getProgram().size());
+        this->clearCache();
+        this->restart(address);
+    }
+
+    void ByteRegex::Matcher::feed(std::span<const u8> data) {
+        while (!data.empty() || !this->m_rescan.empty()) {
+            // Bytes following a reported match have to be searched again before any new data
+            if (!this->m_rescan.empty()) {
+                auto rescan = std::exchange(this->m_rescan, { });
+
+                const auto consumed = this->run(rescan);
+                this->m_rescan.insert(this->m_rescan.end(), rescan.begin() + consumed, rescan.end());
+
+                continue;
+            }
+
+            data = data.subspan(this->run(data));
+        }
+    }
+
+    void ByteRegex::Matcher::finish() {
+        while (this->m_candidate.has_value()) {
+            this->reportCandidate();
+            this->feed({ });
+        }
+    }
+
+    size_t ByteRegex::Matcher::run(std::span<const u8> data) {
+        for (size_t i = 0; i < data.size(); i++) {
+            if (this->consume(data[i]))
+                return i + 1;
+        }
+
+        return data.size();
+    }
+
+    bool ByteRegex::Matcher::consume(u8 byte) {
+        const auto &transition = this->getTransition(byte);
+
+        this->m_nextStarts.resize(transition.sources.size());
+        for (size_t i = 0; i < transition.sources.size(); i++) {
+            const auto source = transition.sources[i];
+            this->m_nextStarts[i] = source < 0 ? this->m_address + 1 : this->m_starts[source];
+        }
+
+        std::swap(this->m_starts, this->m_nextStarts);
+        this->m_currState = transition.target;
+        this->m_address += 1;
+
+        if (this->m_candidate.has_value())
+            this->m_pending.push_back(byte);
+
+        if (const auto firstMatch = this->m_states[this->m_currState].firstMatch; firstMatch >= 0) {
+            const u64 start = this->m_starts[firstMatch];
+
+            if (!this->m_candidate.has_value() || start <= this->m_candidate->getStartAddress()) {
+                this->m_candidate = Region { start, this->m_address - start };
+                this->m_pending.clear();
+
+                // Threads that started after the match can never lead to a match further to the left anymore
+                const auto &state = this->m_states[this->m_currState];
+                const auto keptThreads = std::upper_bound(this->m_starts.begin(), this->m_starts.end(), start) - this->m_starts.begin();
+                if (state.acceptsNewThreads || size_t(keptThreads) != state.threads.size()) {
+                    std::vector<u32> threads(state.threads.begin(), state.threads.begin() + keptThreads);
+
+                    this->m_starts.resize(keptThreads);
+                    this->m_currState = this->getState(std::move(threads), false);
+                }
+            }
+        }
+
+        if (this->m_candidate.has_value() && this->m_states[this->m_currState].threads.empty()) {
+            this->reportCandidate();
+            return true;
+        }
+
+        return false;
+    }
+
+    void ByteRegex::Matcher::reportCandidate() {
+        const auto match = *this->m_candidate;
+        this->m_candidate.reset();
+
+        this->m_callback(match);
+
+        // Continue searching right after the match
+        this->m_rescan = std::exchange(this->m_pending, { });
+        this->restart(match.getEndAddress() + 1);
+    }
+
+    void ByteRegex::Matcher::restart(u64 address) {
+        this->m_address   = address;
+        this->m_currState = this->m_initialState;
+        this->m_starts.assign(this->m_states[this->m_initialState].threads.size(), address);
+    }
+
+    void ByteRegex::Matcher::addThread(std::vector<u32> &threads, u32 pc, bool allowMatch) {
+        const auto &program = this->m_regex.getProgram();
+
+        std::vector<u32> stack = { pc };
+        while (!stack.empty()) {
+            const auto curr = stack.back();
+            stack.pop_back();
+
+            if (this->m_visited[curr] == this->m_visitGeneration)
+                continue;
+            this->m_visited[curr] = this->m_visitGeneration;
+
+            const auto &instruction = program[curr];
+            switch (instruction.type) {
+                using enum Instruction::Type;
+
+                case Bytes:
+                    threads.push_back(curr);
+                    break;
+                case Match:
+                    if (allowMatch)
+                        threads.push_back(curr);
+                    break;
+                case Jump:
+                    stack.push_back(instruction.first);
+                    break;
+                case Split:
+                    stack.push_back(instruction.second);
+                    stack.push_back(instruction.first);
+                    break;
+            }
+        }
+    }
+
+    u32 ByteRegex::Matcher::getState(std::vector<u32> threads, bool acceptsNewThreads) {
+        auto key = std::make_pair(acceptsNewThreads, std::move(threads));
+        if (auto it = this->m_stateLookup.find(key); it != this->m_stateLookup.end())
+            return it->second;
+
+        State state = { .threads = key.second, .acceptsNewThreads = acceptsNewThreads };
+        state.transitions.fill(-1);
+
+        const auto &program = this->m_regex.getProgram();
+        auto firstMatch = std::find_if(state.threads.begin(), state.threads.end(), [&](u32 pc) { return program[pc].type == Instruction::Type::Match; });
+        if (firstMatch != state.threads.end())
+            state.firstMatch = firstMatch - state.threads.begin();
+
+        this->m_states.push_back(std::move(state));
+        this->m_stateLookup.emplace(std::move(key), this->m_states.size() - 1);
+
+        return this->m_states.size() - 1;
+    }
+
+    void ByteRegex::Matcher::clearCache() {
+        std::optional<std::pair<std::vector<u32>, bool>> currState;
+        if (!this->m_states.empty())
+            currState = { this->m_states[this->m_currState].threads, this->m_states[this->m_currState].acceptsNewThreads };
+
+        this->m_states.clear();
+        this->m_transitions.clear();
+        this->m_stateLookup.clear();
+
+        std::vector<u32> initialThreads;
+        this->m_visitGeneration++;
+        this->addThread(initialThreads, this->m_regex.getStart(), false);
+        this->m_initialState = this->getState(std::move(initialThreads), true);
+
+        if (currState.has_value())
+            this->m_currState = this->getState(std::move(currState->first), currState->second);
+        else
+            this->m_currState = this->m_initialState;
+    }
+
+    const ByteRegex::Matcher::Transition &ByteRegex::Matcher::getTransition(u8 byte) {
+        if (auto index = this->m_states[this->m_currState].transitions[byte]; index >= 0)
+            return this->m_transitions[index];
+
+        // Start over with an empty cache if the DFA grows too large. The threads of the current state are kept in the same order
+        if (this->m_states.size() >= MaxCachedStates)
+            this->clearCache();
+
+        const auto &program = this->m_regex.getProgram();
+        const auto &state = this->m_states[this->m_currState];
+
+        std::vector<u32> threads;
+        std::vector<i32> sources;
+
+        this->m_visitGeneration++;
+        for (size_t i = 0; i < state.threads.size(); i++) {
+            const auto &instruction = program[state.threads[i]];
+            if (instruction.type != Instruction::Type::Bytes || !instruction.bytes.test(byte))
+                continue;
+
+            this->addThread(threads, state.threads[i] + 1, true);
+            sources.resize(threads.size(), i32(i));
+        }
+
+        const bool acceptsNewThreads = state.acceptsNewThreads;
+        if (acceptsNewThreads) {
+            this->addThread(threads, this->m_regex.getStart(), false);
+            sources.resize(threads.size(), -1);
+        }
+
+        const auto target = this->getState(std::move(threads), acceptsNewThreads);
+
+        this->m_transitions.push_back({ target, std::move(sources) });
+        this->m_states[this->m_currState].transitions[byte] = this->m_transitions.size() - 1;
+
+        return this->m_transitions.back();
+    }
+
+}
@@ -0,0 +1,376 @@
+#include <hex/helpers/code_analysis.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <unordered_set>
+
+namespace hex {
+
+    namespace {
+
+        // Number of functions each subtask analyzes with the same decoder
+        constexpr static u64 FunctionsPerChunk = 16;
+
+        // Amount of code the capstone decoder reads from the provider at once
+        constexpr static u64 DecoderWindowSize = 0x1000;
+
+        struct DecodedInstruction {
+            u64 address;
+            u8 size;
+            CodeAnalysis::FlowType flow;
+        };
+
+        struct FunctionAnalysis {
+            std::vector<DecodedInstruction> instructions;
+            std::vector<CodeAnalysis::Reference> references;
+            std::vector<u64> calledFunctions;
+        };
+
+        FunctionAnalysis analyzeFunction(const CodeAnalysis::Decoder &decoder, u64 entryPoint) {
+            using FlowType = CodeAnalysis::FlowType;
+            using ReferenceType = CodeAnalysis::ReferenceType;
+
+            FunctionAnalysis result;
+
+            std::unordered_set<u64> visited;
+            std::vector<u64> pending = { entryPoint };
+            while (!pending.empty()) {
+                u64 address = pending.back();
+                pending.pop_back();
+
+                // Follow the instructions linearly until control flow can't continue with the next one
+                bool continueLinearly = true;
+                while (continueLinearly && visited.insert(address).second) {
+                    auto instruction = decoder(address);
+                    if (!instruction.has_value())
+                        break;
+
+                    result.instructions.push_back({ address, instruction->size, instruction->flow });
+                    for (auto dataAddress : instruction->dataReferences)
+                        result.references.push_back({ address, dataAddress, ReferenceType::Data });
+
+                    const auto &target = instruction->branchTarget;
+                    switch (instruction->flow) {
+                        case FlowType::Normal:
+                            break;
+                        case FlowType::Call:
+                            if (target.has_value()) {
+                                result.references.push_back({ address, *target, ReferenceType::Call });
+                                result.calledFunctions.push_back(*target);
+                            }
+                            break;
+                        case FlowType::Jump:
+                            if (target.has_value()) {
+                                result.references.push_back({ address, *target, ReferenceType::Jump });
+                                pending.push_back(*target);
+                            }
+                            continueLinearly = false;
+                            break;
+                        case FlowType::ConditionalJump:
+                            if (target.has_value()) {
+                                result.references.push_back({ address, *target, ReferenceType::ConditionalJump });
+                                pending.push_back(*target);
+                            }
+                            break;
+                        case FlowType::Return:
+                            continueLinearly = false;
+                            break;
+                    }
+
+                    address += instruction->size;
+                }
+            }
+
+            return result;
+        }
+
+        bool endsBasicBlock(CodeAnalysis::FlowType flow) {
+            using enum CodeAnalysis::FlowType;
+
+            return flow == Jump || flow == ConditionalJump || flow == Return;
+        }
+
+    }
+
+    CodeAnalysis CodeAnalysis::analyze(Task &task, const std::function<Decoder()> &createDecoder, const std::vector<u64> &entryPoints) {
+        CodeAnalysis result;
+
+        std::set<u64> knownFunctions(entryPoints.begin(), entryPoints.end());
+        std::vector<u64> pendingFunctions(knownFunctions.begin(), knownFunctions.end());
+
+        std::vector<DecodedInstruction> instructions;
+        std::vector<Reference> references;
+
+        // Analyze all functions known so far in parallel. Functions called by them get analyzed in the next round
+        while (!pendingFunctions.empty()) {
+            std::vector<FunctionAnalysis> functions(pendingFunctions.size());
+
+            task.parallelFor({ 0, pendingFunctions.size() }, FunctionsPerChunk, [&](Task &subtask, Region chunk) {
+                auto decoder = createDecoder();
+
+                for (u64 i = chunk.getStartAddress(); i <= chunk.getEndAddress(); i++) {
+                    subtask.update(i - chunk.getStartAddress());
+                    functions[i] = analyzeFunction(decoder, pendingFunctions[i]);
+                }
+            });
+
+            std::vector<u64> calledFunctions;
+            for (u64 i = 0; i < functions.size(); i++) {
+                auto &function = functions[i];
+                if (!function.instructions.empty())
+                    result.m_functions.push_back(pendingFunctions[i]);
+
+                std::move(function.instructions.begin(), function.instructions.end(), std::back_inserter(instructions));
+                std::move(function.references.begin(), function.references.end(), std::back_inserter(references));
+
+                for (auto calledFunction : function.calledFunctions) {
+                    if (knownFunctions.insert(calledFunction).second)
+                        calledFunctions.push_back(calledFunction);
+                }
+            }
+
+            pendingFunctions = std::move(calledFunctions);
+        }
+
+        std::ranges::sort(result.m_functions);
+
+        // Code reachable from multiple functions got decoded once per function
+        std::ranges::sort(instructions, {}, &DecodedInstruction::address);
+        auto duplicateInstructions = std::ranges::unique(instructions, {}, &DecodedInstruction::address);
+        instructions.erase(duplicateInstructions.begin(), duplicateInstructions.end());
+
+        // Every function entry and branch target starts a new basic block
+        std::vector<u64> leaders = result.m_functions;
+        for (const auto &reference : references) {
+            if (reference.type == ReferenceType::Jump || reference.type == ReferenceType::ConditionalJump)
+                leaders.push_back(reference.to);
+        }
+        std::ranges::sort(leaders);
+
+        u64 prevAddress = 0, prevEnd = 0;
+        FlowType prevFlow = FlowType::Normal;
+        for (const auto &instruction : instructions) {
+            // Instructions starting in the middle of another one can't be part of the same block structure
+            if (!result.m_basicBlocks.empty() && instruction.address < prevEnd)
+                continue;
+
+            const bool contiguous = !result.m_basicBlocks.empty() && instruction.address == prevEnd;
+            const bool isLeader   = std::ranges::binary_search(leaders, instruction.address);
+
+            if (!contiguous || isLeader || endsBasicBlock(prevFlow)) {
+                if (contiguous && prevFlow != FlowType::Jump && prevFlow != FlowType::Return)
+                    references.push_back({ prevAddress, instruction.address, ReferenceType::FallThrough });
+
+                result.m_basicBlocks.push_back({ instruction.address, instruction.size, 1 });
+            } else {
+                auto &block = result.m_basicBlocks.back();
+                block.size += instruction.size;
+                block.instructionCount += 1;
+            }
+
+            prevAddress = instruction.address;
+            prevEnd     = instruction.address + instruction.size;
+            prevFlow    = instruction.flow;
+        }
+
+        std::ranges::sort(references, [](const Reference &left, const Reference &right) {
+            return std::tie(left.to, left.from, left.type) < std::tie(right.to, right.from, right.type);
+        });
+        auto duplicateReferences = std::ranges::unique(references);
+        references.erase(duplicateReferences.begin(), duplicateReferences.end());
+
+        result.m_references = std::move(references);
+
+        return result;
+    }
+
+    std::span<const CodeAnalysis::Reference> CodeAnalysis::getReferencesTo(u64 address) const {
+        auto [begin, end] = std::ranges::equal_range(this->m_references, address, {}, &Reference::to);
+
+        return { begin, end };
+    }
+
+    const CodeAnalysis::BasicBlock *CodeAnalysis::findBasicBlock(u64 address) const {
+        auto it = std::ranges::upper_bound(this->m_basicBlocks, address, {}, &BasicBlock::address);
+        if (it == this->m_basicBlocks.begin())
+            return nullptr;
+
+        --it;
+        if (address - it->address >= it->size)
+            return nullptr;
+
+        return &*it;
+    }
+
+    std::span<const CodeAnalysis::BasicBlock> CodeAnalysis::getBasicBlocks(Region region) const {
+        if (region.getSize() == 0)
+            return { };
+
+        auto begin = std::ranges::upper_bound(this->m_basicBlocks, region.getStartAddress(), {}, &BasicBlock::address);
+        if (begin != this->m_basicBlocks.begin() && region.getStartAddress() - std::prev(begin)->address < std::prev(begin)->size)
+            --begin;
+
+        auto end = std::ranges::upper_bound(this->m_basicBlocks, region.getEndAddress(), {}, &BasicBlock::address);
+
+        return { begin, end };
+    }
+
+    namespace {
+
+        std::optional<CodeAnalysis::Instruction> convertInstruction(csh handle, Architecture architecture, cs_mode mode, const cs_insn &instruction, u64 baseAddress, u64 codeSize) {
+            using enum CodeAnalysis::FlowType;
+
+            const auto isInCode = [&](u64 address) { return address >= baseAddress && address - baseAddress < codeSize; };
+
+            bool isCall   = cs_insn_group(handle, &instruction, CS_GRP_CALL);
+            bool isJump   = cs_insn_group(handle, &instruction, CS_GRP_JUMP);
+            bool isReturn = cs_insn_group(handle, &instruction, CS_GRP_RET) || cs_insn_group(handle, &instruction, CS_GRP_IRET);
+
+            // Without operand information, jumps are treated as conditional so the code following them still gets analyzed
+            bool isConditional = true;
+
+            std::vector<u64> immediates, memoryReferences;
+            switch (architecture) {
+                case Architecture::X86: {
+                    const auto &x86 = instruction.detail->x86;
+                    for (u8 i = 0; i < x86.op_count; i++) {
+                        const auto &operand = x86.operands[i];
+                        if (operand.type == X86_OP_IMM) {
+                            immediates.push_back(operand.imm);
+                        } else if (operand.type == X86_OP_MEM) {
+                            if (operand.mem.base == X86_REG_RIP)
+                                memoryReferences.push_back(instruction.address + instruction.size + operand.mem.disp);
+                            else if (operand.mem.base == X86_REG_INVALID && operand.mem.index == X86_REG_INVALID)
+                                memoryReferences.push_back(operand.mem.disp);
+                        }
+                    }
+
+                    isConditional = instruction.id != X86_INS_JMP && instruction.id != X86_INS_LJMP;
+                    break;
+                }
+                case Architecture::ARM: {
+                    const auto &arm = instruction.detail->arm;
+                    bool writesPc = false;
+                    for (u8 i = 0; i < arm.op_count; i++) {
+                        const auto &operand = arm.operands[i];
+                        if (operand.type == ARM_OP_IMM) {
+                            immediates.push_back(u32(operand.imm));
+                        } else if (operand.type == ARM_OP_MEM && operand.mem.base == ARM_REG_PC) {
+                            // The PC reads as the address of the current instruction plus two instructions, word aligned in Thumb mode
+                            const u64 pc = (mode & CS_MODE_THUMB) != 0 ? ((instruction.address + 4) & ~u64(3)) : instruction.address + 8;
+                            memoryReferences.push_back(pc + operand.mem.disp);
+                        } else if (operand.type == ARM_OP_REG && operand.reg == ARM_REG_PC && (operand.access & CS_AC_WRITE) != 0) {
+                            writesPc = true;
+                        }
+                    }
+
+                    // Loading the PC from memory or a register, e.g. pop {pc}, is a jump as well
+                    if (writesPc && !isCall)
+                        isJump = true;
+
+                    isConditional = arm.cc != ARM_CC_AL && arm.cc != ARM_CC_INVALID;
+                    break;
+                }
+                case Architecture::ARM64: {
+                    const auto &arm64 = instruction.detail->arm64;
+                    for (u8 i = 0; i < arm64.op_count; i++) {
+                        const auto &operand = arm64.operands[i];
+                        if (operand.type == ARM64_OP_IMM)
+                            immediates.push_back(operand.imm);
+                    }
+
+                    const bool comparesRegister = instruction.id == ARM64_INS_CBZ || instruction.id == ARM64_INS_CBNZ || instruction.id == ARM64_INS_TBZ || instruction.id == ARM64_INS_TBNZ;
+                    isConditional = comparesRegister || (arm64.cc != ARM64_CC_INVALID && arm64.cc != ARM64_CC_AL && arm64.cc != ARM64_CC_NV);
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            CodeAnalysis::Instruction result = { instruction.address, u8(instruction.size), Normal, std::nullopt, { } };
+
+            if (isReturn)
+                result.flow = Return;
+            else if (isCall)
+                result.flow = Call;
+            else if (isJump)
+                result.flow = isConditional ? ConditionalJump : Jump;
+
+            // The branch target is always the last immediate operand, e.g. tbz x0, #3, <target>
+            if ((isCall || isJump) && !immediates.empty()) {
+                result.branchTarget = immediates.back();
+                immediates.pop_back();
+            }
+
+            for (auto address : immediates) {
+                if (isInCode(address))
+                    result.dataReferences.push_back(address);
+            }
+
+            for (auto address : memoryReferences) {
+                if (isInCode(address))
+                    result.dataReferences.push_back(address);
+            }
+
+            return result;
+        }
+
+    }
+
+    CodeAnalysis::Decoder CodeAnalysis::createCapstoneDecoder(Architecture architecture, cs_mode mode, prv::Provider *provider, Region codeRegion, u64 baseAddress) {
+        struct State {
+            csh handle = 0;
+            cs_insn *instruction = nullptr;
+
+            // Window of the code read from the provider
+            std::vector<u8> buffer;
+            u64 bufferOffset = 0;
+
+            ~State() {
+                if (this->instruction != nullptr)
+                    cs_free(this->instruction, 1);
+                if (this->handle != 0)
+                    cs_close(&this->handle);
+            }
+        };
+
+        auto state = std::make_shared<State>();
+        if (cs_open(Disassembler::toCapstoneArchitecture(architecture), mode, &state->handle) != CS_ERR_OK) {
+            state->handle = 0;
+            return [](u64) -> std::optional<Instruction> { return std::nullopt; };
+        }
+
+        cs_option(state->handle, CS_OPT_DETAIL, CS_OPT_ON);
+        state->instruction = cs_malloc(state->handle);
+
+        return [=](u64 address) -> std::optional<Instruction> {
+            if (address < baseAddress || address - baseAddress >= codeRegion.getSize())
+                return std::nullopt;
+
+            const u64 offset    = address - baseAddress;
+            const u64 bufferEnd = state->bufferOffset + state->buffer.size();
+
+            // Read a new window if the instruction may extend past the end of the current one
+            if (offset < state->bufferOffset || offset >= bufferEnd || (offset + sizeof(cs_insn::bytes) > bufferEnd && bufferEnd < codeRegion.getSize())) {
+                state->bufferOffset = offset;
+                state->buffer.resize(std::min<u64>(DecoderWindowSize, codeRegion.getSize() - offset));
+                provider->read(codeRegion.getStartAddress() + offset, state->buffer.data(), state->buffer.size());
+            }
+
+            const u8 *code  = state->buffer.data() + (offset - state->bufferOffset);
+            size_t codeSize = state->buffer.size() - (offset - state->bufferOffset);
+            u64 instructionAddress = address;
+
+            if (!cs_disasm_iter(state->handle, &code, &codeSize, &instructionAddress, state->instruction))
+                return std::nullopt;
+
+            return convertInstruction(state->handle, architecture, mode, *state->instruction, baseAddress, codeRegion.getSize());
+        };
+    }
+
+}
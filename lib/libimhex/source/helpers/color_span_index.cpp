@@ -0,0 +1,89 @@
+#include <hex/helpers/color_span_index.hpp>
+
+#include <algorithm>
+#include <set>
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+namespace hex {
+
+    ColorSpanIndex::ColorSpanIndex(std::vector<Span> highlights) {
+        std::erase_if(highlights, [](const Span &highlight) { return highlight.region.getSize() == 0; });
+
+        // Most highlights, e.g. the members of consecutive structs, are already sorted and don't overlap
+        const bool disjoint = std::ranges::adjacent_find(highlights, [](const Span &left, const Span &right) {
+            return right.region.getStartAddress() <= left.region.getEndAddress();
+        }) == highlights.end();
+
+        if (disjoint) {
+            for (const auto &highlight : highlights)
+                this->append(highlight.region.getStartAddress(), highlight.region.getSize(), highlight.color);
+
+            return;
+        }
+
+        // Otherwise sweep over all start and end addresses, blending the colors of all highlights covering the part in between
+        struct Event {
+            u64 address;
+            bool isStart;
+            size_t index;
+        };
+
+        std::vector<Event> events;
+        events.reserve(highlights.size() * 2);
+        for (size_t i = 0; i < highlights.size(); i++) {
+            events.push_back({ highlights[i].region.getStartAddress(), true, i });
+            events.push_back({ highlights[i].region.getEndAddress() + 1, false, i });
+        }
+
+        std::ranges::sort(events, {}, &Event::address);
+
+        // Indices of the highlights covering the current address, in blending order
+        std::set<size_t> active;
+        for (size_t i = 0; i < events.size();) {
+            const u64 address = events[i].address;
+            for (; i < events.size() && events[i].address == address; i++) {
+                if (events[i].isStart)
+                    active.insert(events[i].index);
+                else
+                    active.erase(events[i].index);
+            }
+
+            if (active.empty() || i == events.size())
+                continue;
+
+            auto color = highlights[*active.begin()].color;
+            for (auto it = std::next(active.begin()); it != active.end(); ++it)
+                color = ImAlphaBlendColors(color, highlights[*it].color);
+
+            this->append(address, events[i].address - address, color);
+        }
+    }
+
+    void ColorSpanIndex::append(u64 address, u64 size, color_t color) {
+        if (!this->m_spans.empty()) {
+            auto &last = this->m_spans.back();
+            if (last.color == color && last.region.getEndAddress() + 1 == address) {
+                last.region.size += size;
+                return;
+            }
+        }
+
+        this->m_spans.push_back({ { address, size }, color });
+    }
+
+    std::span<const ColorSpanIndex::Span> ColorSpanIndex::find(const Region &region) const {
+        if (region.getSize() == 0)
+            return { };
+
+        auto begin = std::ranges::upper_bound(this->m_spans, region.getStartAddress(), {}, [](const Span &span) { return span.region.getStartAddress(); });
+        if (begin != this->m_spans.begin() && std::prev(begin)->region.getEndAddress() >= region.getStartAddress())
+            --begin;
+
+        auto end = std::ranges::upper_bound(begin, this->m_spans.end(), region.getEndAddress(), {}, [](const Span &span) { return span.region.getStartAddress(); });
+
+        return { begin, end };
+    }
+
+}
@@ -17,6 +17,7 @@
 #include <functional>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <bit>
 
 #if MBEDTLS_VERSION_MAJOR <= 2
@@ -42,9 +43,15 @@
 namespace hex::crypt {
     using namespace std::placeholders;
 
-    template<std::invocable<unsigned char *, size_t> Func>
+    template<std::invocable<const unsigned char *, size_t> Func>
     void processDataByChunks(prv::Provider *data, u64 offset, size_t size, Func func) {
-        std::array<u8, 512> buffer = { 0 };
+        // Process the data in place if the provider can give direct access to it
+        if (auto view = data->getDataView(offset, size); view.has_value()) {
+            func(view->data(), view->size());
+            return;
+        }
+
+        std::vector<u8> buffer(std::min<size_t>(size, 0x10'0000), 0x00);
         for (size_t bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
             const auto readSize = std::min(buffer.size(), size - bufferOffset);
             data->read(offset + bufferOffset, buffer.data(), readSize);
@@ -80,18 +87,32 @@ namespace hex::crypt {
         }
     }
 
-    template<size_t NumBits> requires (std::has_single_bit(NumBits))
+    // Reverses the bits of every byte in a 64 bit word
+    constexpr u64 reflectBytes(u64 in) {
+        in = ((in & 0xF0F0F0F0'F0F0F0F0ull) >> 4) | ((in & 0x0F0F0F0F'0F0F0F0Full) << 4);
+        in = ((in & 0xCCCCCCCC'CCCCCCCCull) >> 2) | ((in & 0x33333333'33333333ull) << 2);
+        in = ((in & 0xAAAAAAAA'AAAAAAAAull) >> 1) | ((in & 0x55555555'55555555ull) << 1);
+
+        return in;
+    }
+
+    template<size_t NumBits> requires (std::has_single_bit(NumBits) && NumBits <= 64)
     class Crc {
         // use reflected algorithm, so we reflect only if refin / refout is FALSE
         // mask values, 0b1 << 64 is UB, so use 0b10 << 63
 
+        // Data is processed using slicing-by-8. m_tables[0] is the regular byte table, m_tables[n][i] is the
+        // value of m_tables[0][i] after shifting another n zero bytes through the register. This way, eight bytes
+        // can be processed using eight independent table lookups instead of a chain of eight dependent ones
+        using Tables = std::array<std::array<u64, 256>, 8>;
+
     public:
         constexpr Crc(u64 polynomial, u64 init, u64 xorOut, bool reflectInput, bool reflectOutput)
             : m_value(0x00), m_init(init & ((0b10ull << (NumBits - 1)) - 1)), m_xorOut(xorOut & ((0b10ull << (NumBits - 1)) - 1)),
               m_reflectInput(reflectInput), m_reflectOutput(reflectOutput),
-              m_table([polynomial]() {
+              m_tables([polynomial]() {
                 auto reflectedPoly = reflect(polynomial & ((0b10ull << (NumBits - 1)) - 1), NumBits);
-                std::array<uint64_t, 256> table = { 0 };
+                Tables tables = { };
 
                 for (uint32_t i = 0; i < 256; i++) {
                     uint64_t c = i;
@@ -101,10 +122,15 @@ namespace hex::crypt {
                         else
                             c >>= 1;
                     }
-                    table[i] = c;
+                    tables[0][i] = c;
+                }
+
+                for (std::size_t n = 1; n < tables.size(); n++) {
+                    for (uint32_t i = 0; i < 256; i++)
+                        tables[n][i] = tables[0][tables[n - 1][i] & 0xFF] ^ (tables[n - 1][i] >> 8);
                 }
 
-                return table;
+                return tables;
          }()) {
             reset();
         };
@@ -114,6 +140,25 @@ namespace hex::crypt {
         }
 
         constexpr void processBytes(const unsigned char *data, std::size_t size) {
+            const auto &tables = this->m_tables;
+
+            // The register is at most 64 bits wide, so eight input bytes can be combined with it at once
+            for (; size >= 8; data += 8, size -= 8) {
+                u64 word = 0;
+                for (std::size_t i = 0; i < 8; i++)
+                    word |= u64(data[i]) << (i * 8);
+
+                if (!this->m_reflectInput)
+                    word = reflectBytes(word);
+
+                word ^= this->m_value;
+
+                this->m_value = tables[7][(word >>  0) & 0xFF] ^ tables[6][(word >>  8) & 0xFF] ^
+                                tables[5][(word >> 16) & 0xFF] ^ tables[4][(word >> 24) & 0xFF] ^
+                                tables[3][(word >> 32) & 0xFF] ^ tables[2][(word >> 40) & 0xFF] ^
+                                tables[1][(word >> 48) & 0xFF] ^ tables[0][(word >> 56) & 0xFF];
+            }
+
             for (std::size_t i = 0; i < size; i++) {
                 u8 byte;
                 if (this->m_reflectInput)
@@ -121,7 +166,7 @@ namespace hex::crypt {
                 else
                     byte = reflect(data[i]);
 
-                this->m_value = this->m_table[(this->m_value ^ byte) & 0xFFL] ^ (this->m_value >> 8);
+                this->m_value = tables[0][(this->m_value ^ byte) & 0xFFL] ^ (this->m_value >> 8);
             }
         }
 
@@ -141,7 +186,7 @@ namespace hex::crypt {
         bool m_reflectInput;
         bool m_reflectOutput;
 
-        std::array<uint64_t, 256> m_table;
+        Tables m_tables;
     };
 
     template<size_t NumBits>
@@ -360,6 +405,108 @@ namespace hex::crypt {
     }
 
 
+    namespace {
+
+        template<size_t NumBits>
+        class CrcHasher : public Hasher {
+        public:
+            CrcHasher(u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut)
+                : m_crc(polynomial, init, xorOut, reflectIn, reflectOut) { }
+
+            void update(std::span<const u8> data) override {
+                this->m_crc.processBytes(data.data(), data.size());
+            }
+
+            std::vector<u8> finish() override {
+                const u64 checksum = this->m_crc.checksum();
+
+                std::vector<u8> result(NumBits / 8, 0x00);
+                std::memcpy(result.data(), &checksum, result.size());
+
+                return result;
+            }
+
+        private:
+            Crc<NumBits> m_crc;
+        };
+
+        template<typename Context, size_t Size, auto Init, auto Starts, auto Update, auto Finish, auto Free>
+        class MbedTlsHasher : public Hasher {
+        public:
+            explicit MbedTlsHasher(auto ... startArguments) {
+                Init(&this->m_context);
+                Starts(&this->m_context, startArguments...);
+            }
+
+            MbedTlsHasher(const MbedTlsHasher &) = delete;
+            MbedTlsHasher &operator=(const MbedTlsHasher &) = delete;
+
+            ~MbedTlsHasher() override {
+                Free(&this->m_context);
+            }
+
+            void update(std::span<const u8> data) override {
+                Update(&this->m_context, data.data(), data.size());
+            }
+
+            std::vector<u8> finish() override {
+                std::vector<u8> result(Size, 0x00);
+                Finish(&this->m_context, result.data());
+
+                return result;
+            }
+
+        private:
+            Context m_context;
+        };
+
+        using MD5Hasher  = MbedTlsHasher<mbedtls_md5_context, 16, mbedtls_md5_init, mbedtls_md5_starts, mbedtls_md5_update, mbedtls_md5_finish, mbedtls_md5_free>;
+        using SHA1Hasher = MbedTlsHasher<mbedtls_sha1_context, 20, mbedtls_sha1_init, mbedtls_sha1_starts, mbedtls_sha1_update, mbedtls_sha1_finish, mbedtls_sha1_free>;
+
+        template<size_t Size>
+        using SHA256Hasher = MbedTlsHasher<mbedtls_sha256_context, Size, mbedtls_sha256_init, mbedtls_sha256_starts, mbedtls_sha256_update, mbedtls_sha256_finish, mbedtls_sha256_free>;
+        template<size_t Size>
+        using SHA512Hasher = MbedTlsHasher<mbedtls_sha512_context, Size, mbedtls_sha512_init, mbedtls_sha512_starts, mbedtls_sha512_update, mbedtls_sha512_finish, mbedtls_sha512_free>;
+
+    }
+
+    std::unique_ptr<Hasher> crc8Hasher(u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut) {
+        return std::make_unique<CrcHasher<8>>(polynomial, init, xorOut, reflectIn, reflectOut);
+    }
+
+    std::unique_ptr<Hasher> crc16Hasher(u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut) {
+        return std::make_unique<CrcHasher<16>>(polynomial, init, xorOut, reflectIn, reflectOut);
+    }
+
+    std::unique_ptr<Hasher> crc32Hasher(u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut) {
+        return std::make_unique<CrcHasher<32>>(polynomial, init, xorOut, reflectIn, reflectOut);
+    }
+
+    std::unique_ptr<Hasher> md5Hasher() {
+        return std::make_unique<MD5Hasher>();
+    }
+
+    std::unique_ptr<Hasher> sha1Hasher() {
+        return std::make_unique<SHA1Hasher>();
+    }
+
+    std::unique_ptr<Hasher> sha224Hasher() {
+        return std::make_unique<SHA256Hasher<28>>(true);
+    }
+
+    std::unique_ptr<Hasher> sha256Hasher() {
+        return std::make_unique<SHA256Hasher<32>>(false);
+    }
+
+    std::unique_ptr<Hasher> sha384Hasher() {
+        return std::make_unique<SHA512Hasher<48>>(true);
+    }
+
+    std::unique_ptr<Hasher> sha512Hasher() {
+        return std::make_unique<SHA512Hasher<64>>(false);
+    }
+
+
     std::vector<u8> decode64(const std::vector<u8> &input) {
 
         size_t written = 0;
@@ -5,6 +5,9 @@
 #include <wolv/io/file.hpp>
 #include <wolv/utils/string.hpp>
 
+#include <algorithm>
+#include <map>
+
 namespace hex {
 
     EncodingFile::EncodingFile(Type type, const std::fs::path &path) {
@@ -20,35 +23,46 @@ namespace hex {
         this->m_valid = true;
     }
 
-    std::pair<std::string_view, size_t> EncodingFile::getEncodingFor(std::span<u8> buffer) const {
-        for (auto riter = this->m_mapping.crbegin(); riter != this->m_mapping.crend(); ++riter) {
-            const auto &[size, mapping] = *riter;
+    std::optional<std::pair<u32, size_t>> EncodingFile::findLongestMatch(std::span<const u8> buffer) const {
+        if (this->m_nodes.empty())
+            return std::nullopt;
+
+        std::optional<std::pair<u32, size_t>> result;
 
-            if (size > buffer.size()) continue;
+        u32 nodeIndex = 0;
+        for (size_t i = 0; i < buffer.size(); i++) {
+            const auto &node = this->m_nodes[nodeIndex];
+            const auto edgesBegin = this->m_edges.begin() + node.edgesBegin, edgesEnd = this->m_edges.begin() + node.edgesEnd;
 
-            std::vector<u8> key(buffer.begin(), buffer.begin() + size);
-            if (mapping.contains(key))
-                return { mapping.at(key), size };
+            auto edge = std::lower_bound(edgesBegin, edgesEnd, buffer[i], [](const TrieEdge &edge, u8 byte) { return edge.byte < byte; });
+            if (edge == edgesEnd || edge->byte != buffer[i])
+                break;
+
+            nodeIndex = edge->node;
+            if (const auto &value = this->m_nodes[nodeIndex].value; value.has_value())
+                result = { *value, i + 1 };
         }
 
-        return { ".", 1 };
+        return result;
     }
 
-    size_t EncodingFile::getEncodingLengthFor(std::span<u8> buffer) const {
-        for (auto riter = this->m_mapping.crbegin(); riter != this->m_mapping.crend(); ++riter) {
-            const auto &[size, mapping] = *riter;
+    std::pair<std::string_view, size_t> EncodingFile::getEncodingFor(std::span<const u8> buffer) const {
+        if (auto match = this->findLongestMatch(buffer); match.has_value())
+            return { this->m_values[match->first], match->second };
 
-            if (size > buffer.size()) continue;
+        return { ".", 1 };
+    }
 
-            std::vector<u8> key(buffer.begin(), buffer.begin() + size);
-            if (mapping.contains(key))
-                return size;
-        }
+    size_t EncodingFile::getEncodingLengthFor(std::span<const u8> buffer) const {
+        if (auto match = this->findLongestMatch(buffer); match.has_value())
+            return match->second;
 
         return 1;
     }
 
     void EncodingFile::parseThingyFile(wolv::io::File &file) {
+        std::map<std::vector<u8>, std::string> mapping;
+
         for (const auto &line : splitString(file.readString(), "\n")) {
 
             std::string from, to;
@@ -72,14 +86,46 @@ namespace hex {
             if (to.empty())
                 to = " ";
 
-            if (!this->m_mapping.contains(fromBytes.size()))
-                this->m_mapping.insert({ fromBytes.size(), {} });
-
             auto keySize = fromBytes.size();
-            this->m_mapping[keySize].insert({ std::move(fromBytes), to });
+            mapping.insert({ std::move(fromBytes), to });
 
             this->m_longestSequence = std::max(this->m_longestSequence, keySize);
         }
+
+        // The mapping is sorted, so all sequences starting with the same bytes are next to each other and shorter sequences come first
+        auto buildNode = [this](auto &&buildNode, auto begin, auto end, size_t depth) -> u32 {
+            const u32 nodeIndex = this->m_nodes.size();
+            this->m_nodes.emplace_back();
+
+            if (begin != end && begin->first.size() == depth) {
+                this->m_nodes[nodeIndex].value = this->m_values.size();
+                this->m_values.push_back(begin->second);
+                ++begin;
+            }
+
+            std::vector<std::pair<decltype(begin), decltype(begin)>> children;
+            for (auto childBegin = begin; childBegin != end;) {
+                auto childEnd = std::find_if(childBegin, end, [&](const auto &entry) { return entry.first[depth] != childBegin->first[depth]; });
+                children.emplace_back(childBegin, childEnd);
+                childBegin = childEnd;
+            }
+
+            // Reserve the edges before building the children so they stay next to each other
+            const u32 edgesBegin = this->m_edges.size();
+            this->m_edges.resize(edgesBegin + children.size());
+            this->m_nodes[nodeIndex].edgesBegin = edgesBegin;
+            this->m_nodes[nodeIndex].edgesEnd   = edgesBegin + children.size();
+
+            for (size_t i = 0; i < children.size(); i++) {
+                const auto &[childBegin, childEnd] = children[i];
+                const auto childIndex = buildNode(buildNode, childBegin, childEnd, depth + 1);
+                this->m_edges[edgesBegin + i] = { childBegin->first[depth], childIndex };
+            }
+
+            return nodeIndex;
+        };
+
+        buildNode(buildNode, mapping.begin(), mapping.end(), 0);
     }
 
 }
\ No newline at end of file
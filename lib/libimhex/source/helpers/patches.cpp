@@ -2,16 +2,230 @@
 
 #include <hex/helpers/utils.hpp>
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
 #include <string_view>
 #include <type_traits>
 
 namespace hex {
 
+    namespace {
+
+        template<typename T>
+        auto findFirstOverlapping(T &extents, u64 address) {
+            auto iter = extents.upper_bound(address);
+            if (iter != extents.begin()) {
+                auto prev = std::prev(iter);
+                if (prev->first + prev->second.size() > address)
+                    return prev;
+            }
+
+            return iter;
+        }
+
+    }
+
+    void Patches::set(u64 address, const void *buffer, size_t size) {
+        if (size == 0)
+            return;
+
+        const auto bytes = static_cast<const u8 *>(buffer);
+        const u64 endAddress = address + size;
+
+        // Find the first extent that overlaps or directly touches the new range
+        auto target = this->m_extents.upper_bound(address);
+        if (target != this->m_extents.begin()) {
+            auto prev = std::prev(target);
+            if (prev->first + prev->second.size() >= address)
+                target = prev;
+        }
+
+        // Nothing to merge with, create a new extent
+        if (target == this->m_extents.end() || target->first > endAddress) {
+            this->m_extents.emplace_hint(target, address, std::vector<u8>(bytes, bytes + size));
+            this->m_byteCount += size;
+            return;
+        }
+
+        this->m_byteCount -= target->second.size();
+
+        // Grow the extent towards the front if the new range starts before it
+        if (target->first > address) {
+            auto node = this->m_extents.extract(target);
+            node.mapped().insert(node.mapped().begin(), node.key() - address, 0x00);
+            node.key() = address;
+            target = this->m_extents.insert(std::move(node)).position;
+        }
+
+        // Find all following extents that get swallowed by the new range
+        u64 mergedEnd = std::max<u64>(target->first + target->second.size(), endAddress);
+        auto last = std::next(target);
+        while (last != this->m_extents.end() && last->first <= endAddress) {
+            mergedEnd = std::max<u64>(mergedEnd, last->first + last->second.size());
+            ++last;
+        }
+
+        auto &data = target->second;
+        data.resize(mergedEnd - target->first);
+        for (auto iter = std::next(target); iter != last; ++iter) {
+            std::copy(iter->second.begin(), iter->second.end(), data.begin() + (iter->first - target->first));
+            this->m_byteCount -= iter->second.size();
+        }
+        this->m_extents.erase(std::next(target), last);
+
+        std::copy(bytes, bytes + size, data.begin() + (address - target->first));
+        this->m_byteCount += data.size();
+    }
+
+    void Patches::erase(u64 address, size_t size) {
+        if (size == 0)
+            return;
+
+        const u64 endAddress = address + size;
+
+        auto iter = findFirstOverlapping(this->m_extents, address);
+        while (iter != this->m_extents.end() && iter->first < endAddress) {
+            const u64 extentStart = iter->first;
+            auto &data = iter->second;
+            const u64 extentEnd = extentStart + data.size();
+
+            this->m_byteCount -= data.size();
+
+            // Keep the part of the extent that lies after the erased range
+            if (extentEnd > endAddress) {
+                std::vector<u8> tail(data.begin() + (endAddress - extentStart), data.end());
+                this->m_byteCount += tail.size();
+                this->m_extents.emplace_hint(std::next(iter), endAddress, std::move(tail));
+            }
+
+            // Keep the part of the extent that lies before the erased range
+            if (extentStart < address) {
+                data.resize(address - extentStart);
+                this->m_byteCount += data.size();
+                ++iter;
+            } else {
+                iter = this->m_extents.erase(iter);
+            }
+        }
+    }
+
+    void Patches::clear() {
+        this->m_extents.clear();
+        this->m_byteCount = 0;
+    }
+
+    void Patches::insert(u64 address, size_t size) {
+        if (size == 0)
+            return;
+
+        // Split the extent that spans over the insertion point
+        auto iter = findFirstOverlapping(this->m_extents, address);
+        if (iter != this->m_extents.end() && iter->first < address) {
+            auto &data = iter->second;
+
+            std::vector<u8> tail(data.begin() + (address - iter->first), data.end());
+            data.resize(address - iter->first);
+            iter = this->m_extents.emplace_hint(std::next(iter), address, std::move(tail));
+        }
+
+        std::vector<Extents::node_type> nodes;
+        while (iter != this->m_extents.end())
+            nodes.push_back(this->m_extents.extract(iter++));
+
+        for (auto &node : nodes) {
+            node.key() += size;
+            this->m_extents.insert(this->m_extents.end(), std::move(node));
+        }
+    }
+
+    void Patches::remove(u64 address, size_t size) {
+        if (size == 0)
+            return;
+
+        this->erase(address, size);
+
+        std::vector<Extents::node_type> nodes;
+        for (auto iter = this->m_extents.lower_bound(address + size); iter != this->m_extents.end();)
+            nodes.push_back(this->m_extents.extract(iter++));
+
+        for (auto &node : nodes) {
+            node.key() -= size;
+            this->m_extents.insert(this->m_extents.end(), std::move(node));
+        }
+
+        // The extents on both sides of the removed range might touch each other now
+        if (auto iter = this->m_extents.lower_bound(address); iter != this->m_extents.begin())
+            this->mergeWithNext(std::prev(iter));
+    }
+
+    void Patches::mergeWithNext(Extents::iterator iter) {
+        auto next = std::next(iter);
+        if (next == this->m_extents.end())
+            return;
+
+        auto &data = iter->second;
+        if (iter->first + data.size() != next->first)
+            return;
+
+        data.insert(data.end(), next->second.begin(), next->second.end());
+        this->m_extents.erase(next);
+    }
+
+    void Patches::apply(u64 address, void *buffer, size_t size) const {
+        const auto bytes = static_cast<u8 *>(buffer);
+        const u64 endAddress = address + size;
+
+        for (auto iter = findFirstOverlapping(this->m_extents, address); iter != this->m_extents.end() && iter->first < endAddress; ++iter) {
+            const u64 overlapStart = std::max<u64>(iter->first, address);
+            const u64 overlapEnd   = std::min<u64>(iter->first + iter->second.size(), endAddress);
+
+            std::memcpy(bytes + (overlapStart - address), iter->second.data() + (overlapStart - iter->first), overlapEnd - overlapStart);
+        }
+    }
+
+    Patches Patches::slice(u64 address, size_t size) const {
+        Patches result;
+
+        const u64 endAddress = address + size;
+        for (auto iter = findFirstOverlapping(this->m_extents, address); iter != this->m_extents.end() && iter->first < endAddress; ++iter) {
+            const u64 overlapStart = std::max<u64>(iter->first, address);
+            const u64 overlapEnd   = std::min<u64>(iter->first + iter->second.size(), endAddress);
+
+            result.m_extents.emplace_hint(result.m_extents.end(), overlapStart, std::vector<u8>(iter->second.begin() + (overlapStart - iter->first), iter->second.begin() + (overlapEnd - iter->first)));
+            result.m_byteCount += overlapEnd - overlapStart;
+        }
+
+        return result;
+    }
+
+    std::optional<u8> Patches::get(u64 address) const {
+        auto iter = findFirstOverlapping(this->m_extents, address);
+        if (iter == this->m_extents.end() || iter->first > address)
+            return std::nullopt;
+
+        return iter->second[address - iter->first];
+    }
+
+    bool Patches::contains(u64 address) const {
+        return this->get(address).has_value();
+    }
+
+    bool Patches::overlaps(u64 address, size_t size) const {
+        if (size == 0)
+            return false;
+
+        auto iter = findFirstOverlapping(this->m_extents, address);
+        return iter != this->m_extents.end() && iter->first < address + size;
+    }
+
+
     static void pushStringBack(std::vector<u8> &buffer, const std::string &string) {
         std::copy(string.begin(), string.end(), std::back_inserter(buffer));
     }
 
+    constexpr static size_t MaxIPSRecordSize = 0xFFFF;
+
     template<typename T>
     static void pushBytesBack(std::vector<u8> &buffer, T bytes) {
         buffer.resize(buffer.size() + sizeof(T));
@@ -23,43 +237,23 @@ namespace hex {
 
         pushStringBack(result, "PATCH");
 
-        std::vector<u64> addresses;
-        std::vector<u8> values;
-
-        for (const auto &[address, value] : patches) {
-            addresses.push_back(address);
-            values.push_back(value);
-        }
-
-        std::optional<u64> startAddress;
-        std::vector<u8> bytes;
-        for (u32 i = 0; i < addresses.size(); i++) {
-            if (!startAddress.has_value())
-                startAddress = addresses[i];
-
-            if (i != addresses.size() - 1 && addresses[i] == (addresses[i + 1] - 1)) {
-                bytes.push_back(values[i]);
-            } else {
-                bytes.push_back(values[i]);
+        for (const auto &[startAddress, bytes] : patches) {
+            // Records can hold at most 0xFFFF bytes, split larger extents into multiple records
+            for (u64 chunkOffset = 0; chunkOffset < bytes.size(); chunkOffset += MaxIPSRecordSize) {
+                const size_t chunkSize = std::min<size_t>(MaxIPSRecordSize, bytes.size() - chunkOffset);
 
-                if (bytes.size() > 0xFFFF)
-                    return std::unexpected(IPSError::PatchTooLarge);
-                if (startAddress > 0xFFFF'FFFF)
+                if (startAddress + chunkOffset > 0xFFFF'FFFF)
                     return std::unexpected(IPSError::AddressOutOfRange);
 
-                u32 address       = startAddress.value();
+                u32 address       = startAddress + chunkOffset;
                 auto addressBytes = reinterpret_cast<u8 *>(&address);
 
                 result.push_back(addressBytes[2]);
                 result.push_back(addressBytes[1]);
                 result.push_back(addressBytes[0]);
-                pushBytesBack<u16>(result, changeEndianess<u16>(bytes.size(), std::endian::big));
-
-                for (auto byte : bytes)
-                    result.push_back(byte);
+                pushBytesBack<u16>(result, changeEndianess<u16>(chunkSize, std::endian::big));
 
-                bytes.clear();
-                startAddress = {};
+                std::copy_n(bytes.begin() + chunkOffset, chunkSize, std::back_inserter(result));
             }
         }
 
@@ -73,44 +267,24 @@ namespace hex {
 
         pushStringBack(result, "IPS32");
 
-        std::vector<u64> addresses;
-        std::vector<u8> values;
+        for (const auto &[startAddress, bytes] : patches) {
+            // Records can hold at most 0xFFFF bytes, split larger extents into multiple records
+            for (u64 chunkOffset = 0; chunkOffset < bytes.size(); chunkOffset += MaxIPSRecordSize) {
+                const size_t chunkSize = std::min<size_t>(MaxIPSRecordSize, bytes.size() - chunkOffset);
 
-        for (const auto &[address, value] : patches) {
-            addresses.push_back(address);
-            values.push_back(value);
-        }
-
-        std::optional<u64> startAddress;
-        std::vector<u8> bytes;
-        for (u32 i = 0; i < addresses.size(); i++) {
-            if (!startAddress.has_value())
-                startAddress = addresses[i];
-
-            if (i != addresses.size() - 1 && addresses[i] == (addresses[i + 1] - 1)) {
-                bytes.push_back(values[i]);
-            } else {
-                bytes.push_back(values[i]);
-
-                if (bytes.size() > 0xFFFF)
-                    return std::unexpected(IPSError::PatchTooLarge);
-                if (startAddress > 0xFFFF'FFFF)
+                if (startAddress + chunkOffset > 0xFFFF'FFFF)
                     return std::unexpected(IPSError::AddressOutOfRange);
 
-                u32 address       = startAddress.value();
+                u32 address       = startAddress + chunkOffset;
                 auto addressBytes = reinterpret_cast<u8 *>(&address);
 
                 result.push_back(addressBytes[3]);
                 result.push_back(addressBytes[2]);
                 result.push_back(addressBytes[1]);
                 result.push_back(addressBytes[0]);
-                pushBytesBack<u16>(result, changeEndianess<u16>(bytes.size(), std::endian::big));
-
-                for (auto byte : bytes)
-                    result.push_back(byte);
+                pushBytesBack<u16>(result, changeEndianess<u16>(chunkSize, std::endian::big));
 
-                bytes.clear();
-                startAddress = {};
+                std::copy_n(bytes.begin() + chunkOffset, chunkSize, std::back_inserter(result));
             }
         }
 
@@ -141,8 +315,7 @@ namespace hex {
                 if (ipsOffset + size > ipsPatch.size() - 3)
                     return std::unexpected(IPSError::InvalidPatchFormat);
 
-                for (u16 i = 0; i < size; i++)
-                    result[offset + i] = ipsPatch[ipsOffset + i];
+                result.set(offset, &ipsPatch[ipsOffset], size);
                 ipsOffset += size;
             }
             // Handle RLE record
@@ -154,8 +327,8 @@ namespace hex {
 
                 ipsOffset += 2;
 
-                for (u16 i = 0; i < rleSize; i++)
-                    result[offset + i] = ipsPatch[ipsOffset + 0];
+                const std::vector<u8> bytes(rleSize, ipsPatch[ipsOffset + 0]);
+                result.set(offset, bytes.data(), bytes.size());
 
                 ipsOffset += 1;
             }
@@ -192,8 +365,7 @@ namespace hex {
                 if (ipsOffset + size > ipsPatch.size() - 3)
                     return std::unexpected(IPSError::InvalidPatchFormat);
 
-                for (u16 i = 0; i < size; i++)
-                    result[offset + i] = ipsPatch[ipsOffset + i];
+                result.set(offset, &ipsPatch[ipsOffset], size);
                 ipsOffset += size;
             }
             // Handle RLE record
@@ -205,8 +377,8 @@ namespace hex {
 
                 ipsOffset += 2;
 
-                for (u16 i = 0; i < rleSize; i++)
-                    result[offset + i] = ipsPatch[ipsOffset + 0];
+                const std::vector<u8> bytes(rleSize, ipsPatch[ipsOffset + 0]);
+                result.set(offset, bytes.data(), bytes.size());
 
                 ipsOffset += 1;
             }
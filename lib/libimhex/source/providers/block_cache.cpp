@@ -0,0 +1,178 @@
+#include <hex/providers/block_cache.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace hex::prv {
+
+    BlockCache::BlockCache(ReadFunction readFunction, size_t blockSize, size_t blockCount, size_t readAheadBlockCount)
+        : m_readFunction(std::move(readFunction)), m_blockSize(std::max<size_t>(blockSize, 1)), m_blockCount(std::max<size_t>(blockCount, 1)), m_readAheadBlockCount(readAheadBlockCount) {
+        this->m_blockLookup.reserve(this->m_blockCount);
+    }
+
+    void BlockCache::read(u64 offset, void *buffer, size_t size) {
+        if (size == 0)
+            return;
+
+        std::scoped_lock lock(this->m_mutex);
+
+        auto bytes = static_cast<u8 *>(buffer);
+        const u64 endAddress = offset + size;
+
+        // Copies the part of a block that overlaps with the requested range into the output buffer
+        auto copyToBuffer = [&](u64 blockAddress, const u8 *data, size_t dataSize) {
+            const u64 copyStart = std::max(blockAddress, offset);
+            const u64 copyEnd   = std::min(blockAddress + dataSize, endAddress);
+
+            std::memcpy(bytes + (copyStart - offset), data + (copyStart - blockAddress), copyEnd - copyStart);
+        };
+
+        u64 blockAddress = offset - (offset % this->m_blockSize);
+        while (blockAddress < endAddress) {
+            if (auto block = this->findBlock(blockAddress); block != this->m_blocks.end()) {
+                this->m_hitCount += 1;
+                this->m_blocks.splice(this->m_blocks.begin(), this->m_blocks, block);
+
+                copyToBuffer(blockAddress, block->data.data(), this->m_blockSize);
+                blockAddress += this->m_blockSize;
+
+                continue;
+            }
+
+            // Fetch the whole run of missing blocks with a single backend access
+            size_t missingBlocks = 1;
+            while (missingBlocks < this->m_blockCount) {
+                const u64 address = blockAddress + missingBlocks * this->m_blockSize;
+                if (address >= endAddress || this->findBlock(address) != this->m_blocks.end())
+                    break;
+
+                missingBlocks += 1;
+            }
+
+            this->m_missCount += missingBlocks;
+
+            // If this miss continues right where the last one stopped, the data is most likely being read sequentially
+            size_t readAheadBlocks = 0;
+            if (blockAddress == this->m_sequentialAddress) {
+                while (readAheadBlocks < this->m_readAheadBlockCount && missingBlocks + readAheadBlocks < this->m_blockCount) {
+                    const u64 address = blockAddress + (missingBlocks + readAheadBlocks) * this->m_blockSize;
+                    if (this->findBlock(address) != this->m_blocks.end())
+                        break;
+
+                    readAheadBlocks += 1;
+                }
+            }
+
+            const size_t fetchedBlocks = missingBlocks + readAheadBlocks;
+
+            std::vector<u8> data(fetchedBlocks * this->m_blockSize);
+            this->m_readFunction(blockAddress, data.data(), data.size());
+
+            for (size_t i = 0; i < fetchedBlocks; i++)
+                this->insertBlock(blockAddress + i * this->m_blockSize, data.data() + i * this->m_blockSize);
+
+            copyToBuffer(blockAddress, data.data(), missingBlocks * this->m_blockSize);
+
+            this->m_sequentialAddress = blockAddress + fetchedBlocks * this->m_blockSize;
+            blockAddress += missingBlocks * this->m_blockSize;
+        }
+    }
+
+    void BlockCache::invalidate(u64 offset, size_t size) {
+        if (size == 0)
+            return;
+
+        std::scoped_lock lock(this->m_mutex);
+
+        const u64 startAddress = offset - (offset % this->m_blockSize);
+        const u64 endAddress   = offset + size;
+
+        auto eraseBlock = [this](BlockList::iterator block) {
+            this->m_blockLookup.erase(block->address);
+            return this->m_blocks.erase(block);
+        };
+
+        // Only look up the affected blocks one by one if there's fewer of them than blocks in the cache
+        if ((endAddress - startAddress) / this->m_blockSize < this->m_blocks.size()) {
+            for (u64 address = startAddress; address < endAddress; address += this->m_blockSize) {
+                if (auto block = this->m_blockLookup.find(address); block != this->m_blockLookup.end())
+                    eraseBlock(block->second);
+            }
+        } else {
+            for (auto block = this->m_blocks.begin(); block != this->m_blocks.end();) {
+                if (block->address + this->m_blockSize > offset && block->address < endAddress)
+                    block = eraseBlock(block);
+                else
+                    ++block;
+            }
+        }
+
+        this->m_sequentialAddress = 0;
+    }
+
+    void BlockCache::invalidateAll() {
+        std::scoped_lock lock(this->m_mutex);
+
+        this->m_blocks.clear();
+        this->m_blockLookup.clear();
+        this->m_sequentialAddress = 0;
+    }
+
+    void BlockCache::setMaxBlockAge(std::optional<std::chrono::milliseconds> maxAge) {
+        std::scoped_lock lock(this->m_mutex);
+
+        this->m_maxBlockAge = maxAge;
+    }
+
+    size_t BlockCache::getCachedBlockCount() const {
+        std::scoped_lock lock(this->m_mutex);
+
+        return this->m_blocks.size();
+    }
+
+    void BlockCache::resetCounters() {
+        this->m_hitCount  = 0;
+        this->m_missCount = 0;
+    }
+
+    BlockCache::BlockList::iterator BlockCache::findBlock(u64 address) {
+        auto entry = this->m_blockLookup.find(address);
+        if (entry == this->m_blockLookup.end())
+            return this->m_blocks.end();
+
+        auto block = entry->second;
+
+        // Treat blocks that have been in the cache for too long as missing
+        if (this->m_maxBlockAge.has_value() && std::chrono::steady_clock::now() - block->fetchTime > *this->m_maxBlockAge) {
+            this->m_blockLookup.erase(entry);
+            this->m_blocks.erase(block);
+
+            return this->m_blocks.end();
+        }
+
+        return block;
+    }
+
+    void BlockCache::insertBlock(u64 address, const u8 *data) {
+        if (auto entry = this->m_blockLookup.find(address); entry != this->m_blockLookup.end()) {
+            this->m_blocks.erase(entry->second);
+            this->m_blockLookup.erase(entry);
+        }
+
+        if (this->m_blocks.size() >= this->m_blockCount) {
+            // Reuse the buffer of the least recently used block instead of allocating a new one
+            this->m_blockLookup.erase(this->m_blocks.back().address);
+            this->m_blocks.splice(this->m_blocks.begin(), this->m_blocks, std::prev(this->m_blocks.end()));
+        } else {
+            this->m_blocks.emplace_front(Block { 0, std::vector<u8>(this->m_blockSize), { } });
+        }
+
+        auto &block = this->m_blocks.front();
+        block.address   = address;
+        block.fetchTime = std::chrono::steady_clock::now();
+        std::memcpy(block.data.data(), data, this->m_blockSize);
+
+        this->m_blockLookup[address] = this->m_blocks.begin();
+    }
+
+}
@@ -3,10 +3,12 @@
 #include <hex.hpp>
 #include <hex/api/event.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <map>
 #include <optional>
+#include <vector>
 
 #include <hex/helpers/magic.hpp>
 #include <wolv/io/file.hpp>
@@ -15,9 +17,7 @@ namespace hex::prv {
 
     u32 Provider::s_idCounter = 0;
 
-    Provider::Provider() : m_id(s_idCounter++) {
-        this->m_patches.emplace_back();
-    }
+    Provider::Provider() : m_id(s_idCounter++) { }
 
     Provider::~Provider() {
         for (auto &overlay : this->m_overlays)
@@ -27,12 +27,21 @@ namespace hex::prv {
     void Provider::read(u64 offset, void *buffer, size_t size, bool overlays) {
         hex::unused(overlays);
 
-        this->readRaw(offset - this->getBaseAddress(), buffer, size);
+        this->readRawCached(offset - this->getBaseAddress(), buffer, size);
     }
 
     void Provider::write(u64 offset, const void *buffer, size_t size) {
         this->writeRaw(offset - this->getBaseAddress(), buffer, size);
+        this->invalidateBlockCache(offset - this->getBaseAddress(), size);
         this->markDirty();
+
+        EventManager::post<EventProviderDataModified>(this, Region { offset, size });
+    }
+
+    Region Provider::getRegionFrom(u64 address) const {
+        const u64 endAddress = this->getBaseAddress() + this->getActualSize();
+
+        return { address, address < endAddress ? endAddress - address : 0 };
     }
 
     void Provider::save() { }
@@ -64,43 +73,42 @@ namespace hex::prv {
     void Provider::resize(size_t newSize) {
         hex::unused(newSize);
 
+        this->invalidateBlockCache();
         this->markDirty();
+
+        EventManager::post<EventProviderDataModified>(this, Region { this->getBaseAddress(), this->getActualSize() });
     }
 
     void Provider::insert(u64 offset, size_t size) {
-        auto &patches = getPatches();
-
-        std::vector<std::pair<u64, u8>> patchesToMove;
-
-        for (auto &[address, value] : patches) {
-            if (address > offset)
-                patchesToMove.emplace_back(address, value);
-        }
+        getPatches().insert(offset, size);
+        this->invalidateBlockCache();
 
-        for (const auto &[address, value] : patchesToMove)
-            patches.erase(address);
-        for (const auto &[address, value] : patchesToMove)
-            patches.insert({ address + size, value });
+        // The undo history refers to the addresses from before the insertion
+        this->m_undoStack.clear();
 
         this->markDirty();
+
+        // All data behind the inserted bytes moved
+        EventManager::post<EventProviderDataModified>(this, this->getRegionFrom(offset));
     }
 
     void Provider::remove(u64 offset, size_t size) {
-        auto &patches = getPatches();
+        getPatches().remove(offset, size);
+        this->invalidateBlockCache();
 
-        std::vector<std::pair<u64, u8>> patchesToMove;
+        // The undo history refers to the addresses from before the removal
+        this->m_undoStack.clear();
 
-        for (auto &[address, value] : patches) {
-            if (address > offset)
-                patchesToMove.emplace_back(address, value);
-        }
+        this->markDirty();
+
+        // All data behind the removed bytes moved
+        EventManager::post<EventProviderDataModified>(this, this->getRegionFrom(offset));
+    }
 
-        for (const auto &[address, value] : patchesToMove)
-            patches.erase(address);
-        for (const auto &[address, value] : patchesToMove)
-            patches.insert({ address - size, value });
+    std::optional<DataView> Provider::getDataView(u64 offset, size_t size) {
+        hex::unused(offset, size);
 
-        this->markDirty();
+        return std::nullopt;
     }
 
     void Provider::applyOverlays(u64 offset, void *buffer, size_t size) {
@@ -115,26 +123,28 @@ namespace hex::prv {
         }
     }
 
+    bool Provider::hasModifications(u64 offset, size_t size) const {
+        if (this->m_patches.overlaps(offset, size))
+            return true;
 
-    std::map<u64, u8> &Provider::getPatches() {
-        auto iter = this->m_patches.end();
-        for (u32 i = 0; i < this->m_patchTreeOffset + 1; i++)
-            iter--;
-
-        return *(iter);
+        return std::any_of(this->m_overlays.begin(), this->m_overlays.end(), [&](const Overlay *overlay) {
+            return Region { offset, size }.overlaps({ overlay->getAddress(), overlay->getSize() });
+        });
     }
 
-    const std::map<u64, u8> &Provider::getPatches() const {
-        auto iter = this->m_patches.end();
-        for (u32 i = 0; i < this->m_patchTreeOffset + 1; i++)
-            iter--;
 
-        return *(iter);
+    Patches &Provider::getPatches() {
+        return this->m_patches;
+    }
+
+    const Patches &Provider::getPatches() const {
+        return this->m_patches;
     }
 
     void Provider::applyPatches() {
-        for (auto &[patchAddress, patch] : getPatches()) {
-            this->writeRaw(patchAddress - this->getBaseAddress(), &patch, 1);
+        for (const auto &[patchAddress, bytes] : getPatches()) {
+            this->writeRaw(patchAddress - this->getBaseAddress(), bytes.data(), bytes.size());
+            this->invalidateBlockCache(patchAddress - this->getBaseAddress(), bytes.size());
         }
 
         if (!this->isWritable())
@@ -142,7 +152,45 @@ namespace hex::prv {
 
         this->markDirty();
 
-        this->m_patches.emplace_back();
+        // All patches are part of the underlying data now so there's nothing left that could be undone
+        this->m_patches.clear();
+        this->m_undoStack.clear();
+    }
+
+
+    BlockCache &Provider::enableBlockCache(size_t blockSize, size_t blockCount, size_t readAheadBlockCount) {
+        this->m_blockCache = std::make_unique<BlockCache>([this](u64 offset, u8 *buffer, size_t size) {
+            // Blocks may reach past the end of the data, only read the part that actually exists
+            const auto actualSize = this->getActualSize();
+            const size_t readSize = offset < actualSize ? std::min<u64>(size, actualSize - offset) : 0;
+
+            if (readSize > 0)
+                this->readRaw(offset, buffer, readSize);
+            std::memset(buffer + readSize, 0x00, size - readSize);
+        }, blockSize, blockCount, readAheadBlockCount);
+
+        return *this->m_blockCache;
+    }
+
+    void Provider::disableBlockCache() {
+        this->m_blockCache.reset();
+    }
+
+    void Provider::readRawCached(u64 offset, void *buffer, size_t size) {
+        if (this->m_blockCache != nullptr)
+            this->m_blockCache->read(offset, buffer, size);
+        else
+            this->readRaw(offset, buffer, size);
+    }
+
+    void Provider::invalidateBlockCache(u64 offset, size_t size) {
+        if (this->m_blockCache != nullptr)
+            this->m_blockCache->invalidate(offset, size);
+    }
+
+    void Provider::invalidateBlockCache() {
+        if (this->m_blockCache != nullptr)
+            this->m_blockCache->invalidateAll();
     }
 
 
@@ -201,52 +249,70 @@ namespace hex::prv {
     }
 
     void Provider::addPatch(u64 offset, const void *buffer, size_t size, bool createUndo) {
-        if (this->m_patchTreeOffset > 0) {
-            auto iter = this->m_patches.end();
-            for (u32 i = 0; i < this->m_patchTreeOffset; i++)
-                iter--;
+        this->m_undoStack.prepare(this->m_patches, { offset, size }, createUndo);
 
-            this->m_patches.erase(iter, this->m_patches.end());
-            this->m_patchTreeOffset = 0;
-        }
+        auto &patches = getPatches();
+        const auto bytes = static_cast<const u8 *>(buffer);
 
-        if (createUndo)
-            createUndoPoint();
+        // Compare the new data against the original data in chunks and only store runs of bytes that actually differ
+        std::vector<u8> originalBytes(std::min<size_t>(size, 0x10'0000));
+        for (u64 chunkOffset = 0; chunkOffset < size; chunkOffset += originalBytes.size()) {
+            const size_t chunkSize = std::min<size_t>(originalBytes.size(), size - chunkOffset);
+            const auto chunkBytes  = bytes + chunkOffset;
+
+            // Patches are keyed by address including the base address while readRaw takes offsets relative to the start of the data
+            std::fill(originalBytes.begin(), originalBytes.end(), 0x00);
+            this->readRaw(offset + chunkOffset - this->getBaseAddress(), originalBytes.data(), chunkSize);
 
-        for (u64 i = 0; i < size; i++) {
-            u8 patch         = reinterpret_cast<const u8 *>(buffer)[i];
-            u8 originalValue = 0x00;
-            this->readRaw(offset + i, &originalValue, sizeof(u8));
+            u64 runStart = 0;
+            while (runStart < chunkSize) {
+                const bool modified = chunkBytes[runStart] != originalBytes[runStart];
 
-            if (patch == originalValue)
-                getPatches().erase(offset + i);
-            else
-                getPatches()[offset + i] = patch;
+                u64 runEnd = runStart + 1;
+                while (runEnd < chunkSize && (chunkBytes[runEnd] != originalBytes[runEnd]) == modified)
+                    runEnd++;
+
+                if (modified)
+                    patches.set(offset + chunkOffset + runStart, chunkBytes + runStart, runEnd - runStart);
+                else
+                    patches.erase(offset + chunkOffset + runStart, runEnd - runStart);
+
+                runStart = runEnd;
+            }
         }
 
+        if (createUndo)
+            this->m_undoStack.commit(this->m_patches);
+
         this->markDirty();
+
+        EventManager::post<EventProviderDataModified>(this, Region { offset, size });
     }
 
     void Provider::createUndoPoint() {
-        this->m_patches.push_back(getPatches());
+        this->m_undoStack.commit(this->m_patches);
     }
 
     void Provider::undo() {
-        if (canUndo())
-            this->m_patchTreeOffset++;
+        if (auto region = this->m_undoStack.undo(this->m_patches); region.has_value()) {
+            this->markDirty();
+            EventManager::post<EventProviderDataModified>(this, *region);
+        }
     }
 
     void Provider::redo() {
-        if (canRedo())
-            this->m_patchTreeOffset--;
+        if (auto region = this->m_undoStack.redo(this->m_patches); region.has_value()) {
+            this->markDirty();
+            EventManager::post<EventProviderDataModified>(this, *region);
+        }
     }
 
     bool Provider::canUndo() const {
-        return this->m_patchTreeOffset < this->m_patches.size() - 1;
+        return this->m_undoStack.canUndo();
     }
 
     bool Provider::canRedo() const {
-        return this->m_patchTreeOffset > 0;
+        return this->m_undoStack.canRedo();
     }
 
     bool Provider::hasFilePicker() const {
@@ -305,11 +371,12 @@ namespace hex::prv {
             }
         }
 
-        for (const auto &[patchAddress, value] : this->m_patches.back()) {
-            if (!nextRegionAddress.has_value() || patchAddress < nextRegionAddress)
-                nextRegionAddress = patchAddress;
+        if (const auto &patches = this->m_patches; !patches.empty()) {
+            const auto firstPatchAddress = patches.begin()->first;
+            if (!nextRegionAddress.has_value() || firstPatchAddress < nextRegionAddress)
+                nextRegionAddress = firstPatchAddress;
 
-            if (address == patchAddress)
+            if (patches.contains(address))
                 insideValidRegion = true;
         }
 
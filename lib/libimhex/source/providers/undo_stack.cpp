@@ -0,0 +1,188 @@
+#include <hex/providers/undo_stack.hpp>
+
+#include <hex/helpers/literals.hpp>
+
+namespace hex::prv {
+
+    using namespace hex::literals;
+
+    std::atomic<size_t> UndoStack::s_memoryLimit = 512_MiB;
+
+    namespace {
+
+        bool touches(const Region &a, const Region &b) {
+            return b.getStartAddress() <= a.getEndAddress() + 1 && b.getEndAddress() + 1 >= a.getStartAddress();
+        }
+
+        void overlay(Patches &target, const Patches &source) {
+            for (const auto &[address, bytes] : source)
+                target.set(address, bytes.data(), bytes.size());
+        }
+
+        void replace(Patches &patches, const Region &region, const Patches &replacement) {
+            patches.erase(region.getStartAddress(), region.getSize());
+            overlay(patches, replacement);
+        }
+
+    }
+
+    size_t UndoStack::Operation::getMemoryUsage() const {
+        constexpr static auto ExtentOverhead = 64;
+
+        return sizeof(Operation) +
+               this->before.size() + this->before.getExtentCount() * ExtentOverhead +
+               this->after.size()  + this->after.getExtentCount()  * ExtentOverhead;
+    }
+
+    void UndoStack::prepare(const Patches &patches, Region region, bool standalone) {
+        if (region.getSize() == 0)
+            return;
+
+        this->clearRedoOperations();
+
+        const auto now = std::chrono::steady_clock::now();
+
+        // Standalone modifications never become part of a collected undo step
+        if (standalone && this->m_pendingOperation.has_value() && !this->m_pendingOperation->mergeable)
+            this->commit(patches);
+
+        // Reopen the last undo step if this modification directly continues it
+        if (standalone && !this->m_pendingOperation.has_value() && !this->m_undoOperations.empty()) {
+            auto &lastOperation = this->m_undoOperations.back();
+
+            if (lastOperation.mergeable &&
+                now - lastOperation.lastModified < MergeTimeout &&
+                lastOperation.region.getSize() + region.getSize() <= MaxMergedSize &&
+                touches(lastOperation.region, region))
+            {
+                this->m_memoryUsage -= lastOperation.getMemoryUsage();
+                this->m_pendingOperation = std::move(lastOperation);
+                this->m_undoOperations.pop_back();
+            }
+        }
+
+        if (!this->m_pendingOperation.has_value()) {
+            this->m_pendingOperation = Operation {
+                .region       = region,
+                .before       = patches.slice(region.getStartAddress(), region.getSize()),
+                .after        = { },
+                .mergeable    = standalone,
+                .lastModified = now
+            };
+
+            return;
+        }
+
+        // Grow the open undo step so it covers the new region as well, only the newly covered parts need to be saved
+        auto &operation = *this->m_pendingOperation;
+
+        const u64 oldStart = operation.region.getStartAddress();
+        const u64 oldEnd   = operation.region.getEndAddress();
+        const u64 newStart = std::min(oldStart, region.getStartAddress());
+        const u64 newEnd   = std::max(oldEnd, region.getEndAddress());
+
+        if (newStart < oldStart)
+            overlay(operation.before, patches.slice(newStart, oldStart - newStart));
+        if (newEnd > oldEnd)
+            overlay(operation.before, patches.slice(oldEnd + 1, newEnd - oldEnd));
+
+        operation.region       = { newStart, (newEnd - newStart) + 1 };
+        operation.lastModified = now;
+    }
+
+    void UndoStack::commit(const Patches &patches) {
+        if (!this->m_pendingOperation.has_value())
+            return;
+
+        auto operation = std::move(*this->m_pendingOperation);
+        this->m_pendingOperation.reset();
+
+        operation.after = patches.slice(operation.region.getStartAddress(), operation.region.getSize());
+
+        // Don't keep undo steps that didn't change anything
+        if (operation.before == operation.after)
+            return;
+
+        this->m_memoryUsage += operation.getMemoryUsage();
+        this->m_undoOperations.push_back(std::move(operation));
+
+        this->enforceMemoryLimit();
+    }
+
+    std::optional<Region> UndoStack::undo(Patches &patches) {
+        this->commit(patches);
+
+        if (this->m_undoOperations.empty())
+            return std::nullopt;
+
+        auto operation = std::move(this->m_undoOperations.back());
+        this->m_undoOperations.pop_back();
+
+        replace(patches, operation.region, operation.before);
+
+        operation.mergeable = false;
+        const auto region = operation.region;
+        this->m_redoOperations.push_back(std::move(operation));
+
+        return region;
+    }
+
+    std::optional<Region> UndoStack::redo(Patches &patches) {
+        if (this->m_redoOperations.empty())
+            return std::nullopt;
+
+        auto operation = std::move(this->m_redoOperations.back());
+        this->m_redoOperations.pop_back();
+
+        replace(patches, operation.region, operation.after);
+
+        const auto region = operation.region;
+        this->m_undoOperations.push_back(std::move(operation));
+
+        return region;
+    }
+
+    bool UndoStack::canUndo() const {
+        return !this->m_undoOperations.empty() || this->m_pendingOperation.has_value();
+    }
+
+    bool UndoStack::canRedo() const {
+        return !this->m_redoOperations.empty();
+    }
+
+    void UndoStack::clear() {
+        this->m_undoOperations.clear();
+        this->m_redoOperations.clear();
+        this->m_pendingOperation.reset();
+
+        this->m_memoryUsage = 0;
+    }
+
+    size_t UndoStack::getMemoryUsage() const {
+        return this->m_memoryUsage;
+    }
+
+    void UndoStack::setMemoryLimit(size_t limit) {
+        s_memoryLimit = limit;
+    }
+
+    size_t UndoStack::getMemoryLimit() {
+        return s_memoryLimit;
+    }
+
+    void UndoStack::clearRedoOperations() {
+        for (const auto &operation : this->m_redoOperations)
+            this->m_memoryUsage -= operation.getMemoryUsage();
+
+        this->m_redoOperations.clear();
+    }
+
+    void UndoStack::enforceMemoryLimit() {
+        // Always keep the most recent undo step, even if it's bigger than the limit on its own
+        while (this->m_memoryUsage > s_memoryLimit && this->m_undoOperations.size() > 1) {
+            this->m_memoryUsage -= this->m_undoOperations.front().getMemoryUsage();
+            this->m_undoOperations.pop_front();
+        }
+    }
+
+}
@@ -281,6 +281,8 @@ namespace hex::init {
         ImHexApi::HexEditor::impl::getForegroundHighlights().clear();
         ImHexApi::HexEditor::impl::getBackgroundHighlightingFunctions().clear();
         ImHexApi::HexEditor::impl::getForegroundHighlightingFunctions().clear();
+        ImHexApi::HexEditor::impl::getBackgroundHighlightingRegionFunctions().clear();
+        ImHexApi::HexEditor::impl::getForegroundHighlightingRegionFunctions().clear();
         ImHexApi::HexEditor::impl::getTooltips().clear();
         ImHexApi::HexEditor::impl::getTooltipFunctions().clear();
 
@@ -12,7 +12,12 @@
 #include <imgui_internal.h>
 
 #include <hex/helpers/logger.hpp>
+
+#include <array>
+#include <bit>
+#include <cstring>
 #include <random>
+#include <span>
 
 namespace hex {
 
@@ -95,6 +100,46 @@ namespace hex {
 
     }
 
+    /**
+     * @brief Counts how often every byte value occurs in a buffer
+     * Consecutive bytes get counted in four separate tables so runs of the same byte value don't have to wait for
+     * the previous increment of the same counter to finish
+     * @param data Data to count
+     * @param valueCounts Array the counts get added to
+     */
+    inline void countByteValues(std::span<const u8> data, std::array<ImU64, 256> &valueCounts) {
+        // Clearing the tables costs more than it saves for small buffers
+        if (data.size() < 0x1000) {
+            for (u8 byte : data)
+                valueCounts[byte]++;
+
+            return;
+        }
+
+        std::array<std::array<u32, 256>, 4> tables = { };
+
+        size_t i = 0;
+        for (; i + sizeof(u64) <= data.size(); i += sizeof(u64)) {
+            u64 bytes;
+            std::memcpy(&bytes, data.data() + i, sizeof(bytes));
+
+            tables[0][(bytes >>  0) & 0xFF]++;
+            tables[1][(bytes >>  8) & 0xFF]++;
+            tables[2][(bytes >> 16) & 0xFF]++;
+            tables[3][(bytes >> 24) & 0xFF]++;
+            tables[0][(bytes >> 32) & 0xFF]++;
+            tables[1][(bytes >> 40) & 0xFF]++;
+            tables[2][(bytes >> 48) & 0xFF]++;
+            tables[3][(bytes >> 56) & 0xFF]++;
+        }
+
+        for (; i < data.size(); i++)
+            tables[0][data[i]]++;
+
+        for (u32 value = 0; value < valueCounts.size(); value++)
+            valueCounts[value] += u64(tables[0][value]) + tables[1][value] + tables[2][value] + tables[3][value];
+    }
+
     class DiagramDigram {
     public:
         DiagramDigram(size_t sampleSize = 0x9000) : m_sampleSize(sampleSize) { }
@@ -136,27 +181,6 @@ namespace hex {
             this->m_processing = false;
         }
 
-        void reset(u64 size) {
-            this->m_processing = true;
-            this->m_buffer.clear();
-            this->m_buffer.resize(size);
-            this->m_byteCount = 0;
-            this->m_fileSize  = size;
-        }
-
-        void update(u8 byte) {
-            // Check if there is some space left
-            if (this->m_byteCount < this->m_fileSize) {
-                this->m_buffer[this->m_byteCount] = byte;
-                ++this->m_byteCount;
-                if (this->m_byteCount == this->m_fileSize) {
-                    this->m_buffer = getSampleSelection(this->m_buffer, this->m_sampleSize);
-                    processImpl();                    
-                    this->m_processing = false;
-                }
-            } 
-        }
-
  
     private:
         void processImpl() {
@@ -179,10 +203,6 @@ namespace hex {
     private:
         size_t m_sampleSize;
 
-        // The number of byte processed and the size of 
-        // the file to analyze (useful for iterative analysis)
-        u64 m_byteCount;
-        u64 m_fileSize;
         std::vector<u8> m_buffer;
         std::vector<float> m_glowBuffer;
         float m_opacity = 0.0F;
@@ -231,27 +251,6 @@ namespace hex {
             this->m_processing = false;
         }
 
-        void reset(u64 size) {
-            this->m_processing = true;
-            this->m_buffer.clear();
-            this->m_buffer.resize(size);
-            this->m_byteCount = 0;
-            this->m_fileSize  = size;
-        }
-
-        void update(u8 byte) {
-            // Check if there is some space left
-            if (this->m_byteCount < this->m_fileSize) {
-                this->m_buffer[this->m_byteCount] = byte;
-                ++this->m_byteCount;
-                if (this->m_byteCount == this->m_fileSize) {
-                    this->m_buffer = getSampleSelection(this->m_buffer, this->m_sampleSize);
-                    processImpl();                    
-                    this->m_processing = false;
-                }
-            } 
-        }
-
     private:
         void processImpl() {
             this->m_glowBuffer.resize(this->m_buffer.size());
@@ -271,11 +270,6 @@ namespace hex {
         }
     private:
         size_t m_sampleSize;
-    
-        // The number of byte processed and the size of 
-        // the file to analyze (useful for iterative analysis)
-        u64 m_byteCount;
-        u64 m_fileSize;
 
         std::vector<u8> m_buffer;
         std::vector<float> m_glowBuffer;
@@ -301,7 +295,7 @@ namespace hex {
                 );
 
                 // Draw the plot
-                ImPlot::PlotLine("##ChunkBasedAnalysisLine", this->m_xBlockEntropy.data(), this->m_yBlockEntropy.data(), this->m_blockCount);
+                ImPlot::PlotLine("##ChunkBasedAnalysisLine", this->m_xBlockEntropy.data(), this->m_ySampledBlockEntropy.data(), this->m_blockCount);
 
                 // The parameter updateHandle is used when using the pattern language since we don't have a provider 
                 // but just a set of bytes we won't be able to use the drag bar correctly.
@@ -379,43 +373,65 @@ namespace hex {
             this->m_baseAddress  = baseAddress; 
             this->m_fileSize     = size;
 
-            this->m_blockValueCounts = { 0 };
-
             // Reset and resize the array
             this->m_yBlockEntropy.clear();
-            this->m_yBlockEntropy.resize(((this->m_endAddress - this->m_startAddress) / this->m_chunkSize) + 1);
+            this->m_yBlockEntropy.resize((this->m_endAddress - this->m_startAddress + this->m_chunkSize - 1) / this->m_chunkSize);
 
-            this->m_byteCount = 0;
-            this->m_blockCount = 0;
+            // Precompute count * log2(count) so computing the entropy of a chunk barely needs any logarithms
+            this->m_countEntropies.resize(std::min<u64>(this->m_chunkSize, 0x1'0000) + 1);
+            for (u64 count = 1; count < this->m_countEntropies.size(); count++)
+                this->m_countEntropies[count] = count * std::log2(double(count));
 
             // Set the diagram handle position to the start of the plot
             this->m_handlePosition = this->m_startAddress / double(this->m_blockSize);
         }
 
-        // Process one byte at the time
-        void update(u8 byte) {
-            u64 totalBlock = std::ceil((this->m_endAddress - this->m_startAddress) / this->m_chunkSize);
+        /**
+         * @brief Sets the byte value counts of one chunk of the analyzed region
+         * Different chunks may be updated from different threads at the same time
+         * @param chunkIndex Index of the chunk
+         * @param valueCounts Number of occurrences of every byte value in the chunk
+         * @param chunkSize Size of the chunk. Only the last chunk may be smaller than the chunk size passed to reset()
+         */
+        void update(u64 chunkIndex, const std::array<ImU64, 256> &valueCounts, u64 chunkSize) {
+            // entropy = -sum(count / size * log2(count / size)) = log2(size) - sum(count * log2(count)) / size
+            double sum = 0;
+            for (auto count : valueCounts) {
+                if (count < this->m_countEntropies.size()) [[likely]]
+                    sum += this->m_countEntropies[count];
+                else
+                    sum += count * std::log2(double(count));
+            }
 
-            // Check if there is still some 
-            if (this->m_blockCount < totalBlock) {
-                // Increment the occurrence of the current byte
-                this->m_blockValueCounts[byte]++;
+            const double entropy = std::log2(double(chunkSize)) - sum / chunkSize;
 
-                this->m_byteCount++;
-                // Check if we processed one complete chunk, if so compute the entropy and start analysing the next chunk
-                if (((this->m_byteCount % this->m_chunkSize) == 0) || this->m_byteCount == (this->m_endAddress - this->m_startAddress)) [[unlikely]] {
-                    this->m_yBlockEntropy[this->m_blockCount] = calculateEntropy(this->m_blockValueCounts, this->m_chunkSize);
+            this->m_yBlockEntropy[chunkIndex] = std::clamp<double>(entropy / 8, 0.0, 1.0);    // log2(256) = 8
+        }
 
-                    this->m_blockCount += 1;
-                    this->m_blockValueCounts = { 0 };
-                }
-               
-                // Check if we processed the last block, if so setup the X axis part of the data
-                if (this->m_blockCount == totalBlock) {
-                    processFinalize();
-                    this->m_processing = false;           
-                }
-            }
+        // Called once all chunks have been updated. May be called again after updating some of the chunks another time
+        void finish() {
+            this->m_blockCount = this->m_yBlockEntropy.size();
+            if (this->m_blockCount > 0)
+                this->processFinalize();
+
+            this->m_processing = false;
+        }
+
+        // Return the entropy values displayed in the plot
+        const std::vector<double> &getSampledEntropies() const {
+            return this->m_ySampledBlockEntropy;
+        }
+
+        /**
+         * @brief Restores the plot of a previous analysis without the entropy of every single chunk
+         * The highest and lowest entropy blocks stay unknown until all chunks got updated and finish() got called again
+         * @param sampledEntropies Entropies as returned by getSampledEntropies(). May not be empty
+         */
+        void setSampledEntropies(std::vector<double> sampledEntropies) {
+            this->m_ySampledBlockEntropy = std::move(sampledEntropies);
+            this->updatePlotPositions();
+
+            this->m_processing = false;
         }
 
         // Method used to compute the entropy of a block of size `blockSize`
@@ -447,7 +463,7 @@ namespace hex {
         u64 getHighestEntropyBlockAddress() {
             u64 address = 0x00;
             if (!this->m_yBlockEntropy.empty())
-                address = (std::max_element(this->m_yBlockEntropy.begin(), this->m_yBlockEntropy.end()) - this->m_yBlockEntropy.begin()) * this->m_blockSize;
+                address = this->m_startAddress + (std::max_element(this->m_yBlockEntropy.begin(), this->m_yBlockEntropy.end()) - this->m_yBlockEntropy.begin()) * this->m_chunkSize;
             return address;
         }
 
@@ -463,7 +479,7 @@ namespace hex {
         u64 getLowestEntropyBlockAddress() {
             u64 address = 0x00;
             if (!this->m_yBlockEntropy.empty())
-                address = (std::min_element(this->m_yBlockEntropy.begin(), this->m_yBlockEntropy.end()) - this->m_yBlockEntropy.begin()) * this->m_blockSize;
+                address = this->m_startAddress + (std::min_element(this->m_yBlockEntropy.begin(), this->m_yBlockEntropy.end()) - this->m_yBlockEntropy.begin()) * this->m_chunkSize;
             return address;
         }
 
@@ -511,13 +527,16 @@ namespace hex {
         }
 
         void processFinalize() {
-            // Only save at most m_sampleSize elements of the result
-            this->m_yBlockEntropy = sampleData(this->m_yBlockEntropy, std::min<size_t>(this->m_blockCount, this->m_sampleSize));
+            // Only display at most m_sampleSize elements of the result
+            this->m_ySampledBlockEntropy = sampleData(this->m_yBlockEntropy, std::min<size_t>(this->m_blockCount, this->m_sampleSize));
+            this->updatePlotPositions();
+        }
 
+        void updatePlotPositions() {
             size_t stride = std::max(1.0, double(
-                std::ceil((this->m_endAddress - this->m_startAddress) / this->m_blockSize) / this->m_yBlockEntropy.size())) + 1;
+                std::ceil((this->m_endAddress - this->m_startAddress) / this->m_blockSize) / this->m_ySampledBlockEntropy.size())) + 1;
 
-            this->m_blockCount = this->m_yBlockEntropy.size();
+            this->m_blockCount = this->m_ySampledBlockEntropy.size();
 
             // The m_xBlockEntropy attribute is used to specify the position of entropy values 
             // in the plot when the Y axis doesn't start at 0
@@ -556,10 +575,15 @@ namespace hex {
         // (useful for the iterative analysis)
         std::array<ImU64, 256> m_blockValueCounts;
 
+        // count * log2(count) for all small counts
+        std::vector<double> m_countEntropies;
+
         // Variable to hold the result of the chunk based
         // entropy analysis
         std::vector<double> m_xBlockEntropy;
         std::vector<double> m_yBlockEntropy;
+        // Part of the result that is displayed in the plot
+        std::vector<double> m_ySampledBlockEntropy;
 
         // Sampling size, number of elements displayed in the plot,
         // avoid showing to many data because it decreased the frame rate
@@ -623,10 +647,11 @@ namespace hex {
         this->m_processing = false;          
     }
 
-    // Process one byte at the time
-    void update(u8 byte) {
+    // Add the byte value counts of a part of the data
+    void update(const std::array<ImU64, 256> &valueCounts) {
         this->m_processing = true;
-        this->m_valueCounts[byte]++;
+        for (u32 value = 0; value < valueCounts.size(); value++)
+            this->m_valueCounts[value] += valueCounts[value];
         this->m_processing = false;           
     }
 
@@ -673,7 +698,7 @@ namespace hex {
                                                     };
 
                 for (u32 i = 0; i < Names.size(); i++) {
-                    ImPlot::PlotLine(Names[i], this->m_xBlockTypeDistributions.data(), this->m_yBlockTypeDistributions[i].data(), this->m_blockCount);
+                    ImPlot::PlotLine(Names[i], this->m_xBlockTypeDistributions.data(), this->m_ySampledBlockTypeDistributions[i].data(), this->m_blockCount);
                 }
 
                 // The parameter updateHandle is used when using the pattern language since we don't have a provider 
@@ -738,53 +763,62 @@ namespace hex {
         }
 
         // Reset the byte type distribution analysis
-        void reset(u64 startAddress, u64 endAddress, u64 baseAddress, u64 size) {
+        void reset(u64 chunkSize, u64 startAddress, u64 endAddress, u64 baseAddress, u64 size) {
             this->m_processing = true;
 
             // Update attributes  
+            this->m_chunkSize    = chunkSize;
             this->m_startAddress = startAddress;
             this->m_endAddress   = endAddress;
             this->m_baseAddress  = baseAddress; 
             this->m_fileSize     = size;
 
-            this->m_byteCount = 0;
-            this->m_blockCount = 0;
-            this->m_blockValueCounts = { 0 };
-
             // Reset and resize the array
             this->m_yBlockTypeDistributions.fill({});
             for (auto &blockDistribution : this->m_yBlockTypeDistributions)
-                blockDistribution.resize(((this->m_endAddress - this->m_startAddress) / this->m_blockSize) + 1);
+                blockDistribution.resize((this->m_endAddress - this->m_startAddress + this->m_chunkSize - 1) / this->m_chunkSize);
 
             // Set the diagram handle position to the start of the plot
             this->m_handlePosition = this->m_startAddress / double(this->m_blockSize);
         }
 
-        // Process one byte at the time
-        void update(u8 byte) {
-            u64 totalBlock = std::ceil((this->m_endAddress - this->m_startAddress) / this->m_blockSize);
-            // Check if there is still some block to process 
-            if (this->m_blockCount < totalBlock) {
+        /**
+         * @brief Sets the byte value counts of one chunk of the analyzed region
+         * Different chunks may be updated from different threads at the same time
+         * @param chunkIndex Index of the chunk
+         * @param valueCounts Number of occurrences of every byte value in the chunk
+         * @param chunkSize Size of the chunk. Only the last chunk may be smaller than the chunk size passed to reset()
+         */
+        void update(u64 chunkIndex, const std::array<ImU64, 256> &valueCounts, u64 chunkSize) {
+            auto typeDist = calculateTypeDistribution(valueCounts, chunkSize);
+            for (u8 i = 0; i < typeDist.size(); i++)
+                this->m_yBlockTypeDistributions[i][chunkIndex] = typeDist[i] * 100;
+        }
 
-                this->m_blockValueCounts[byte]++;
+        // Called once all chunks have been updated. May be called again after updating some of the chunks another time
+        void finish() {
+            this->m_blockCount = this->m_yBlockTypeDistributions[0].size();
+            if (this->m_blockCount > 0)
+                this->processFinalize();
 
-                this->m_byteCount++;
-                if (((this->m_byteCount % this->m_blockSize) == 0) || this->m_byteCount == (this->m_endAddress - this->m_startAddress)) [[unlikely]] {
-                    auto typeDist = calculateTypeDistribution(this->m_blockValueCounts, this->m_blockSize);
-                    for (u8 i = 0; i < typeDist.size(); i++)
-                        this->m_yBlockTypeDistributions[i][this->m_blockCount] = typeDist[i] * 100;
+            this->m_processing = false;
+        }
 
-                    this->m_blockCount += 1;
-                    this->m_blockValueCounts = { 0 };
-                }
-                
-                // Check if we processed the last block, if so setup the X axis part of the data
-                if (this->m_blockCount == totalBlock) {
+        // Return the type distributions displayed in the plot
+        const std::array<std::vector<float>, 12> &getSampledTypeDistributions() const {
+            return this->m_ySampledBlockTypeDistributions;
+        }
 
-                    processFinalize();
-                    this->m_processing = false;           
-                }
-            }
+        /**
+         * @brief Restores the plot of a previous analysis without the type distribution of every single chunk
+         * The plain text character percentage stays unknown until all chunks got updated and finish() got called again
+         * @param sampledTypeDistributions Distributions as returned by getSampledTypeDistributions(). All types need the same, non-zero number of entries
+         */
+        void setSampledTypeDistributions(std::array<std::vector<float>, 12> sampledTypeDistributions) {
+            this->m_ySampledBlockTypeDistributions = std::move(sampledTypeDistributions);
+            this->updatePlotPositions();
+
+            this->m_processing = false;
         }
 
         // Return the percentage of plain text character inside the analyzed region
@@ -798,7 +832,24 @@ namespace hex {
         }
 
     private:
-        std::array<float, 12> calculateTypeDistribution(std::array<ImU64, 256> &valueCounts, size_t blockSize) {
+        std::array<float, 12> calculateTypeDistribution(const std::array<ImU64, 256> &valueCounts, size_t blockSize) {
+            // Bit mask of the types every byte value belongs to, in the same order as they're plotted
+            static const auto ValueTypes = [] {
+                std::array<u16, 256> result = { };
+                for (int value = 0x00; value < int(result.size()); value++) {
+                    const std::array<bool, 12> types = {
+                        bool(std::iscntrl(value)), bool(std::isprint(value)), bool(std::isspace(value)), bool(std::isblank(value)),
+                        bool(std::isgraph(value)), bool(std::ispunct(value)), bool(std::isalnum(value)), bool(std::isalpha(value)),
+                        bool(std::isupper(value)), bool(std::islower(value)), bool(std::isdigit(value)), bool(std::isxdigit(value))
+                    };
+
+                    for (u32 type = 0; type < types.size(); type++)
+                        result[value] |= u16(types[type]) << type;
+                }
+
+                return result;
+            }();
+
             std::array<ImU64, 12> counts = {};
 
             for (u16 value = 0x00; value < u16(valueCounts.size()); value++) {
@@ -807,30 +858,8 @@ namespace hex {
                 if (count == 0) [[unlikely]]
                     continue;
 
-                if (std::iscntrl(value))
-                    counts[0] += count;
-                if (std::isprint(value))
-                    counts[1] += count;
-                if (std::isspace(value))
-                    counts[2] += count;
-                if (std::isblank(value))
-                    counts[3] += count;
-                if (std::isgraph(value))
-                    counts[4] += count;
-                if (std::ispunct(value))
-                    counts[5] += count;
-                if (std::isalnum(value))
-                    counts[6] += count;
-                if (std::isalpha(value))
-                    counts[7] += count;
-                if (std::isupper(value))
-                    counts[8] += count;
-                if (std::islower(value))
-                    counts[9] += count;
-                if (std::isdigit(value))
-                    counts[10] += count;
-                if (std::isxdigit(value))
-                    counts[11] += count;
+                for (u16 types = ValueTypes[value]; types != 0; types &= types - 1)
+                    counts[std::countr_zero(types)] += count;
             }
 
             std::array<float, 12> distribution = {};
@@ -870,12 +899,17 @@ namespace hex {
         }
 
         void processFinalize() {
-            // Only save at most m_sampleSize elements of the result
+            // Only display at most m_sampleSize elements of the result
             for (u8 i = 0; i < this->m_yBlockTypeDistributions.size(); ++i)
-                this->m_yBlockTypeDistributions[i] = sampleData(this->m_yBlockTypeDistributions[i], std::min<size_t>(this->m_blockCount, this->m_sampleSize));
+                this->m_ySampledBlockTypeDistributions[i] = sampleData(this->m_yBlockTypeDistributions[i], std::min<size_t>(this->m_blockCount, this->m_sampleSize));
 
-            size_t stride = std::max(1.0, double(this->m_blockCount / this->m_yBlockTypeDistributions[0].size())) + 1;
-            this->m_blockCount = this->m_yBlockTypeDistributions[0].size();
+            this->updatePlotPositions();
+        }
+
+        void updatePlotPositions() {
+            size_t stride = std::max(1.0, double(
+                std::ceil((this->m_endAddress - this->m_startAddress) / this->m_blockSize) / this->m_ySampledBlockTypeDistributions[0].size())) + 1;
+            this->m_blockCount = this->m_ySampledBlockTypeDistributions[0].size();
 
             // The m_xBlockTypeDistributions attribute is used to specify the position of entropy 
             // values in the plot when the Y axis doesn't start at 0
@@ -891,6 +925,8 @@ namespace hex {
 
         // The size of the block we are considering for the analysis
         u64 m_blockSize; 
+        // Size of the chunks the type distribution is calculated of
+        u64 m_chunkSize;
         u64 m_startAddress;
         u64 m_endAddress;
         // Start / size of the file
@@ -921,6 +957,8 @@ namespace hex {
         std::vector<float> m_xBlockTypeDistributions;
         // Hold the result of the byte distribution analysis 
         std::array<std::vector<float>, 12> m_yBlockTypeDistributions;
+        // Part of the result that is displayed in the plot
+        std::array<std::vector<float>, 12> m_ySampledBlockTypeDistributions;
         std::atomic<bool> m_processing = false;
     };
 }
@@ -1,18 +1,24 @@
 #pragma once
 
 #include <hex/api/content_registry.hpp>
+#include <hex/api/task.hpp>
 #include <hex/providers/provider.hpp>
+#include <hex/helpers/color_span_index.hpp>
 
 #include <pl/pattern_language.hpp>
 #include <hex/data_processor/attribute.hpp>
 #include <hex/data_processor/node.hpp>
 #include <hex/data_processor/link.hpp>
 
+#include <atomic>
 #include <map>
+#include <memory>
 
 #include <imnodes.h>
 #include <imnodes_internal.h>
 
+#include <IntervalTree.h>
+
 namespace hex::plugin::builtin {
 
     class ProviderExtraData {
@@ -60,11 +66,19 @@ namespace hex::plugin::builtin {
                 std::map<std::string, PatternVariable> patternVariables;
                 std::map<u64, pl::api::Section> sections;
 
+                // Colors of all visible patterns, built once after every evaluation. Only valid while no evaluation is running
+                ColorSpanIndex highlights;
+                std::map<u64, ColorSpanIndex> sectionHighlights;
+
                 std::list<EnvVar> envVarEntries;
             } patternLanguage;
 
             std::list<ImHexApi::Bookmarks::Entry> bookmarks;
 
+            // Bookmark regions together with the position of their bookmark in the list. Needs to be reset whenever bookmarks get added, removed or reordered
+            using BookmarkTree = interval_tree::IntervalTree<u64, std::pair<size_t, ImHexApi::Bookmarks::Entry*>>;
+            std::optional<BookmarkTree> bookmarkIndex;
+
             struct DataProcessor {
                 struct Workspace {
                     std::unique_ptr<ImNodesContext, void(*)(ImNodesContext*)> context = { []{
@@ -81,6 +95,9 @@ namespace hex::plugin::builtin {
                     std::list<dp::Link> links;
                     std::vector<hex::prv::Overlay *> dataOverlays;
                     std::optional<dp::Node::NodeError> currNodeError;
+
+                    // Nodes in the order they need to be evaluated in. Needs to be compiled again whenever nodes or links change
+                    std::optional<std::vector<dp::Node *>> executionPlan;
                 };
 
                 Workspace mainWorkspace;
@@ -93,7 +110,28 @@ namespace hex::plugin::builtin {
             } editor;
 
             struct Hashes {
+                // Calculation of one or more hash functions over the same region
+                struct Calculation {
+                    Region region;
+                    TaskHolder task;
+
+                    // Only valid once done is set
+                    std::atomic<bool> done = false;
+                    std::vector<std::vector<u8>> results;
+
+                    // Set if the task got cancelled or a hasher threw before all hashes were calculated
+                    std::atomic<bool> failed = false;
+                };
+
+                struct CalculationEntry {
+                    std::shared_ptr<Calculation> calculation;
+                    size_t resultIndex = 0;
+                };
+
                 std::vector<ContentRegistry::Hashes::Hash::Function> hashFunctions;
+
+                // Latest calculation of every hash function, in the same order as the functions
+                std::vector<CalculationEntry> calculations;
             } hashes;
 
             struct Yara {
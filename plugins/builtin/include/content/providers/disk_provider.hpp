@@ -52,6 +52,11 @@ namespace hex::plugin::builtin {
     protected:
         void reloadDrives();
 
+        constexpr static size_t DefaultSectorSize        = 512;
+        constexpr static size_t CacheBlockSize           = 0x1000;
+        constexpr static size_t CacheBlockCount          = 0x1000;
+        constexpr static size_t CacheReadAheadBlockCount = 16;
+
         std::set<std::string> m_availableDrives;
         std::fs::path m_path;
 
@@ -65,9 +70,6 @@ namespace hex::plugin::builtin {
         size_t m_diskSize   = 0;
         size_t m_sectorSize = 0;
 
-        u64 m_sectorBufferAddress = 0;
-        std::vector<u8> m_sectorBuffer;
-
         bool m_readable = false;
         bool m_writable = false;
     };
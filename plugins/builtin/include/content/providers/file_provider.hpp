@@ -4,6 +4,7 @@
 
 #include <wolv/io/file.hpp>
 
+#include <memory>
 #include <mutex>
 #include <string_view>
 
@@ -31,6 +32,8 @@ namespace hex::plugin::builtin {
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
         [[nodiscard]] size_t getActualSize() const override;
 
+        [[nodiscard]] std::optional<prv::DataView> getDataView(u64 offset, size_t size) override;
+
         void save() override;
         void saveAs(const std::fs::path &path) override;
 
@@ -56,14 +59,24 @@ namespace hex::plugin::builtin {
         [[nodiscard]] std::pair<Region, bool> getRegionValidity(u64 address) const override;
 
     private:
+        struct MappedFile;
+
         wolv::io::File& getFile();
 
+        void mapFile();
+        void unmapFile();
+        [[nodiscard]] std::shared_ptr<const MappedFile> getMappedFile(size_t actualSize);
+
     protected:
         std::fs::path m_path;
 
         wolv::io::File m_sizeFile;
         std::map<std::thread::id, wolv::io::File> m_files;
 
+        // Readers and data views hold a reference to the mapping so it only gets unmapped once nobody uses it anymore
+        std::shared_ptr<const MappedFile> m_mappedFile;
+        std::mutex m_mappingMutex;
+
         std::optional<struct stat> m_fileStats;
 
         bool m_readable = false, m_writable = false;
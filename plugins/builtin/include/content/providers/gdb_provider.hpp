@@ -4,10 +4,8 @@
 
 #include <wolv/utils/socket.hpp>
 
-#include <array>
-#include <mutex>
+#include <chrono>
 #include <string_view>
-#include <thread>
 
 namespace hex::plugin::builtin {
 
@@ -60,19 +58,10 @@ namespace hex::plugin::builtin {
 
         u64 m_size = 0;
 
-        constexpr static size_t CacheLineSize = 0x10;
-
-        struct CacheLine {
-            u64 address;
-
-            std::array<u8, CacheLineSize> data;
-        };
-
-        std::list<CacheLine> m_cache;
-        std::atomic<bool> m_resetCache = false;
-
-        std::thread m_cacheUpdateThread;
-        std::mutex m_cacheLock;
+        constexpr static size_t CacheBlockSize           = 0x100;
+        constexpr static size_t CacheBlockCount          = 0x400;
+        constexpr static size_t CacheReadAheadBlockCount = 3;
+        constexpr static auto CacheBlockMaxAge           = std::chrono::seconds(1);
     };
 
 }
\ No newline at end of file
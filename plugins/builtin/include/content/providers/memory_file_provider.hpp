@@ -3,6 +3,9 @@
 #include <hex/providers/provider.hpp>
 #include <hex/api/localization.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace hex::plugin::builtin {
 
     class MemoryFileProvider : public hex::prv::Provider {
@@ -21,7 +24,9 @@ namespace hex::plugin::builtin {
 
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
-        [[nodiscard]] size_t getActualSize() const override { return this->m_data.size(); }
+        [[nodiscard]] size_t getActualSize() const override { return this->m_data->size(); }
+
+        [[nodiscard]] std::optional<prv::DataView> getDataView(u64 offset, size_t size) override;
 
         void resize(size_t newSize) override;
         void insert(u64 offset, size_t size) override;
@@ -44,7 +49,8 @@ namespace hex::plugin::builtin {
         void setReadOnly(bool readOnly) { this->m_readOnly = readOnly; }
 
     private:
-        std::vector<u8> m_data;
+        // Shared with the data views handed out by getDataView
+        std::shared_ptr<std::vector<u8>> m_data = std::make_shared<std::vector<u8>>();
         bool m_readOnly = false;
     };
 
@@ -29,6 +29,14 @@ namespace hex::plugin::builtin {
         static std::unique_ptr<dp::Node> loadNode(const nlohmann::json &data);
         static void loadNodes(Workspace &workspace, const nlohmann::json &data);
 
+        /**
+         * @brief Evaluates all nodes of a workspace, compiling its execution plan first if the graph changed
+         * Nodes whose settings and inputs didn't change since the last evaluation aren't processed again
+         * @param workspace Workspace to evaluate
+         * @throws dp::Node::NodeError if a node failed to process
+         */
+        static void executeNodes(Workspace &workspace);
+
     private:
         static void eraseLink(Workspace &workspace, int id);
         static void eraseNodes(Workspace &workspace, const std::vector<int> &ids);
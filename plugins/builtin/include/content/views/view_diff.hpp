@@ -5,15 +5,18 @@
 #include <imgui.h>
 #include <hex/ui/view.hpp>
 #include <hex/api/task.hpp>
+#include <hex/helpers/binary_diff.hpp>
+#include <hex/helpers/block_hash_index.hpp>
 
 #include <array>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "ui/hex_editor.hpp"
 
-#include <IntervalTree.h>
-
 namespace hex::plugin::builtin {
 
     class ViewDiff : public View {
@@ -30,23 +33,44 @@ namespace hex::plugin::builtin {
             i32 scrollLock = 0;
         };
 
-        enum class DifferenceType : u8 {
-            Added,
-            Removed,
-            Modified
-        };
+        using DifferenceType = diff::DifferenceType;
+        using Diff = diff::Difference;
 
-        struct Diff {
+    private:
+        struct Highlight {
             Region region;
             DifferenceType type;
         };
 
+        /**
+         * @brief Creates the callback highlighting the differences in one of the hex editors
+         * @param column Index of the column
+         * @return Callback
+         */
+        std::function<std::optional<color_t>(u64, const u8 *, size_t)> createHighlightCallback(u32 column);
+
+        /**
+         * @brief Brings the block hash index of a provider up to date, creating it if necessary
+         * @param task Task to report progress to
+         * @param provider Provider to index
+         * @return Up to date index
+         */
+        std::shared_ptr<BlockHashIndex> updateBlockHashIndex(Task &task, prv::Provider *provider);
+
     private:
         std::array<Column, 2> m_columns;
 
         std::vector<Diff> m_diffs;
+
+        // Differences of each column sorted by address so cells can be highlighted without reading any data
+        std::array<std::vector<Highlight>, 2> m_highlights;
         TaskHolder m_diffTask;
         std::atomic<bool> m_analyzed = false;
+        std::atomic<bool> m_dataModified = false;
+
+        std::mutex m_blockHashMutex;
+        std::map<const prv::Provider *, std::shared_ptr<BlockHashIndex>> m_blockHashIndices;
+        std::map<const prv::Provider *, std::vector<Region>> m_modifiedRegions;
     };
 
 }
\ No newline at end of file
@@ -4,22 +4,15 @@
 #include <ui/widgets.hpp>
 
 #include <hex/helpers/disassembler.hpp>
+#include <hex/helpers/code_analysis.hpp>
 
 #include <cstdio>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace hex::plugin::builtin {
 
-    struct Disassembly {
-        u64 address;
-        u64 offset;
-        size_t size;
-        std::string bytes;
-        std::string mnemonic;
-        std::string operators;
-    };
-
     class ViewDisassembler : public View {
     public:
         explicit ViewDisassembler();
@@ -29,17 +22,64 @@ namespace hex::plugin::builtin {
 
     private:
         TaskHolder m_disassemblerTask;
+        TaskHolder m_analysisTask;
 
         u64 m_baseAddress   = 0;
+        u64 m_entryPoint    = 0;
         ui::SelectedRegion m_range = ui::SelectedRegion::EntireData;
         Region m_codeRegion = { 0, 0 };
 
         Architecture m_architecture = Architecture::ARM;
         cs_mode m_mode              = cs_mode(0);
 
-        std::vector<Disassembly> m_disassembly;
+        // Settings the current disassembly was created with. Instructions get decoded again using them when they're displayed
+        struct {
+            prv::Provider *provider = nullptr;
+            Region codeRegion = { 0, 0 };
+            u64 baseAddress = 0;
+            Architecture architecture = Architecture::ARM;
+            cs_mode mode = cs_mode(0);
+        } m_disassembledSettings;
+
+        // Only the instruction boundaries get stored. Every instruction's size is stored in a single byte together with the offset of
+        // every CheckpointInterval'th instruction, so the offset of any instruction can be calculated quickly
+        constexpr static u64 CheckpointInterval = 256;
+        std::vector<u8> m_instructionSizes;
+        std::vector<u64> m_instructionCheckpoints;
+
+        csh m_capstoneHandle = 0;
+
+        // Result of the recursive descent analysis and the settings it was created with
+        struct {
+            prv::Provider *provider = nullptr;
+            Region codeRegion = { 0, 0 };
+            u64 baseAddress = 0;
+        } m_analyzedSettings;
+        std::optional<CodeAnalysis> m_analysis;
+
+        u64 m_referencedAddress = 0;
+        u32 m_highlightProviderId = 0;
 
         void disassemble();
+        void analyze();
+        void reset();
+
+        /**
+         * @brief Converts an address of the analyzed code to an address of the provider containing it
+         * @param address Address in the code's address space
+         * @return Address in the provider
+         */
+        [[nodiscard]] u64 toProviderAddress(u64 address) const;
+
+        /**
+         * @brief Calculates the offset of an instruction relative to the start of the disassembled region
+         * @param index Index of the instruction
+         * @return Offset of the instruction
+         */
+        [[nodiscard]] u64 getInstructionOffset(u64 index) const;
+
+        void drawDisassembly();
+        void drawAnalysis();
     };
 
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include <imgui.h>
 #include <hex/ui/view.hpp>
+#include <hex/helpers/byte_pattern.hpp>
+#include <hex/helpers/byte_regex.hpp>
 #include <ui/widgets.hpp>
 
 #include <atomic>
@@ -28,9 +30,7 @@ namespace hex::plugin::builtin {
             std::endian endian = std::endian::native;
         };
 
-        struct BinaryPattern {
-            u8 mask, value;
-        };
+        using BinaryPattern = BytePattern::Byte;
 
         struct SearchSettings {
             ui::SelectedRegion range = ui::SelectedRegion::EntireData;
@@ -64,7 +64,7 @@ namespace hex::plugin::builtin {
             } bytes;
 
             struct Regex {
-                int minLength = 5;
+                int minLength = 1;
                 bool nullTermination = false;
                 StringType type = StringType::ASCII;
 
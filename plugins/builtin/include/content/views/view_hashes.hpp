@@ -5,8 +5,10 @@
 #include <hex/ui/view.hpp>
 
 #include <array>
+#include <optional>
 #include <utility>
 #include <cstdio>
+#include <vector>
 
 namespace hex::plugin::builtin {
 
@@ -21,6 +23,31 @@ namespace hex::plugin::builtin {
         static bool importHashes(prv::Provider *provider, const nlohmann::json &json);
         static bool exportHashes(prv::Provider *provider, nlohmann::json &json);
 
+        /**
+         * @brief Gets the result of a hash function. The hash gets calculated on a worker thread if it wasn't calculated for that region already
+         * @param provider Provider the hash function belongs to
+         * @param index Index of the hash function
+         * @param region Region to hash
+         * @return Hash or std::nullopt while it's still being calculated or if calculating it failed
+         */
+        static std::optional<std::vector<u8>> getHash(prv::Provider *provider, u32 index, const Region &region);
+
+        /**
+         * @brief Checks if the last calculation of a hash function got cancelled or failed. It only gets started again once a different region is hashed
+         * @param provider Provider the hash function belongs to
+         * @param index Index of the hash function
+         * @return True if the calculation failed
+         */
+        static bool hasHashFailed(prv::Provider *provider, u32 index);
+
+        /**
+         * @brief Starts calculating all hashes that haven't been calculated for a region yet in a single pass over the data
+         * @param provider Provider the hash functions belong to
+         * @param region Region to hash
+         */
+        static void startCalculation(prv::Provider *provider, const Region &region);
+        static void cancelCalculations(prv::Provider *provider);
+
     private:
         ContentRegistry::Hashes::Hash *m_selectedHash = nullptr;
         std::string m_newHashName;
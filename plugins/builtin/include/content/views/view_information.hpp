@@ -2,12 +2,17 @@
 
 #include <hex/ui/view.hpp>
 #include <hex/api/task.hpp>
+#include <hex/helpers/block_value_counts.hpp>
+#include <hex/helpers/tar.hpp>
 
 #include "content/helpers/diagrams.hpp"
 
 #include <array>
 #include <atomic>
 #include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -21,31 +26,59 @@ namespace hex::plugin::builtin {
         void drawContent() override;
 
     private:
-        bool m_dataValid = false;
-        u32 m_blockSize = 0;
-        double m_averageEntropy = -1.0;
+        /**
+         * @brief Results of the analysis of one provider
+         * Besides the diagrams, the byte value counts of every summary block are kept around so only the blocks
+         * overlapping modified regions need to be analyzed again after the data got modified
+         */
+        struct Analysis {
+            bool dataValid = false;
+            // Results restored from a project only contain the plots, not the values of every single chunk
+            bool chunksAnalyzed = false;
+            double averageEntropy = -1.0;
 
-        double m_highestBlockEntropy = -1.0;
-        u64 m_highestBlockEntropyAddress = 0x00;
-        double m_lowestBlockEntropy = -1.0;
-        u64 m_lowestBlockEntropyAddress = 0x00;
+            double highestBlockEntropy = -1.0;
+            u64 highestBlockEntropyAddress = 0x00;
+            double lowestBlockEntropy = -1.0;
+            u64 lowestBlockEntropyAddress = 0x00;
 
-        double m_plainTextCharacterPercentage = -1.0;
+            double plainTextCharacterPercentage = -1.0;
 
-        TaskHolder m_analyzerTask;
+            Region analyzedRegion = { 0, 0 };
+            u64 chunkSize = 0;
+            size_t dataSize = 0;
+
+            std::string dataDescription;
+            std::string dataMimeType;
+
+            BlockValueCounts blockValueCounts;
+
+            DiagramDigram digram;
+            DiagramLayeredDistribution layeredDistribution;
+            DiagramByteDistribution byteDistribution;
+            DiagramByteTypesDistribution byteTypesDistribution;
+            DiagramChunkBasedEntropyAnalysis chunkBasedEntropy;
+        };
 
-        Region m_analyzedRegion = { 0, 0 };
+        std::shared_ptr<Analysis> getAnalysis(const prv::Provider *provider);
 
-        std::string m_dataDescription;
-        std::string m_dataMimeType;
+        void analyze(prv::Provider *provider, Region region, u64 chunkSize);
+        void analyzeModifications(prv::Provider *provider);
 
-        DiagramDigram m_digram;
-        DiagramLayeredDistribution m_layeredDistribution;
-        DiagramByteDistribution m_byteDistribution;
-        DiagramByteTypesDistribution m_byteTypesDistribution;
-        DiagramChunkBasedEntropyAnalysis m_chunkBasedEntropy;
+        static void resetAnalysis(Analysis &analysis, prv::Provider *provider, Region region, u64 chunkSize);
+        static void analyzeBlocks(Task &task, Analysis &analysis, prv::Provider *provider, Region region);
+        static void updateResults(Analysis &analysis);
+
+        static bool storeAnalysis(const Analysis &analysis, const std::fs::path &basePath, Tar &tar);
+        static std::shared_ptr<Analysis> loadAnalysis(prv::Provider *provider, const std::fs::path &basePath, Tar &tar);
+
+    private:
+        TaskHolder m_analyzerTask;
 
-        void analyze();
+        std::mutex m_analysisMutex;
+        std::map<const prv::Provider *, std::shared_ptr<Analysis>> m_analyses;
+        // Regions modified since the last analysis, sorted by address and merged wherever they overlap
+        std::map<const prv::Provider *, std::vector<Region>> m_modifiedRegions;
 
         // User controlled input (referenced by ImgGui)
         int m_inputChunkSize    = 0;
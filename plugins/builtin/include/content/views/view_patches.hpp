@@ -17,7 +17,7 @@ namespace hex::plugin::builtin {
         void drawContent() override;
 
     private:
-        u64 m_selectedPatch = 0x00;
+        Region m_selectedPatch = Region::Invalid();
     };
 
 }
\ No newline at end of file
@@ -7,6 +7,12 @@
 
 #include <hex/api/task.hpp>
 
+#include <map>
+#include <memory>
+#include <mutex>
+
+struct YR_RULES;
+
 namespace hex::plugin::builtin {
 
     class ViewYara : public View {
@@ -17,13 +23,33 @@ namespace hex::plugin::builtin {
         void drawContent() override;
 
     private:
+        struct CompiledRules {
+            std::fs::file_time_type lastWriteTime;
+            std::shared_ptr<YR_RULES> rules;
+
+            // Number of bytes consecutive blocks need to overlap so no match can get split between two of them
+            u64 overlapSize = 0;
+
+            std::string error;
+        };
+
         u32 m_selectedRule = 0;
         TaskHolder m_matcherTask;
 
         std::vector<std::string> m_consoleMessages;
 
+        std::mutex m_compiledRulesMutex;
+        std::map<std::fs::path, CompiledRules> m_compiledRules;
+
         void applyRules();
         void clearResult();
+
+        /**
+         * @brief Gets the compiled rules of a rule file. The file only gets compiled again if it changed since the last time
+         * @param path Path of the rule file
+         * @return Compiled rules or the error that occurred while compiling them
+         */
+        CompiledRules getCompiledRules(const std::fs::path &path);
     };
 
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <hex.hpp>
 #include <hex/api/imhex_api.hpp>
 #include <hex/api/content_registry.hpp>
+#include <hex/api/task.hpp>
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/encoding_file.hpp>
 
@@ -17,6 +18,8 @@
 #include <hex/providers/provider.hpp>
 #include <hex/providers/buffered_reader.hpp>
 
+#include <atomic>
+
 namespace hex::plugin::builtin::ui {
 
     class HexEditor {
@@ -26,6 +29,12 @@ namespace hex::plugin::builtin::ui {
         void draw(float height = ImGui::GetContentRegionAvail().y);
 
         void setProvider(prv::Provider *provider) {
+            // Views pass their provider every frame. The caches only need to be dropped once it actually changes
+            if (this->m_provider != provider) {
+                this->resetEncodingLineIndex();
+                this->invalidateHighlights();
+            }
+
             this->m_provider = provider;
             this->m_currValidRegion = { Region::Invalid(), false };
         }
@@ -38,6 +47,12 @@ namespace hex::plugin::builtin::ui {
         void drawEditor(const ImVec2 &size);
         void drawFooter(const ImVec2 &size);
         void drawTooltip(u64 address, const u8 *data, size_t size);
+        void updateHighlightCache(const Region &visibleRegion);
+        [[nodiscard]] std::optional<color_t> getCachedHighlightColor(const std::vector<std::optional<color_t>> &colors, u64 address, size_t size) const;
+
+        void updateEncodingLineIndex();
+        void resetEncodingLineIndex();
+        void decodeEncodingRows(u64 firstRow, u64 lastRow);
 
         void handleSelection(u64 address, u32 bytesPerCell, const u8 *data, bool cellHovered);
         std::optional<color_t> applySelectionColor(u64 byteAddress, std::optional<color_t> color);
@@ -152,7 +167,7 @@ namespace hex::plugin::builtin::ui {
 
         void setCustomEncoding(EncodingFile encoding) {
             this->m_currCustomEncoding = std::move(encoding);
-            this->m_encodingLineStartAddresses.clear();
+            this->resetEncodingLineIndex();
         }
 
         void forceUpdateScrollPosition() {
@@ -167,6 +182,20 @@ namespace hex::plugin::builtin::ui {
             this->m_backgroundColorCallback = callback;
         }
 
+        void setForegroundHighlightRegionCallback(const std::function<std::vector<ImHexApi::HexEditor::Highlighting>(const Region &)> &callback) {
+            this->m_foregroundRegionCallback = callback;
+            this->invalidateHighlights();
+        }
+
+        void setBackgroundHighlightRegionCallback(const std::function<std::vector<ImHexApi::HexEditor::Highlighting>(const Region &)> &callback) {
+            this->m_backgroundRegionCallback = callback;
+            this->invalidateHighlights();
+        }
+
+        void invalidateHighlights() {
+            this->m_highlightCacheValid = false;
+        }
+
         void setTooltipCallback(const std::function<void(u64, const u8 *, size_t)> &callback) {
             this->m_tooltipCallback = callback;
         }
@@ -216,15 +245,58 @@ namespace hex::plugin::builtin::ui {
         bool m_syncScrolling = false;
         u32 m_byteCellPadding = 0, m_characterCellPadding = 0;
 
+        // Can be invalidated from any thread. Copies of the editor start out with an invalid cache
+        struct CacheValidity : std::atomic<bool> {
+            CacheValidity() : std::atomic<bool>(false) { }
+            CacheValidity(const CacheValidity &) : std::atomic<bool>(false) { }
+            CacheValidity &operator=(const CacheValidity &) { this->store(false); return *this; }
+
+            using std::atomic<bool>::operator=;
+        };
+
         std::optional<EncodingFile> m_currCustomEncoding;
-        std::vector<u64> m_encodingLineStartAddresses;
+
+        // Offset of the first character starting in every EncodingCheckpointInterval'th row when decoding the data with the custom encoding.
+        // They're calculated in the background so any row can be decoded by walking forward from the closest checkpoint
+        constexpr static u64 EncodingCheckpointInterval = 64;
+        struct EncodingLineIndex {
+            prv::Provider *provider = nullptr;
+            u64 startAddress = 0;
+            u16 bytesPerRow = 0;
+
+            std::mutex mutex;
+            std::vector<u32> checkpoints;
+        };
+        std::shared_ptr<EncodingLineIndex> m_encodingLineIndex;
+        TaskHolder m_encodingIndexTask;
+        CacheValidity m_encodingLineIndexValid;
+
+        // Offset of the first character in every visible row together with the data needed to decode them
+        std::vector<u64> m_encodingRowOffsets;
+        std::vector<u8> m_encodingData;
+        u64 m_encodingDataOffset = 0;
 
         std::pair<Region, bool> m_currValidRegion = { Region::Invalid(), false };
 
+        // Buffers reused between frames so drawing doesn't need to allocate memory for every row
+        std::vector<u8> m_visibleData;
+        std::vector<std::tuple<std::optional<color_t>, std::optional<color_t>>> m_rowCellColors;
+
         static inline std::optional<color_t> defaultColorCallback(u64, const u8 *, size_t) { return std::nullopt; }
         static inline void defaultTooltipCallback(u64, const u8 *, size_t) {  }
         std::function<std::optional<color_t>(u64, const u8 *, size_t)> m_foregroundColorCallback = defaultColorCallback, m_backgroundColorCallback = defaultColorCallback;
         std::function<void(u64, const u8 *, size_t)> m_tooltipCallback = defaultTooltipCallback;
+
+        static inline std::vector<ImHexApi::HexEditor::Highlighting> defaultRegionCallback(const Region &) { return { }; }
+        std::function<std::vector<ImHexApi::HexEditor::Highlighting>(const Region &)> m_foregroundRegionCallback = defaultRegionCallback, m_backgroundRegionCallback = defaultRegionCallback;
+
+        // Colors of every byte in and around the visible rows as returned by the region callbacks.
+        // They're only queried again once the rows scroll out of the cached region or the highlightings change
+        struct HighlightCache {
+            Region region = Region::Invalid();
+            std::vector<std::optional<color_t>> foregroundColors, backgroundColors;
+        } m_highlightCache;
+        CacheValidity m_highlightCacheValid;
     };
 
 }
\ No newline at end of file
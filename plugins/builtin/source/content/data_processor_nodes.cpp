@@ -447,6 +447,9 @@ namespace hex::plugin::builtin {
     public:
         NodeReadData() : Node("hex.builtin.nodes.data_access.read.header", { dp::Attribute(dp::Attribute::IOType::In, dp::Attribute::Type::Integer, "hex.builtin.nodes.data_access.read.address"), dp::Attribute(dp::Attribute::IOType::In, dp::Attribute::Type::Integer, "hex.builtin.nodes.data_access.read.size"), dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.data_access.read.data") }) { }
 
+        // The data read depends on the provider's content
+        [[nodiscard]] bool isVolatile() const override { return true; }
+
         void process() override {
             const auto &address = this->getIntegerOnInput(0);
             const auto &size    = this->getIntegerOnInput(1);
@@ -464,6 +467,9 @@ namespace hex::plugin::builtin {
     public:
         NodeWriteData() : Node("hex.builtin.nodes.data_access.write.header", { dp::Attribute(dp::Attribute::IOType::In, dp::Attribute::Type::Integer, "hex.builtin.nodes.data_access.write.address"), dp::Attribute(dp::Attribute::IOType::In, dp::Attribute::Type::Buffer, "hex.builtin.nodes.data_access.write.data") }) { }
 
+        // The overlay the data is written to may have been recreated
+        [[nodiscard]] bool isVolatile() const override { return true; }
+
         void process() override {
             const auto &address = this->getIntegerOnInput(0);
             const auto &data    = this->getBufferOnInput(1);
@@ -476,6 +482,9 @@ namespace hex::plugin::builtin {
     public:
         NodeDataSize() : Node("hex.builtin.nodes.data_access.size.header", { dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Integer, "hex.builtin.nodes.data_access.size.size") }) { }
 
+        // The size depends on the provider
+        [[nodiscard]] bool isVolatile() const override { return true; }
+
         void process() override {
             auto size = ImHexApi::Provider::get()->getActualSize();
 
@@ -496,6 +505,9 @@ namespace hex::plugin::builtin {
             EventManager::unsubscribe<EventRegionSelected>(this);
         }
 
+        // The selection changes independently of the node's settings
+        [[nodiscard]] bool isVolatile() const override { return true; }
+
         void process() override {
             this->setIntegerOnOutput(0, this->m_address);
             this->setIntegerOnOutput(1, this->m_size);
@@ -1165,6 +1177,9 @@ namespace hex::plugin::builtin {
             ImGui::PopItemWidth();
         }
 
+        // Out variables change whenever the pattern gets evaluated again
+        [[nodiscard]] bool isVolatile() const override { return true; }
+
         void process() override {
             auto &pl = ProviderExtraData::getCurrent().patternLanguage;
 
@@ -1233,6 +1248,9 @@ namespace hex::plugin::builtin {
             }
         }
 
+        // The value is set by the custom node containing this node
+        [[nodiscard]] bool isVolatile() const override { return true; }
+
         void process() override {
             std::visit(wolv::util::overloaded {
                 [this](i128 value) { this->setIntegerOnOutput(0, value); },
@@ -1366,6 +1384,9 @@ namespace hex::plugin::builtin {
             ImGui::PopItemWidth();
         }
 
+        // The nodes inside the custom node decide themselves whether they need to be processed again
+        [[nodiscard]] bool isVolatile() const override { return true; }
+
         void process() override {
             auto indexFromId = [this](u32 id) -> std::optional<u32> {
                 const auto &attributes = this->getAttributes();
@@ -1407,14 +1428,7 @@ namespace hex::plugin::builtin {
             }
 
             // Process all nodes in our workspace
-            for (auto &endNode : this->m_workspace.endNodes) {
-                endNode->resetOutputData();
-
-                for (auto &node : this->m_workspace.nodes)
-                    node->resetProcessedInputs();
-
-                endNode->process();
-            }
+            ViewDataProcessor::executeNodes(this->m_workspace);
 
             // Forward output node values to outputs
             for (auto &attribute : this->getAttributes()) {
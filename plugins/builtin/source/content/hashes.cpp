@@ -13,11 +13,7 @@ namespace hex::plugin::builtin {
         HashMD5() : Hash("hex.builtin.hash.md5") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::md5(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::md5Hasher);
         }
 
         [[nodiscard]] nlohmann::json store() const override { return { }; }
@@ -29,11 +25,7 @@ namespace hex::plugin::builtin {
         HashSHA1() : Hash("hex.builtin.hash.sha1") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha1(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::sha1Hasher);
         }
 
         [[nodiscard]] nlohmann::json store() const override { return { }; }
@@ -45,11 +37,7 @@ namespace hex::plugin::builtin {
         HashSHA224() : Hash("hex.builtin.hash.sha224") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha224(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::sha224Hasher);
         }
 
         [[nodiscard]] nlohmann::json store() const override { return { }; }
@@ -61,11 +49,7 @@ namespace hex::plugin::builtin {
         HashSHA256() : Hash("hex.builtin.hash.sha256") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha256(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::sha256Hasher);
         }
 
         [[nodiscard]] nlohmann::json store() const override { return { }; }
@@ -77,11 +61,7 @@ namespace hex::plugin::builtin {
         HashSHA384() : Hash("hex.builtin.hash.sha384") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha384(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::sha384Hasher);
         }
 
         [[nodiscard]] nlohmann::json store() const override { return { }; }
@@ -93,11 +73,7 @@ namespace hex::plugin::builtin {
         HashSHA512() : Hash("hex.builtin.hash.sha512") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha512(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::sha512Hasher);
         }
 
         [[nodiscard]] nlohmann::json store() const override { return { }; }
@@ -107,7 +83,7 @@ namespace hex::plugin::builtin {
     template<typename T>
     class HashCRC : public ContentRegistry::Hashes::Hash {
     public:
-        using CRCFunction = T(*)(prv::Provider*&, u64, size_t, u32, u32, u32, bool, bool);
+        using CRCFunction = std::unique_ptr<crypt::Hasher>(*)(u32, u32, u32, bool, bool);
         HashCRC(const std::string &name, const CRCFunction &crcFunction, u32 polynomial, u32 initialValue, u32 xorOut, bool reflectIn = false, bool reflectOut = false)
             : Hash(name), m_crcFunction(crcFunction), m_polynomial(polynomial), m_initialValue(initialValue), m_xorOut(xorOut), m_reflectIn(reflectIn), m_reflectOut(reflectOut) {}
 
@@ -123,13 +99,8 @@ namespace hex::plugin::builtin {
         }
 
         Function create(std::string name) override {
-            return Hash::create(name, [hash = *this](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto result = hash.m_crcFunction(provider, region.address, region.size, hash.m_polynomial, hash.m_initialValue, hash.m_xorOut, hash.m_reflectIn, hash.m_reflectOut);
-
-                std::vector<u8> bytes(sizeof(result), 0x00);
-                std::memcpy(bytes.data(), &result, bytes.size());
-
-                return bytes;
+            return Hash::create(name, [hash = *this] {
+                return hash.m_crcFunction(hash.m_polynomial, hash.m_initialValue, hash.m_xorOut, hash.m_reflectIn, hash.m_reflectOut);
             });
         }
 
@@ -173,12 +144,12 @@ namespace hex::plugin::builtin {
         ContentRegistry::Hashes::add<HashSHA384>();
         ContentRegistry::Hashes::add<HashSHA512>();
 
-        ContentRegistry::Hashes::add<HashCRC<u8>>("hex.builtin.hash.crc8",  crypt::crc8,  0x07,        0x0000,      0x0000);
-        ContentRegistry::Hashes::add<HashCRC<u16>>("hex.builtin.hash.crc16", crypt::crc16, 0x8005,      0x0000,      0x0000);
-        ContentRegistry::Hashes::add<HashCRC<u32>>("hex.builtin.hash.crc32", crypt::crc32, 0x04C1'1DB7, 0xFFFF'FFFF, 0xFFFF'FFFF);
-        ContentRegistry::Hashes::add<HashCRC<u32>>("hex.builtin.hash.crc32mpeg",  crypt::crc32, 0x04C1'1DB7, 0xFFFF'FFFF, 0x0000'0000, false, false);
-        ContentRegistry::Hashes::add<HashCRC<u32>>("hex.builtin.hash.crc32posix", crypt::crc32, 0x04C1'1DB7, 0x0000'0000, 0xFFFF'FFFF, false, false);
-        ContentRegistry::Hashes::add<HashCRC<u32>>("hex.builtin.hash.crc32c",     crypt::crc32, 0x1EDC'6F41, 0xFFFF'FFFF, 0xFFFF'FFFF, true,  true);
+        ContentRegistry::Hashes::add<HashCRC<u8>>("hex.builtin.hash.crc8",  crypt::crc8Hasher,  0x07,        0x0000,      0x0000);
+        ContentRegistry::Hashes::add<HashCRC<u16>>("hex.builtin.hash.crc16", crypt::crc16Hasher, 0x8005,      0x0000,      0x0000);
+        ContentRegistry::Hashes::add<HashCRC<u32>>("hex.builtin.hash.crc32", crypt::crc32Hasher, 0x04C1'1DB7, 0xFFFF'FFFF, 0xFFFF'FFFF);
+        ContentRegistry::Hashes::add<HashCRC<u32>>("hex.builtin.hash.crc32mpeg",  crypt::crc32Hasher, 0x04C1'1DB7, 0xFFFF'FFFF, 0x0000'0000, false, false);
+        ContentRegistry::Hashes::add<HashCRC<u32>>("hex.builtin.hash.crc32posix", crypt::crc32Hasher, 0x04C1'1DB7, 0x0000'0000, 0xFFFF'FFFF, false, false);
+        ContentRegistry::Hashes::add<HashCRC<u32>>("hex.builtin.hash.crc32c",     crypt::crc32Hasher, 0x1EDC'6F41, 0xFFFF'FFFF, 0xFFFF'FFFF, true,  true);
     }
 
 }
\ No newline at end of file
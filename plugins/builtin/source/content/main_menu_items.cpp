@@ -102,13 +102,13 @@ namespace hex::plugin::builtin {
                         return;
                     }
 
-                    task.setMaxValue(patch->size());
+                    task.setMaxValue(patch->getExtentCount());
 
                     auto provider = ImHexApi::Provider::get();
 
                     u64 progress = 0;
-                    for (auto &[address, value] : *patch) {
-                        provider->addPatch(address, &value, 1);
+                    for (const auto &[address, bytes] : *patch) {
+                        provider->addPatch(address, bytes.data(), bytes.size());
                         progress++;
                         task.update(progress);
                     }
@@ -128,13 +128,13 @@ namespace hex::plugin::builtin {
                         return;
                     }
 
-                    task.setMaxValue(patch->size());
+                    task.setMaxValue(patch->getExtentCount());
 
                     auto provider = ImHexApi::Provider::get();
 
                     u64 progress = 0;
-                    for (auto &[address, value] : *patch) {
-                        provider->addPatch(address, &value, 1);
+                    for (const auto &[address, bytes] : *patch) {
+                        provider->addPatch(address, bytes.data(), bytes.size());
                         progress++;
                         task.update(progress);
                     }
@@ -157,22 +157,30 @@ namespace hex::plugin::builtin {
 
                     const auto baseAddress = provider->getBaseAddress();
 
-                    std::map<u64, u8> patches;
-                    for (u64 i = 0; i < patchData.size(); i++) {
-                        u8 value = 0;
-                        provider->read(baseAddress + i, &value, 1);
+                    task.setMaxValue(patchData.size());
 
-                        if (value != patchData[i])
-                            patches[baseAddress + i] = patchData[i];
-                    }
+                    std::vector<u8> buffer(0x10'0000);
+                    for (u64 chunkOffset = 0; chunkOffset < patchData.size(); chunkOffset += buffer.size()) {
+                        const auto chunkSize = std::min<size_t>(buffer.size(), patchData.size() - chunkOffset);
+                        provider->read(baseAddress + chunkOffset, buffer.data(), chunkSize);
 
-                    task.setMaxValue(patches.size());
+                        // Add every run of modified bytes as a single patch
+                        u64 i = 0;
+                        while (i < chunkSize) {
+                            if (buffer[i] == patchData[chunkOffset + i]) {
+                                i++;
+                                continue;
+                            }
 
-                    u64 progress = 0;
-                    for (auto &[address, value] : patches) {
-                        provider->addPatch(address, &value, 1);
-                        progress++;
-                        task.update(progress);
+                            u64 runEnd = i + 1;
+                            while (runEnd < chunkSize && buffer[runEnd] != patchData[chunkOffset + runEnd])
+                                runEnd++;
+
+                            provider->addPatch(baseAddress + chunkOffset + i, &patchData[chunkOffset + i], runEnd - i);
+                            i = runEnd;
+                        }
+
+                        task.update(chunkOffset + chunkSize);
                     }
 
                     provider->createUndoPoint();
@@ -217,7 +225,7 @@ namespace hex::plugin::builtin {
             if (!patches.contains(0x00454F45) && patches.contains(0x00454F46)) {
                 u8 value = 0;
                 provider->read(0x00454F45, &value, sizeof(u8));
-                patches[0x00454F45] = value;
+                patches.set(0x00454F45, value);
             }
 
             TaskManager::createTask("hex.builtin.common.processing", TaskManager::NoProgress, [patches](auto &) {
@@ -250,7 +258,7 @@ namespace hex::plugin::builtin {
             if (!patches.contains(0x45454F45) && patches.contains(0x45454F46)) {
                 u8 value = 0;
                 provider->read(0x45454F45, &value, sizeof(u8));
-                patches[0x45454F45] = value;
+                patches.set(0x45454F45, value);
             }
 
             TaskManager::createTask("hex.builtin.common.processing", TaskManager::NoProgress, [patches](auto &) {
@@ -98,7 +98,6 @@ namespace hex::plugin::builtin {
                         nullptr)) {
                     this->m_diskSize   = diskGeometry.DiskSize.QuadPart;
                     this->m_sectorSize = diskGeometry.Geometry.BytesPerSector;
-                    this->m_sectorBuffer.resize(this->m_sectorSize);
                 }
             }
 
@@ -140,6 +139,13 @@ namespace hex::plugin::builtin {
 
         #endif
 
+        if (this->m_sectorSize == 0)
+            this->m_sectorSize = DefaultSectorSize;
+
+        // Disk accesses are slow, keep recently read areas around. Blocks are made up of whole sectors so every block can be read in one go
+        const auto blockSize = std::max<size_t>(CacheBlockSize / this->m_sectorSize, 1) * this->m_sectorSize;
+        this->enableBlockCache(blockSize, CacheBlockCount, CacheReadAheadBlockCount);
+
         return true;
     }
 
@@ -159,54 +165,45 @@ namespace hex::plugin::builtin {
             this->m_diskHandle = -1;
 
         #endif
+
+        this->disableBlockCache();
     }
 
     void DiskProvider::readRaw(u64 offset, void *buffer, size_t size) {
-        #if defined(OS_WINDOWS)
-
-            DWORD bytesRead = 0;
-
-            u64 startOffset = offset;
-
-            while (size > 0) {
-                LARGE_INTEGER seekPosition;
-                seekPosition.LowPart  = (offset & 0xFFFF'FFFF) - (offset % this->m_sectorSize);
-                seekPosition.HighPart = offset >> 32;
+        if (size == 0)
+            return;
+
+        // Disks can only be read in whole sectors, go through a temporary buffer if the requested range isn't sector aligned
+        const u64 alignedOffset  = offset - (offset % this->m_sectorSize);
+        const size_t alignedSize = ((offset + size - alignedOffset) + this->m_sectorSize - 1) / this->m_sectorSize * this->m_sectorSize;
+
+        std::vector<u8> sectorBuffer;
+        auto readBuffer = static_cast<u8 *>(buffer);
+        if (alignedOffset != offset || alignedSize != size) {
+            sectorBuffer.resize(alignedSize);
+            readBuffer = sectorBuffer.data();
+        }
 
-                if (this->m_sectorBufferAddress != static_cast<u64>(seekPosition.QuadPart)) {
-                    ::SetFilePointer(this->m_diskHandle, seekPosition.LowPart, &seekPosition.HighPart, FILE_BEGIN);
-                    ::ReadFile(this->m_diskHandle, this->m_sectorBuffer.data(), this->m_sectorBuffer.size(), &bytesRead, nullptr);
-                    this->m_sectorBufferAddress = seekPosition.QuadPart;
-                }
+        #if defined(OS_WINDOWS)
 
-                std::memcpy(reinterpret_cast<u8 *>(buffer) + (offset - startOffset), this->m_sectorBuffer.data() + (offset & (this->m_sectorSize - 1)), std::min(this->m_sectorSize, size));
+            LARGE_INTEGER seekPosition;
+            seekPosition.QuadPart = alignedOffset;
 
-                size = std::max<ssize_t>(static_cast<ssize_t>(size) - this->m_sectorSize, 0);
-                offset += this->m_sectorSize;
-            }
+            DWORD bytesRead = 0;
+            ::SetFilePointerEx(this->m_diskHandle, seekPosition, nullptr, FILE_BEGIN);
+            if (!::ReadFile(this->m_diskHandle, readBuffer, alignedSize, &bytesRead, nullptr))
+                return;
 
         #else
 
-        u64 startOffset    = offset;
-
-        while (size > 0) {
-            u64 seekPosition = offset - (offset % this->m_sectorSize);
-
-            if (this->m_sectorBufferAddress != seekPosition) {
-                ::lseek(this->m_diskHandle, seekPosition, SEEK_SET);
-                if (::read(this->m_diskHandle, buffer, size) < 0)
-                    break;
-
-                this->m_sectorBufferAddress = seekPosition;
-            }
-
-            std::memcpy(reinterpret_cast<u8 *>(buffer) + (offset - startOffset), this->m_sectorBuffer.data() + (offset & (this->m_sectorSize - 1)), std::min(this->m_sectorSize, size));
-
-            size = std::max<ssize_t>(static_cast<ssize_t>(size) - this->m_sectorSize, 0);
-            offset += this->m_sectorSize;
-        }
+            ::lseek(this->m_diskHandle, alignedOffset, SEEK_SET);
+            if (::read(this->m_diskHandle, readBuffer, alignedSize) < 0)
+                return;
 
         #endif
+
+        if (!sectorBuffer.empty())
+            std::memcpy(buffer, sectorBuffer.data() + (offset - alignedOffset), size);
     }
 
     void DiskProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
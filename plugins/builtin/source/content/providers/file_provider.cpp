@@ -2,6 +2,7 @@
 
 #include <cstring>
 
+#include <hex/api/content_registry.hpp>
 #include <hex/api/imhex_api.hpp>
 #include <hex/api/localization.hpp>
 #include <hex/api/project_file_manager.hpp>
@@ -9,12 +10,46 @@
 #include <hex/helpers/utils.hpp>
 #include <hex/helpers/fmt.hpp>
 
+#include <wolv/io/fs.hpp>
 #include <wolv/utils/string.hpp>
 
 #include <nlohmann/json.hpp>
 
+#if defined(OS_WINDOWS)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+#endif
+
 namespace hex::plugin::builtin {
 
+    struct FileProvider::MappedFile {
+        const u8 *data = nullptr;
+        size_t size = 0;
+
+        #if defined(OS_WINDOWS)
+            HANDLE mappingHandle = nullptr;
+        #endif
+
+        MappedFile() = default;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile() {
+            if (this->data == nullptr)
+                return;
+
+            #if defined(OS_WINDOWS)
+                UnmapViewOfFile(this->data);
+                CloseHandle(this->mappingHandle);
+            #else
+                ::munmap(const_cast<u8 *>(this->data), this->size);
+            #endif
+        }
+    };
+
     bool FileProvider::isAvailable() const {
         return true;
     }
@@ -40,11 +75,7 @@ namespace hex::plugin::builtin {
         this->readRaw(offset - this->getBaseAddress(), buffer, size);
 
         if (overlays) {
-            if (auto &patches = this->getPatches(); !patches.empty()) {
-                for (u64 i = 0; i < size; i++)
-                    if (patches.contains(offset + i))
-                        reinterpret_cast<u8 *>(buffer)[i] = patches[offset + i];
-            }
+            this->getPatches().apply(offset, buffer, size);
 
             this->applyOverlays(offset, buffer, size);
         }
@@ -58,14 +89,36 @@ namespace hex::plugin::builtin {
     }
 
     void FileProvider::readRaw(u64 offset, void *buffer, size_t size) {
-        if (offset > (this->getActualSize() - size) || buffer == nullptr || size == 0)
+        const auto actualSize = this->getActualSize();
+        if (offset > (actualSize - size) || buffer == nullptr || size == 0)
             return;
 
+        if (auto mappedFile = this->getMappedFile(actualSize); mappedFile != nullptr) {
+            std::memcpy(buffer, mappedFile->data + offset, size);
+            return;
+        }
+
         auto &file = this->getFile();
         file.seek(offset);
         file.readBuffer(reinterpret_cast<u8*>(buffer), size);
     }
 
+    std::optional<prv::DataView> FileProvider::getDataView(u64 offset, size_t size) {
+        auto mappedFile = this->getMappedFile(this->getActualSize());
+        if (mappedFile == nullptr)
+            return std::nullopt;
+
+        const auto fileOffset = offset - this->getBaseAddress();
+        if (fileOffset > mappedFile->size || size > mappedFile->size - fileOffset)
+            return std::nullopt;
+
+        if (this->hasModifications(offset, size))
+            return std::nullopt;
+
+        const std::span<const u8> data = { mappedFile->data + fileOffset, size };
+        return prv::DataView(data, std::move(mappedFile));
+    }
+
     void FileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
             return;
@@ -214,11 +267,82 @@ namespace hex::plugin::builtin {
 
         this->m_files.emplace(std::this_thread::get_id(), std::move(file));
 
+        if (ContentRegistry::Settings::read("hex.builtin.setting.general", "hex.builtin.setting.general.memory_map_files", 1) != 0)
+            this->mapFile();
+
         return true;
     }
 
     void FileProvider::close() {
+        this->unmapFile();
+    }
+
+    void FileProvider::mapFile() {
+        this->unmapFile();
+
+        // Only regular files can be mapped, everything else gets read through the file handles
+        const auto size = this->getActualSize();
+        if (size == 0 || !wolv::io::fs::isRegularFile(this->m_path))
+            return;
+
+        auto mappedFile = std::make_shared<MappedFile>();
+
+        #if defined(OS_WINDOWS)
+
+            HANDLE fileHandle = CreateFileW(this->m_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (fileHandle == INVALID_HANDLE_VALUE)
+                return;
+
+            HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(fileHandle);
+
+            if (mappingHandle == nullptr)
+                return;
+
+            auto mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (mapping == nullptr) {
+                CloseHandle(mappingHandle);
+                return;
+            }
+
+            mappedFile->mappingHandle = mappingHandle;
+
+        #else
+
+            int fileDescriptor = ::open(wolv::util::toUTF8String(this->m_path).c_str(), O_RDONLY);
+            if (fileDescriptor == -1)
+                return;
+
+            auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+            ::close(fileDescriptor);
+
+            if (mapping == MAP_FAILED)
+                return;
+
+        #endif
+
+        mappedFile->data = static_cast<const u8 *>(mapping);
+        mappedFile->size = size;
+
+        std::scoped_lock lock(this->m_mappingMutex);
+        this->m_mappedFile = std::move(mappedFile);
+    }
+
+    void FileProvider::unmapFile() {
+        // The mapping itself is only released once the last reader and data view referencing it are gone
+        std::scoped_lock lock(this->m_mappingMutex);
+        this->m_mappedFile.reset();
+    }
+
+    std::shared_ptr<const FileProvider::MappedFile> FileProvider::getMappedFile(size_t actualSize) {
+        std::scoped_lock lock(this->m_mappingMutex);
+
+        // If the file changed its size behind our back, accessing the mapping past the new end of the file would crash.
+        // Stop using the mapping and read through the file handles instead
+        if (this->m_mappedFile != nullptr && this->m_mappedFile->size != actualSize)
+            this->m_mappedFile.reset();
 
+        return this->m_mappedFile;
     }
 
     wolv::io::File& FileProvider::getFile() {
@@ -153,40 +153,10 @@ namespace hex::plugin::builtin {
 
         offset -= this->getBaseAddress();
 
-        u64 alignedOffset = offset - (offset % CacheLineSize);
-
-        if (size <= CacheLineSize) {
-            std::scoped_lock lock(this->m_cacheLock);
-
-            const auto &cacheLine = std::find_if(this->m_cache.begin(), this->m_cache.end(), [&](auto &line) {
-                return line.address == alignedOffset;
-            });
-
-            if (cacheLine != this->m_cache.end()) {
-                // Cache hit
-
-            } else {
-                // Cache miss
-
-                this->m_cache.push_back({ alignedOffset, { 0 } });
-            }
-
-            if (cacheLine != this->m_cache.end())
-                std::memcpy(buffer, &cacheLine->data[0] + (offset % CacheLineSize), std::min(size, cacheLine->data.size()));
-        } else {
-            while (size > 0) {
-                size_t readSize = std::min(size, CacheLineSize);
-                this->readRaw(offset, buffer, readSize);
-
-                size -= readSize;
-                offset += readSize;
-            }
-        }
+        this->readRawCached(offset, buffer, size);
 
         if (overlays) {
-            for (u64 i = 0; i < size; i++)
-                if (getPatches().contains(offset + i))
-                    reinterpret_cast<u8 *>(buffer)[i] = getPatches()[offset + PageSize * this->m_currPage + i];
+            this->getPatches().apply(offset, buffer, size);
 
             this->applyOverlays(offset, buffer, size);
         }
@@ -199,10 +169,11 @@ namespace hex::plugin::builtin {
         offset -= this->getBaseAddress();
 
         gdb::writeMemory(this->m_socket, offset, buffer, size);
+        this->invalidateBlockCache(offset, size);
     }
 
     void GDBProvider::readRaw(u64 offset, void *buffer, size_t size) {
-        if ((offset - this->getBaseAddress()) > (this->getActualSize() - size) || buffer == nullptr || size == 0)
+        if (offset > (this->getActualSize() - size) || buffer == nullptr || size == 0)
             return;
 
         auto data = gdb::readMemory(this->m_socket, offset, size);
@@ -211,7 +182,7 @@ namespace hex::plugin::builtin {
     }
 
     void GDBProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
-        if ((offset - this->getBaseAddress()) > (this->getActualSize() - size) || buffer == nullptr || size == 0)
+        if (offset > (this->getActualSize() - size) || buffer == nullptr || size == 0)
             return;
 
         gdb::writeMemory(this->m_socket, offset, buffer, size);
@@ -253,37 +224,8 @@ namespace hex::plugin::builtin {
         if (this->m_socket.isConnected()) {
             gdb::continueExecution(this->m_socket);
 
-            this->m_cacheUpdateThread = std::thread([this]() {
-                auto cacheLine = this->m_cache.begin();
-                while (this->isConnected()) {
-                    {
-                        std::scoped_lock lock(this->m_cacheLock);
-
-                        if (this->m_resetCache) {
-                            this->m_cache.clear();
-                            this->m_resetCache = false;
-                            cacheLine = this->m_cache.begin();
-                        }
-
-                        if (cacheLine != this->m_cache.end()) {
-                            std::vector<u8> data = gdb::readMemory(this->m_socket, cacheLine->address, CacheLineSize);
-
-                            while (std::count_if(this->m_cache.begin(), this->m_cache.end(), [&](auto &line) { return !line.data.empty(); }) > 100) {
-                                this->m_cache.pop_front();
-                                cacheLine = this->m_cache.begin();
-                            }
-
-                            std::memcpy(cacheLine->data.data(), data.data(), data.size());
-                        }
-
-                        if (cacheLine == this->m_cache.end())
-                            cacheLine = this->m_cache.begin();
-                        else
-                            cacheLine++;
-                    }
-                    std::this_thread::sleep_for(10ms);
-                }
-            });
+            // The memory of the target keeps changing while it's running, so cached blocks are only valid for a short amount of time
+            this->enableBlockCache(CacheBlockSize, CacheBlockCount, CacheReadAheadBlockCount).setMaxBlockAge(CacheBlockMaxAge);
 
             return true;
         } else {
@@ -294,9 +236,7 @@ namespace hex::plugin::builtin {
     void GDBProvider::close() {
         this->m_socket.disconnect();
 
-        if (this->m_cacheUpdateThread.joinable()) {
-            this->m_cacheUpdateThread.join();
-        }
+        this->disableBlockCache();
     }
 
     bool GDBProvider::isConnected() const {
@@ -1,6 +1,7 @@
 #include "content/providers/memory_file_provider.hpp"
 #include "content/providers/file_provider.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 #include <hex/api/imhex_api.hpp>
@@ -12,7 +13,7 @@
 namespace hex::plugin::builtin {
 
     bool MemoryFileProvider::open() {
-        this->m_data.resize(1);
+        this->m_data = std::make_shared<std::vector<u8>>(1);
         this->markDirty();
         return true;
     }
@@ -21,14 +22,23 @@ namespace hex::plugin::builtin {
         if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(buffer, &this->m_data.front() + offset, size);
+        std::memcpy(buffer, this->m_data->data() + offset, size);
     }
 
     void MemoryFileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(&this->m_data.front() + offset, buffer, size);
+        std::memcpy(this->m_data->data() + offset, buffer, size);
+    }
+
+    std::optional<prv::DataView> MemoryFileProvider::getDataView(u64 offset, size_t size) {
+        offset -= this->getBaseAddress();
+        if (offset > this->getActualSize() || size > this->getActualSize() - offset)
+            return std::nullopt;
+
+        // The view shares ownership of the buffer so it stays alive when the data gets resized or the provider gets closed
+        return prv::DataView({ this->m_data->data() + offset, size }, this->m_data);
     }
 
     void MemoryFileProvider::save() {
@@ -51,7 +61,15 @@ namespace hex::plugin::builtin {
     }
 
     void MemoryFileProvider::resize(size_t newSize) {
-        this->m_data.resize(newSize);
+        // Resizing may reallocate the buffer. Data views handed out earlier keep using the old one
+        if (this->m_data.use_count() > 1) {
+            auto data = std::make_shared<std::vector<u8>>(newSize);
+            std::copy_n(this->m_data->begin(), std::min(newSize, this->m_data->size()), data->begin());
+
+            this->m_data = std::move(data);
+        } else {
+            this->m_data->resize(newSize);
+        }
 
         Provider::resize(newSize);
     }
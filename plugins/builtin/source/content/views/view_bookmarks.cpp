@@ -18,6 +18,47 @@
 
 namespace hex::plugin::builtin {
 
+    /**
+     * @brief Finds all bookmarks overlapping a region
+     * @param provider Provider the bookmarks belong to
+     * @param region Region to search
+     * @return Bookmarks in the order they appear in the bookmark list
+     */
+    static std::vector<ImHexApi::Bookmarks::Entry*> findBookmarks(prv::Provider *provider, const Region &region) {
+        auto &data = ProviderExtraData::get(provider);
+
+        if (!data.bookmarkIndex.has_value()) {
+            ProviderExtraData::Data::BookmarkTree::interval_vector intervals;
+            size_t index = 0;
+            for (auto &bookmark : data.bookmarks) {
+                if (bookmark.region.getSize() != 0)
+                    intervals.emplace_back(bookmark.region.getStartAddress(), bookmark.region.getEndAddress(), std::pair { index, &bookmark });
+                index++;
+            }
+
+            data.bookmarkIndex = ProviderExtraData::Data::BookmarkTree(std::move(intervals));
+        }
+
+        std::vector<std::pair<size_t, ImHexApi::Bookmarks::Entry*>> overlapping;
+        data.bookmarkIndex->visit_overlapping(region.getStartAddress(), region.getEndAddress(), [&](const auto &interval) {
+            overlapping.push_back(interval.value);
+        });
+
+        std::ranges::sort(overlapping, {}, &std::pair<size_t, ImHexApi::Bookmarks::Entry*>::first);
+
+        std::vector<ImHexApi::Bookmarks::Entry*> result;
+        result.reserve(overlapping.size());
+        for (const auto &[index, bookmark] : overlapping)
+            result.push_back(bookmark);
+
+        return result;
+    }
+
+    static void bookmarksChanged(prv::Provider *provider) {
+        ProviderExtraData::get(provider).bookmarkIndex.reset();
+        EventManager::post<EventHighlightingChanged>();
+    }
+
     ViewBookmarks::ViewBookmarks() : View("hex.builtin.view.bookmarks.name") {
         EventManager::subscribe<RequestAddBookmark>(this, [](Region region, std::string name, std::string comment, color_t color) {
             if (name.empty()) {
@@ -36,22 +77,29 @@ namespace hex::plugin::builtin {
             });
 
             ImHexApi::Provider::markDirty();
+            bookmarksChanged(ImHexApi::Provider::get());
         });
 
-        ImHexApi::HexEditor::addBackgroundHighlightingProvider([](u64 address, const u8* data, size_t size, bool) -> std::optional<color_t> {
-            hex::unused(data);
+        ImHexApi::HexEditor::addBackgroundHighlightingRegionProvider([](const Region &region) {
+            std::vector<ImHexApi::HexEditor::Highlighting> result;
 
-            for (const auto &bookmark : ProviderExtraData::getCurrent().bookmarks) {
-                if (Region { address, size }.isWithin(bookmark.region))
-                    return bookmark.color;
-            }
+            if (!ImHexApi::Provider::isValid())
+                return result;
+
+            for (const auto bookmark : findBookmarks(ImHexApi::Provider::get(), region))
+                result.emplace_back(bookmark->region, bookmark->color);
 
-            return std::nullopt;
+            return result;
         });
 
         ImHexApi::HexEditor::addTooltipProvider([](u64 address, const u8 *data, size_t size) {
             hex::unused(data);
-            for (const auto &bookmark : ProviderExtraData::getCurrent().bookmarks) {
+
+            if (!ImHexApi::Provider::isValid() || size == 0)
+                return;
+
+            for (const auto bookmarkPtr : findBookmarks(ImHexApi::Provider::get(), { address, size })) {
+                const auto &bookmark = *bookmarkPtr;
                 if (!Region { address, size }.isWithin(bookmark.region))
                     continue;
 
@@ -118,6 +166,7 @@ namespace hex::plugin::builtin {
 
                 auto data = nlohmann::json::parse(fileContent.begin(), fileContent.end());
                 ProviderExtraData::get(provider).bookmarks.clear();
+                ProviderExtraData::get(provider).bookmarkIndex.reset();
                 return ViewBookmarks::importBookmarks(provider, data);
             },
             .store = [](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) -> bool {
@@ -200,6 +249,19 @@ namespace hex::plugin::builtin {
                             continue;
                     }
 
+                    // Collapsed bookmarks outside the visible area only need their space reserved so large lists stay responsive
+                    if (!ImGui::IsRectVisible({ ImGui::GetContentRegionAvail().x, ImGui::GetFrameHeight() })) {
+                        ImGui::PushID(id);
+                        const bool headerOpen = ImGui::GetStateStorage()->GetInt(ImGui::GetID("###bookmark"), 0) != 0;
+                        ImGui::PopID();
+
+                        if (!headerOpen) {
+                            ImGui::Dummy({ 0, ImGui::GetFrameHeight() });
+                            id++;
+                            continue;
+                        }
+                    }
+
                     auto headerColor = ImColor(color);
                     auto hoverColor  = ImColor(color);
                     hoverColor.Value.w *= 1.3F;
@@ -220,9 +282,10 @@ namespace hex::plugin::builtin {
                         if (ImGui::IsMouseClicked(0) && ImGui::IsItemActivated() && this->m_dragStartIterator == bookmarks.end())
                             this->m_dragStartIterator = iter;
 
-                        if (ImGui::IsItemHovered() && this->m_dragStartIterator != bookmarks.end()) {
+                        if (ImGui::IsItemHovered() && this->m_dragStartIterator != bookmarks.end() && this->m_dragStartIterator != iter) {
                             std::iter_swap(iter, this->m_dragStartIterator);
                             this->m_dragStartIterator = iter;
+                            bookmarksChanged(provider);
                         }
 
                         if (!ImGui::IsMouseDown(0))
@@ -256,7 +319,10 @@ namespace hex::plugin::builtin {
 
                             if (ImGui::BeginPopup("hex.builtin.view.bookmarks.header.color"_lang)) {
                                 drawColorPopup(headerColor);
-                                color = headerColor;
+                                if (color != color_t(headerColor)) {
+                                    color = headerColor;
+                                    EventManager::post<EventHighlightingChanged>();
+                                }
                                 ImGui::EndPopup();
                             }
 
@@ -322,6 +388,7 @@ namespace hex::plugin::builtin {
 
                 if (bookmarkToRemove != bookmarks.end()) {
                     bookmarks.erase(bookmarkToRemove);
+                    bookmarksChanged(provider);
                 }
             }
             ImGui::EndChild();
@@ -351,6 +418,8 @@ namespace hex::plugin::builtin {
             });
         }
 
+        bookmarksChanged(provider);
+
         return true;
     }
 
@@ -161,7 +161,7 @@ namespace hex::plugin::builtin {
 
                 this->m_dataValid = true;
 
-            });
+            }, TaskPriority::Interactive);
         }
 
         if (ImGui::Begin(View::toWindowName("hex.builtin.view.data_inspector.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
@@ -130,6 +130,7 @@ namespace hex::plugin::builtin {
         }
 
         workspace.links.erase(link);
+        workspace.executionPlan.reset();
 
         ImHexApi::Provider::markDirty();
     }
@@ -159,6 +160,8 @@ namespace hex::plugin::builtin {
             workspace.nodes.erase(node);
         }
 
+        workspace.executionPlan.reset();
+
         ImHexApi::Provider::markDirty();
     }
 
@@ -181,14 +184,7 @@ namespace hex::plugin::builtin {
         workspace.currNodeError.reset();
 
         try {
-            for (auto &endNode : workspace.endNodes) {
-                endNode->resetOutputData();
-
-                for (auto &node : workspace.nodes)
-                    node->resetProcessedInputs();
-
-                endNode->process();
-            }
+            ViewDataProcessor::executeNodes(workspace);
         } catch (dp::Node::NodeError &e) {
             workspace.currNodeError = e;
 
@@ -201,6 +197,15 @@ namespace hex::plugin::builtin {
         }
     }
 
+    void ViewDataProcessor::executeNodes(Workspace &workspace) {
+        if (!workspace.executionPlan.has_value()) {
+            std::vector<dp::Node *> endNodes(workspace.endNodes.begin(), workspace.endNodes.end());
+            workspace.executionPlan = dp::Node::createExecutionPlan(endNodes);
+        }
+
+        dp::Node::execute(*workspace.executionPlan);
+    }
+
     void ViewDataProcessor::reloadCustomNodes() {
         this->m_customNodes.clear();
 
@@ -308,6 +313,7 @@ namespace hex::plugin::builtin {
 
                     ImNodes::SetNodeScreenSpacePos(node->getId(), this->m_rightClickedCoords);
                     workspace.nodes.push_back(std::move(node));
+                    workspace.executionPlan.reset();
                     ImHexApi::Provider::markDirty();
                 }
 
@@ -528,6 +534,8 @@ namespace hex::plugin::builtin {
 
                         fromAttr->addConnectedAttribute(newLink.getId(), toAttr);
                         toAttr->addConnectedAttribute(newLink.getId(), fromAttr);
+
+                        workspace.executionPlan.reset();
                     } while (false);
                 }
             }
@@ -653,6 +661,7 @@ namespace hex::plugin::builtin {
         workspace.nodes.clear();
         workspace.endNodes.clear();
         workspace.links.clear();
+        workspace.executionPlan.reset();
 
         for (auto &node : jsonData["nodes"]) {
             auto newNode = loadNode(node);
@@ -1,6 +1,7 @@
 #include "content/views/view_diff.hpp"
 
 #include <hex/api/imhex_api.hpp>
+#include <hex/api/project_file_manager.hpp>
 
 #include <hex/helpers/fmt.hpp>
 #include <hex/helpers/logger.hpp>
@@ -22,38 +23,130 @@ namespace hex::plugin::builtin {
             this->m_columns[1].provider = -1;
         });
 
-        auto compareFunction = [this](int otherIndex) {
-            return [this, otherIndex](u64 address, const u8 *data, size_t) -> std::optional<color_t> {
-                const auto &providers = ImHexApi::Provider::getProviders();
-                auto otherId = this->m_columns[otherIndex].provider;
-                if (otherId < 0 || size_t(otherId) >= providers.size())
-                    return std::nullopt;
+        EventManager::subscribe<EventProviderDataModified>(this, [this](prv::Provider *provider, Region region) {
+            // Providers may be modified from any thread, only remember the modification here and rehash it during the next diff
+            std::scoped_lock lock(this->m_blockHashMutex);
+
+            if (region.getSize() > 0 && this->m_blockHashIndices.contains(provider)) {
+                this->m_modifiedRegions[provider].push_back(region);
+                this->m_dataModified = true;
+            }
+        });
+
+        EventManager::subscribe<EventProviderDeleted>(this, [this](const prv::Provider *provider) {
+            std::scoped_lock lock(this->m_blockHashMutex);
+
+            this->m_blockHashIndices.erase(provider);
+            this->m_modifiedRegions.erase(provider);
+        });
+
+        ProjectFile::registerPerProviderHandler({
+            .basePath = "block_hashes",
+            .required = false,
+            .load = [this](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) -> bool {
+                std::optional<BlockHashIndex> index;
+                if (const auto path = basePath / "index.bin"; tar.contains(path))
+                    index = BlockHashIndex::deserialize(tar.readVector(path));
 
-                auto &otherProvider = providers[otherId];
+                std::scoped_lock lock(this->m_blockHashMutex);
 
-                if (address > otherProvider->getActualSize()) {
-                    if (otherIndex == 1)
-                        return getDiffColor(ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarGreen));
-                    else
-                        return getDiffColor(ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarRed));
+                // The index is only useful if it was created from the same data
+                if (index.has_value() && index->getDataSize() == provider->getActualSize())
+                    this->m_blockHashIndices[provider] = std::make_shared<BlockHashIndex>(std::move(*index));
+                else
+                    this->m_blockHashIndices.erase(provider);
+                this->m_modifiedRegions.erase(provider);
+
+                return true;
+            },
+            .store = [this](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) -> bool {
+                // Only store indices that match the current data
+                if (this->m_diffTask.isRunning())
+                    return true;
+
+                std::shared_ptr<BlockHashIndex> index;
+                {
+                    std::scoped_lock lock(this->m_blockHashMutex);
+                    if (this->m_modifiedRegions.contains(provider))
+                        return true;
+                    if (auto it = this->m_blockHashIndices.find(provider); it != this->m_blockHashIndices.end())
+                        index = it->second;
                 }
 
-                u8 otherByte = 0x00;
-                otherProvider->read(address, &otherByte, 1);
+                if (index == nullptr || !index->isUpToDate() || index->getDataSize() != provider->getActualSize())
+                    return true;
 
-                if (otherByte != *data)
-                    return getDiffColor(ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarYellow));
+                tar.writeVector(basePath / "index.bin", index->serialize());
 
+                return true;
+            }
+        });
+
+        this->m_columns[0].hexEditor.setBackgroundHighlightCallback(this->createHighlightCallback(0));
+        this->m_columns[1].hexEditor.setBackgroundHighlightCallback(this->createHighlightCallback(1));
+    }
+
+    std::function<std::optional<color_t>(u64, const u8 *, size_t)> ViewDiff::createHighlightCallback(u32 column) {
+        return [this, column](u64 address, const u8 *, size_t size) -> std::optional<color_t> {
+            if (!this->m_analyzed)
                 return std::nullopt;
-            };
-        };
 
-        this->m_columns[0].hexEditor.setBackgroundHighlightCallback(compareFunction(1));
-        this->m_columns[1].hexEditor.setBackgroundHighlightCallback(compareFunction(0));
+            // Find the last difference starting inside or before the cell
+            const auto &highlights = this->m_highlights[column];
+            auto it = std::upper_bound(highlights.begin(), highlights.end(), address + std::max<size_t>(size, 1) - 1, [](u64 address, const Highlight &highlight) {
+                return address < highlight.region.getStartAddress();
+            });
+
+            if (it == highlights.begin() || std::prev(it)->region.getEndAddress() < address)
+                return std::nullopt;
+
+            switch (std::prev(it)->type) {
+                case DifferenceType::Added:
+                    return getDiffColor(ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarGreen));
+                case DifferenceType::Removed:
+                    return getDiffColor(ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarRed));
+                case DifferenceType::Modified:
+                    return getDiffColor(ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarYellow));
+            }
+
+            return std::nullopt;
+        };
     }
 
     ViewDiff::~ViewDiff() {
         EventManager::unsubscribe<EventProviderClosed>(this);
+        EventManager::unsubscribe<EventProviderDataModified>(this);
+        EventManager::unsubscribe<EventProviderDeleted>(this);
+    }
+
+    std::shared_ptr<BlockHashIndex> ViewDiff::updateBlockHashIndex(Task &task, prv::Provider *provider) {
+        std::shared_ptr<BlockHashIndex> index;
+        std::vector<Region> modifiedRegions;
+        {
+            std::scoped_lock lock(this->m_blockHashMutex);
+
+            auto &entry = this->m_blockHashIndices[provider];
+            if (entry == nullptr)
+                entry = std::make_shared<BlockHashIndex>();
+            index = entry;
+
+            if (auto it = this->m_modifiedRegions.find(provider); it != this->m_modifiedRegions.end()) {
+                modifiedRegions = std::move(it->second);
+                this->m_modifiedRegions.erase(it);
+            }
+        }
+
+        for (const auto &region : modifiedRegions)
+            index->invalidate({ region.getStartAddress() - provider->getBaseAddress(), region.getSize() });
+
+        // Only blocks that changed since the last diff need to be hashed again
+        index->resize(provider->getActualSize());
+        task.setMaxValue(index->getOutdatedSize());
+        task.update(0);
+
+        index->update(task, provider);
+
+        return index;
     }
 
     namespace {
@@ -132,50 +225,46 @@ namespace hex::plugin::builtin {
                     b.hexEditor.setProvider(nullptr);
             }
 
+            if (this->m_dataModified && !this->m_diffTask.isRunning()) {
+                this->m_dataModified = false;
+                this->m_analyzed = false;
+            }
+
             if (!this->m_analyzed && a.provider != -1 && b.provider != -1 && !this->m_diffTask.isRunning()) {
                 const auto &providers = ImHexApi::Provider::getProviders();
                 auto providerA = providers[a.provider];
                 auto providerB = providers[b.provider];
 
-                auto commonSize = std::min(providerA->getActualSize(), providerB->getActualSize());
-                this->m_diffTask = TaskManager::createTask("Diffing...", commonSize, [this, providerA, providerB](Task &task) {
-                    std::vector<Diff> differences;
-
-                    auto readerA = prv::ProviderReader(providerA);
-                    auto readerB = prv::ProviderReader(providerB);
-
-                    for (auto itA = readerA.begin(), itB = readerB.begin(); itA < readerA.end() && itB < readerB.end(); itA++, itB++) {
-                        if (task.wasInterrupted())
-                            break;
-
-                        if (*itA != *itB) {
-                            u64 start = itA.getAddress();
-                            size_t end = 0;
-
-                            while (itA != readerA.end() && itB != readerB.end() && *itA != *itB) {
-                                itA++;
-                                itB++;
-                                end++;
-                            }
+                this->m_diffTask = TaskManager::createTask("Diffing...", TaskManager::NoProgress, [this, providerA, providerB](Task &task) {
+                    auto indexA = this->updateBlockHashIndex(task, providerA);
+                    auto indexB = this->updateBlockHashIndex(task, providerB);
 
+                    // Data in front of the first block whose hash differs is equal in both providers. If both providers have the same size,
+                    // so is the data behind the last one. Only the data in between needs to be diffed
+                    std::vector<Diff> differences;
+                    if (auto changedRegions = indexA->getChangedRegions(*indexB); !changedRegions.empty()) {
+                        const auto start = changedRegions.front().getStartAddress();
 
-                            differences.push_back(Diff { Region{ start, end }, ViewDiff::DifferenceType::Modified });
-                        }
+                        u64 endA = providerA->getActualSize(), endB = providerB->getActualSize();
+                        if (endA == endB)
+                            endA = endB = changedRegions.back().getEndAddress() + 1;
 
-                        task.update(itA.getAddress());
+                        differences = diff::compare(task,
+                            providerA, { providerA->getBaseAddress() + start, endA - start },
+                            providerB, { providerB->getBaseAddress() + start, endB - start }
+                        );
                     }
 
-                    if (providerA->getActualSize() != providerB->getActualSize()) {
-                        auto endA = providerA->getActualSize() - 1;
-                        auto endB = providerB->getActualSize() - 1;
-
-                        if (endA > endB)
-                            differences.push_back(Diff { Region{ endB, endA - endB }, ViewDiff::DifferenceType::Added });
-                        else
-                            differences.push_back(Diff { Region{ endA, endB - endA }, ViewDiff::DifferenceType::Removed });
+                    std::array<std::vector<Highlight>, 2> highlights;
+                    for (const auto &difference : differences) {
+                        if (difference.regionA.getSize() > 0)
+                            highlights[0].push_back({ difference.regionA, difference.type });
+                        if (difference.regionB.getSize() > 0)
+                            highlights[1].push_back({ difference.regionB, difference.type });
                     }
 
                     this->m_diffs = std::move(differences);
+                    this->m_highlights = std::move(highlights);
                     this->m_analyzed = true;
                 });
             }
@@ -237,16 +326,20 @@ namespace hex::plugin::builtin {
 
                             const auto &diff = this->m_diffs[i];
 
+                            // Removed data only exists in the second provider
+                            const auto &region = diff.type == DifferenceType::Removed ? diff.regionB : diff.regionA;
+
                             ImGui::TableNextColumn();
-                            if (ImGui::Selectable(hex::format("0x{:02X}", diff.region.getStartAddress()).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
-                                a.hexEditor.setSelection(diff.region);
+                            if (ImGui::Selectable(hex::format("0x{:02X}", region.getStartAddress()).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
+                                // Empty regions mark the position where the data is missing
+                                a.hexEditor.setSelection({ diff.regionA.getStartAddress(), std::max<size_t>(diff.regionA.getSize(), 1) });
                                 a.hexEditor.jumpToSelection();
-                                b.hexEditor.setSelection(diff.region);
+                                b.hexEditor.setSelection({ diff.regionB.getStartAddress(), std::max<size_t>(diff.regionB.getSize(), 1) });
                                 b.hexEditor.jumpToSelection();
                             }
 
                             ImGui::TableNextColumn();
-                            ImGui::TextUnformatted(hex::format("0x{:02X}", diff.region.getEndAddress()).c_str());
+                            ImGui::TextUnformatted(hex::format("0x{:02X}", region.getEndAddress()).c_str());
 
                             ImGui::TableNextColumn();
                             switch (diff.type) {
@@ -3,16 +3,56 @@
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/fmt.hpp>
 
+#include <array>
 #include <cstring>
+#include <optional>
 #include <thread>
 
+#include <wolv/utils/guards.hpp>
+
+#include <fonts/codicons_font.h>
+
 using namespace std::literals::string_literals;
 
 namespace hex::plugin::builtin {
 
     ViewDisassembler::ViewDisassembler() : View("hex.builtin.view.disassembler.name") {
-        EventManager::subscribe<EventProviderDeleted>(this, [this](const auto*) {
-            this->m_disassembly.clear();
+        EventManager::subscribe<EventProviderDeleted>(this, [this](const auto *provider) {
+            if (provider == this->m_disassembledSettings.provider) {
+                this->m_disassemblerTask.interrupt();
+                this->m_disassembledSettings.provider = nullptr;
+                this->reset();
+            }
+
+            if (provider == this->m_analyzedSettings.provider) {
+                this->m_analysisTask.interrupt();
+                this->m_analysis.reset();
+                this->m_analyzedSettings.provider = nullptr;
+            }
+        });
+
+        // Highlight the analyzed basic blocks, alternating between two colors so neighbouring blocks can be told apart
+        this->m_highlightProviderId = ImHexApi::HexEditor::addBackgroundHighlightingRegionProvider([this](const Region &region) {
+            std::vector<ImHexApi::HexEditor::Highlighting> result;
+
+            const auto &settings = this->m_analyzedSettings;
+            if (this->m_analysisTask.isRunning() || !this->m_analysis.has_value() || settings.provider != ImHexApi::Provider::get())
+                return result;
+
+            if (!region.overlaps(settings.codeRegion))
+                return result;
+
+            const u64 start = std::max(region.getStartAddress(), settings.codeRegion.getStartAddress());
+            const u64 end   = std::min(region.getEndAddress(), settings.codeRegion.getEndAddress());
+            const Region codeRegion = { settings.baseAddress + (start - settings.codeRegion.getStartAddress()), end - start + 1 };
+
+            const auto &blocks = this->m_analysis->getBasicBlocks();
+            for (const auto &block : this->m_analysis->getBasicBlocks(codeRegion)) {
+                const auto index = &block - blocks.data();
+                result.emplace_back(Region { this->toProviderAddress(block.address), block.size }, index % 2 == 0 ? 0x40D69C56 : 0x70D69C56);
+            }
+
+            return result;
         });
     }
 
@@ -20,65 +60,196 @@ namespace hex::plugin::builtin {
         EventManager::unsubscribe<EventDataChanged>(this);
         EventManager::unsubscribe<EventRegionSelected>(this);
         EventManager::unsubscribe<EventProviderDeleted>(this);
+
+        ImHexApi::HexEditor::removeBackgroundHighlightingRegionProvider(this->m_highlightProviderId);
+
+        this->reset();
     }
 
-    void ViewDisassembler::disassemble() {
-        this->m_disassembly.clear();
+    void ViewDisassembler::reset() {
+        this->m_instructionSizes.clear();
+        this->m_instructionCheckpoints.clear();
 
-        this->m_disassemblerTask = TaskManager::createTask("hex.builtin.view.disassembler.disassembling", this->m_codeRegion.getSize(), [this](auto &task) {
-            csh capstoneHandle;
-            cs_insn *instructions = nullptr;
+        if (this->m_capstoneHandle != 0) {
+            cs_close(&this->m_capstoneHandle);
+            this->m_capstoneHandle = 0;
+        }
+    }
 
-            cs_mode mode = this->m_mode;
+    u64 ViewDisassembler::toProviderAddress(u64 address) const {
+        return this->m_analyzedSettings.codeRegion.getStartAddress() + (address - this->m_analyzedSettings.baseAddress);
+    }
 
-            if (cs_open(Disassembler::toCapstoneArchitecture(this->m_architecture), mode, &capstoneHandle) == CS_ERR_OK) {
+    u64 ViewDisassembler::getInstructionOffset(u64 index) const {
+        u64 offset = this->m_instructionCheckpoints[index / CheckpointInterval];
+        for (u64 i = index - index % CheckpointInterval; i < index; i++)
+            offset += this->m_instructionSizes[i];
 
-                cs_option(capstoneHandle, CS_OPT_SKIPDATA, CS_OPT_ON);
+        return offset;
+    }
 
-                auto provider = ImHexApi::Provider::get();
-                std::vector<u8> buffer(2048, 0x00);
-                size_t size = this->m_codeRegion.getSize();
+    namespace {
 
-                for (u64 address = 0; address < size; address += 2048) {
-                    task.update(address);
+        // Amount of data disassembled by each subtask
+        constexpr static u64 ChunkSize = 0x10'0000;
 
-                    size_t bufferSize = std::min(u64(2048), (size - address));
-                    provider->read(this->m_codeRegion.getStartAddress() + address, buffer.data(), bufferSize);
+        // Capstone never decodes instructions longer than this
+        constexpr static u64 MaxInstructionSize = sizeof(cs_insn::bytes);
 
-                    size_t instructionCount = cs_disasm(capstoneHandle, buffer.data(), bufferSize, this->m_baseAddress + address, 0, &instructions);
-                    if (instructionCount == 0)
-                        break;
+        struct ChunkDisassembly {
+            std::vector<u8> instructionSizes;
+            u64 endOffset = 0;
+        };
 
-                    this->m_disassembly.reserve(this->m_disassembly.size() + instructionCount);
+        std::optional<csh> openCapstone(Architecture architecture, cs_mode mode) {
+            csh handle = 0;
+            if (cs_open(Disassembler::toCapstoneArchitecture(architecture), mode, &handle) != CS_ERR_OK)
+                return std::nullopt;
 
-                    u64 usedBytes = 0;
-                    for (u32 i = 0; i < instructionCount; i++) {
-                        const auto &instr       = instructions[i];
-                        Disassembly disassembly = { };
-                        disassembly.address     = instr.address;
-                        disassembly.offset      = this->m_codeRegion.getStartAddress() + address + usedBytes;
-                        disassembly.size        = instr.size;
-                        disassembly.mnemonic    = instr.mnemonic;
-                        disassembly.operators   = instr.op_str;
+            cs_option(handle, CS_OPT_SKIPDATA, CS_OPT_ON);
 
-                        for (u16 j = 0; j < instr.size; j++)
-                            disassembly.bytes += hex::format("{0:02X} ", instr.bytes[j]);
-                        disassembly.bytes.pop_back();
+            return handle;
+        }
 
-                        this->m_disassembly.push_back(disassembly);
+        /**
+         * @brief Decodes instructions starting at a given offset until the end of the region or the given end offset is reached
+         * @return Offset after the last decoded instruction
+         */
+        u64 decodeInstructionSizes(csh handle, cs_insn *instruction, prv::Provider *provider, Region codeRegion, u64 startOffset, u64 endOffset, std::vector<u8> &sizes) {
+            std::vector<u8> buffer(std::min<u64>(endOffset - startOffset + MaxInstructionSize, codeRegion.getSize() - startOffset));
+            provider->read(codeRegion.getStartAddress() + startOffset, buffer.data(), buffer.size());
+
+            const u8 *code = buffer.data();
+            size_t codeSize = buffer.size();
+            u64 address = startOffset;
+
+            u64 offset = startOffset;
+            while (offset < endOffset && cs_disasm_iter(handle, &code, &codeSize, &address, instruction)) {
+                sizes.push_back(instruction->size);
+                offset += instruction->size;
+            }
 
-                        usedBytes += instr.size;
-                    }
+            return offset;
+        }
+
+    }
+
+    void ViewDisassembler::disassemble() {
+        this->reset();
+
+        this->m_disassembledSettings = { ImHexApi::Provider::get(), this->m_codeRegion, this->m_baseAddress, this->m_architecture, this->m_mode };
+
+        this->m_disassemblerTask = TaskManager::createTask("hex.builtin.view.disassembler.disassembling", this->m_codeRegion.getSize(), [this, settings = this->m_disassembledSettings](auto &task) {
+            auto provider = settings.provider;
+            const auto regionSize = settings.codeRegion.getSize();
+
+            // Disassemble all chunks in parallel, each one starting right at its first byte
+            std::vector<ChunkDisassembly> chunks((regionSize + ChunkSize - 1) / ChunkSize);
+            task.parallelFor({ 0, regionSize }, ChunkSize, [&](Task &subtask, Region chunk) {
+                auto handle = openCapstone(settings.architecture, settings.mode);
+                if (!handle.has_value())
+                    return;
+
+                cs_insn *instruction = cs_malloc(*handle);
 
-                    if (instructionCount < bufferSize)
-                        address -= (bufferSize - usedBytes);
+                auto &result = chunks[chunk.getStartAddress() / ChunkSize];
+                result.endOffset = decodeInstructionSizes(*handle, instruction, provider, settings.codeRegion, chunk.getStartAddress(), chunk.getEndAddress() + 1, result.instructionSizes);
 
-                    cs_free(instructions, instructionCount);
+                cs_free(instruction, 1);
+                cs_close(&*handle);
+
+                subtask.update();
+            });
+
+            auto handle = openCapstone(settings.architecture, settings.mode);
+            if (!handle.has_value())
+                return;
+
+            cs_insn *instruction = cs_malloc(*handle);
+            ON_SCOPE_EXIT {
+                cs_free(instruction, 1);
+                cs_close(&*handle);
+            };
+
+            // Stitch the chunks together. The last instruction of a chunk may extend into the next one, in which case the next chunk
+            // gets decoded again from the end of that instruction until it lines up with the chunk's own instructions again
+            std::vector<u8> sizes;
+            u64 offset = 0;
+            for (u64 chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++) {
+                const auto &chunk = chunks[chunkIndex];
+                const u64 chunkEnd = std::min<u64>((chunkIndex + 1) * ChunkSize, regionSize);
+
+                u64 boundary = chunkIndex * ChunkSize;
+                size_t instructionIndex = 0;
+                while (offset < chunkEnd) {
+                    while (instructionIndex < chunk.instructionSizes.size() && boundary < offset)
+                        boundary += chunk.instructionSizes[instructionIndex++];
+
+                    if (boundary == offset)
+                        break;
+
+                    const auto prevOffset = offset;
+                    offset = decodeInstructionSizes(*handle, instruction, provider, settings.codeRegion, offset, offset + 1, sizes);
+                    if (offset == prevOffset)
+                        break;
+                }
+
+                if (offset < chunkEnd && boundary == offset) {
+                    sizes.insert(sizes.end(), chunk.instructionSizes.begin() + instructionIndex, chunk.instructionSizes.end());
+                    offset = chunk.endOffset;
                 }
 
-                cs_close(&capstoneHandle);
+                // Decoding failed somewhere in this chunk so the data following it can't be disassembled either
+                if (offset < chunkEnd)
+                    break;
+            }
+
+            std::vector<u64> checkpoints;
+            checkpoints.reserve(sizes.size() / CheckpointInterval + 1);
+
+            offset = 0;
+            for (u64 i = 0; i < sizes.size(); i++) {
+                if (i % CheckpointInterval == 0)
+                    checkpoints.push_back(offset);
+
+                offset += sizes[i];
             }
+
+            // Hand the result over to the UI thread unless the provider went away in the meantime
+            TaskManager::doLater([this, provider, sizes = std::move(sizes), checkpoints = std::move(checkpoints)]() mutable {
+                if (this->m_disassembledSettings.provider != provider)
+                    return;
+
+                this->m_instructionSizes = std::move(sizes);
+                this->m_instructionCheckpoints = std::move(checkpoints);
+            });
+        });
+    }
+
+    void ViewDisassembler::analyze() {
+        this->m_analysis.reset();
+
+        auto provider = ImHexApi::Provider::get();
+        this->m_analyzedSettings = { provider, this->m_codeRegion, this->m_baseAddress };
+
+        this->m_analysisTask = TaskManager::createTask("hex.builtin.view.disassembler.analyzing", TaskManager::NoProgress, [this, provider, codeRegion = this->m_codeRegion, baseAddress = this->m_baseAddress, entryPoint = this->m_entryPoint, architecture = this->m_architecture, mode = this->m_mode](auto &task) {
+            const auto createDecoder = [=] {
+                return CodeAnalysis::createCapstoneDecoder(architecture, mode, provider, codeRegion, baseAddress);
+            };
+
+            auto analysis = CodeAnalysis::analyze(task, createDecoder, { entryPoint });
+
+            // The analysis gets read by the UI thread, only publish it from there. Drop it if the provider went away in the meantime
+            TaskManager::doLater([this, provider, analysis = std::move(analysis)]() mutable {
+                if (this->m_analyzedSettings.provider != provider)
+                    return;
+
+                this->m_analysis = std::move(analysis);
+                EventManager::post<EventHighlightingChanged>();
+            });
         });
+
+        EventManager::post<EventHighlightingChanged>();
     }
 
     void ViewDisassembler::drawContent() {
@@ -102,8 +273,7 @@ namespace hex::plugin::builtin {
                     }
                         break;
                     case ui::SelectedRegion::EntireData: {
-                        auto base = provider->getBaseAddress();
-                        this->m_codeRegion = { base, base + provider->getActualSize() - 1 };
+                        this->m_codeRegion = { provider->getBaseAddress(), provider->getActualSize() };
                     }
                     break;
                 }
@@ -338,6 +508,22 @@ namespace hex::plugin::builtin {
                     ImGui::TextSpinner("hex.builtin.view.disassembler.disassembling"_lang);
                 }
 
+                ImGui::InputHexadecimal("hex.builtin.view.disassembler.analysis.entry_point"_lang, &this->m_entryPoint);
+
+                ImGui::BeginDisabled(this->m_analysisTask.isRunning());
+                {
+                    if (ImGui::Button("hex.builtin.view.disassembler.analyze"_lang))
+                        this->analyze();
+                }
+                ImGui::EndDisabled();
+
+                if (this->m_analysisTask.isRunning()) {
+                    ImGui::SameLine();
+                    ImGui::TextSpinner("hex.builtin.view.disassembler.analyzing"_lang);
+                } else if (this->m_analysis.has_value() && this->m_analyzedSettings.provider == provider) {
+                    this->drawAnalysis();
+                }
+
                 ImGui::NewLine();
 
                 ImGui::TextUnformatted("hex.builtin.view.disassembler.disassembly.title"_lang);
@@ -350,34 +536,10 @@ namespace hex::plugin::builtin {
                     ImGui::TableSetupColumn("hex.builtin.view.disassembler.disassembly.bytes"_lang);
                     ImGui::TableSetupColumn("hex.builtin.view.disassembler.disassembly.title"_lang);
 
-                    if (!this->m_disassemblerTask.isRunning()) {
-                        ImGuiListClipper clipper;
-                        clipper.Begin(this->m_disassembly.size());
-
-                        ImGui::TableHeadersRow();
-                        while (clipper.Step()) {
-                            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-                                const auto &instruction = this->m_disassembly[i];
-                                ImGui::TableNextRow();
-                                ImGui::TableNextColumn();
-                                if (ImGui::Selectable(("##DisassemblyLine"s + std::to_string(i)).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
-                                    ImHexApi::HexEditor::setSelection(instruction.offset, instruction.size);
-                                }
-                                ImGui::SameLine();
-                                ImGui::TextFormatted("0x{0:X}", instruction.address);
-                                ImGui::TableNextColumn();
-                                ImGui::TextFormatted("0x{0:X}", instruction.offset);
-                                ImGui::TableNextColumn();
-                                ImGui::TextUnformatted(instruction.bytes.c_str());
-                                ImGui::TableNextColumn();
-                                ImGui::TextFormattedColored(ImColor(0xFFD69C56), "{}", instruction.mnemonic);
-                                ImGui::SameLine();
-                                ImGui::TextUnformatted(instruction.operators.c_str());
-                            }
-                        }
+                    ImGui::TableHeadersRow();
 
-                        clipper.End();
-                    }
+                    if (!this->m_disassemblerTask.isRunning() && this->m_disassembledSettings.provider == provider)
+                        this->drawDisassembly();
 
                     ImGui::EndTable();
                 }
@@ -386,4 +548,175 @@ namespace hex::plugin::builtin {
         ImGui::End();
     }
 
-}
\ No newline at end of file
+    void ViewDisassembler::drawDisassembly() {
+        const auto &settings = this->m_disassembledSettings;
+
+        if (this->m_capstoneHandle == 0) {
+            auto handle = openCapstone(settings.architecture, settings.mode);
+            if (!handle.has_value())
+                return;
+
+            this->m_capstoneHandle = *handle;
+        }
+
+        cs_insn *instruction = cs_malloc(this->m_capstoneHandle);
+        ON_SCOPE_EXIT { cs_free(instruction, 1); };
+
+        auto provider = settings.provider;
+        std::vector<u8> buffer;
+
+        ImGuiListClipper clipper;
+        clipper.Begin(this->m_instructionSizes.size());
+
+        while (clipper.Step()) {
+            if (clipper.DisplayStart >= clipper.DisplayEnd)
+                continue;
+
+            // Read the data of all visible instructions at once and decode them again
+            const u64 startOffset = this->getInstructionOffset(clipper.DisplayStart);
+            u64 endOffset = startOffset;
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+                endOffset += this->m_instructionSizes[i];
+
+            buffer.resize(endOffset - startOffset);
+            provider->read(settings.codeRegion.getStartAddress() + startOffset, buffer.data(), buffer.size());
+
+            u64 offset = startOffset;
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                const auto size = this->m_instructionSizes[i];
+
+                const u8 *code = buffer.data() + (offset - startOffset);
+                size_t codeSize = size;
+                u64 address = settings.baseAddress + offset;
+                const bool decoded = cs_disasm_iter(this->m_capstoneHandle, &code, &codeSize, &address, instruction);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::PushID(i);
+                if (ImGui::Selectable("##DisassemblyLine", false, ImGuiSelectableFlags_SpanAllColumns)) {
+                    ImHexApi::HexEditor::setSelection(settings.codeRegion.getStartAddress() + offset, size);
+                }
+                ImGui::PopID();
+                ImGui::SameLine();
+                ImGui::TextFormatted("0x{0:X}", settings.baseAddress + offset);
+                ImGui::TableNextColumn();
+                ImGui::TextFormatted("0x{0:X}", settings.codeRegion.getStartAddress() + offset);
+                ImGui::TableNextColumn();
+                {
+                    constexpr static auto HexDigits = "0123456789ABCDEF";
+
+                    std::array<char, MaxInstructionSize * 3> bytes = { };
+                    size_t length = 0;
+                    for (u8 j = 0; j < size; j++) {
+                        const u8 byte = buffer[offset - startOffset + j];
+                        bytes[length++] = HexDigits[byte >> 4];
+                        bytes[length++] = HexDigits[byte & 0x0F];
+                        bytes[length++] = ' ';
+                    }
+
+                    ImGui::TextUnformatted(bytes.data(), bytes.data() + std::max<size_t>(length, 1) - 1);
+                }
+                ImGui::TableNextColumn();
+                if (decoded) {
+                    ImGui::TextColored(ImColor(0xFFD69C56), "%s", instruction->mnemonic);
+                    ImGui::SameLine();
+                    ImGui::TextUnformatted(instruction->op_str);
+                }
+
+                offset += size;
+            }
+        }
+
+        clipper.End();
+    }
+
+    void ViewDisassembler::drawAnalysis() {
+        const auto &analysis = *this->m_analysis;
+
+        ImGui::TextFormatted("{}", hex::format("hex.builtin.view.disassembler.analysis.summary"_lang, analysis.getFunctions().size(), analysis.getBasicBlocks().size(), analysis.getReferences().size()));
+
+        if (ImGui::BeginTable("##functions", 2, ImGuiTableFlags_ScrollY | ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg, ImVec2(0, 150_scaled))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("hex.builtin.view.disassembler.analysis.function"_lang);
+            ImGui::TableSetupColumn("##bookmark", ImGuiTableColumnFlags_WidthFixed);
+
+            ImGui::TableHeadersRow();
+
+            const auto &functions = analysis.getFunctions();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(functions.size());
+
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    const auto address = functions[i];
+                    const auto block = analysis.findBasicBlock(address);
+                    const Region region = { this->toProviderAddress(address), block != nullptr ? block->size : 1 };
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(i);
+                    if (ImGui::Selectable("##Function", false, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowItemOverlap)) {
+                        ImHexApi::HexEditor::setSelection(region);
+                        this->m_referencedAddress = address;
+                    }
+                    ImGui::SameLine();
+                    ImGui::TextFormatted("sub_{0:X}", address);
+                    ImGui::TableNextColumn();
+                    if (ImGui::IconButton(ICON_VS_BOOKMARK, ImGui::GetStyleColorVec4(ImGuiCol_Text)))
+                        ImHexApi::Bookmarks::add(region.getStartAddress(), region.getSize(), hex::format("sub_{0:X}", address), "");
+                    ImGui::PopID();
+                }
+            }
+
+            clipper.End();
+
+            ImGui::EndTable();
+        }
+
+        ImGui::InputHexadecimal("hex.builtin.view.disassembler.analysis.references_to"_lang, &this->m_referencedAddress);
+
+        if (ImGui::BeginTable("##references", 2, ImGuiTableFlags_ScrollY | ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg, ImVec2(0, 150_scaled))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("hex.builtin.view.disassembler.analysis.reference.from"_lang);
+            ImGui::TableSetupColumn("hex.builtin.view.disassembler.analysis.reference.type"_lang);
+
+            ImGui::TableHeadersRow();
+
+            constexpr static std::array ReferenceTypeNames = {
+                "hex.builtin.view.disassembler.analysis.reference.call",
+                "hex.builtin.view.disassembler.analysis.reference.jump",
+                "hex.builtin.view.disassembler.analysis.reference.conditional_jump",
+                "hex.builtin.view.disassembler.analysis.reference.fall_through",
+                "hex.builtin.view.disassembler.analysis.reference.data"
+            };
+
+            const auto references = analysis.getReferencesTo(this->m_referencedAddress);
+
+            ImGuiListClipper clipper;
+            clipper.Begin(references.size());
+
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    const auto &reference = references[i];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(i);
+                    if (ImGui::Selectable("##Reference", false, ImGuiSelectableFlags_SpanAllColumns))
+                        ImHexApi::HexEditor::setSelection(this->toProviderAddress(reference.from), 1);
+                    ImGui::PopID();
+                    ImGui::SameLine();
+                    ImGui::TextFormatted("0x{0:X}", reference.from);
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(LangEntry(ReferenceTypeNames[u8(reference.type)]));
+                }
+            }
+
+            clipper.End();
+
+            ImGui::EndTable();
+        }
+    }
+
+}
@@ -3,8 +3,9 @@
 #include <hex/api/imhex_api.hpp>
 #include <hex/providers/buffered_reader.hpp>
 
+#include <algorithm>
 #include <array>
-#include <regex>
+#include <cctype>
 #include <string>
 #include <utility>
 #include <charconv>
@@ -16,18 +17,18 @@ namespace hex::plugin::builtin {
     ViewFind::ViewFind() : View("hex.builtin.view.find.name") {
         const static auto HighlightColor = [] { return (ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarPurple) & 0x00FFFFFF) | 0x70000000; };
 
-        ImHexApi::HexEditor::addBackgroundHighlightingProvider([this](u64 address, const u8* data, size_t size, bool) -> std::optional<color_t> {
-            hex::unused(data, size);
+        ImHexApi::HexEditor::addBackgroundHighlightingRegionProvider([this](const Region &region) {
+            std::vector<ImHexApi::HexEditor::Highlighting> result;
 
             if (this->m_searchTask.isRunning())
-                return { };
+                return result;
 
             auto provider = ImHexApi::Provider::get();
 
-            if (!this->m_occurrenceTree[provider].findOverlapping(address, address).empty())
-                return HighlightColor();
-            else
-                return std::nullopt;
+            for (const auto &occurrence : this->m_occurrenceTree[provider].findOverlapping(region.getStartAddress(), region.getEndAddress()))
+                result.emplace_back(occurrence.value.region, HighlightColor());
+
+            return result;
         });
 
         ImHexApi::HexEditor::addTooltipProvider([this](u64 address, const u8* data, size_t size) {
@@ -211,6 +212,56 @@ namespace hex::plugin::builtin {
         return hex::format("{}", value);
     }
 
+    constexpr static size_t SearchChunkSize = 0x40'0000;
+
+    /**
+     * @brief Splits a search region into chunks and searches all of them in parallel on all available cores
+     * @param task Task to report the combined progress of all chunks to
+     * @param searchRegion Region to search
+     * @param searchChunk Function returning all occurrences starting inside of the given chunk in ascending order.
+     * It may read past the end of the chunk to complete occurrences that start inside of it
+     * @return Occurrences of all chunks in ascending order
+     */
+    template<typename Function>
+    static auto searchChunks(Task &task, Region searchRegion, Function searchChunk) {
+        using Results = std::invoke_result_t<Function, Region>;
+
+        if (searchRegion.getSize() == 0)
+            return Results { };
+
+        const size_t chunkCount = (searchRegion.getSize() + SearchChunkSize - 1) / SearchChunkSize;
+        std::vector<Results> chunkResults(chunkCount);
+
+        task.parallelFor(searchRegion, SearchChunkSize, [&](Task &, Region chunk) {
+            chunkResults[(chunk.getStartAddress() - searchRegion.getStartAddress()) / SearchChunkSize] = searchChunk(chunk);
+        });
+
+        Results results;
+        for (auto &chunk : chunkResults)
+            std::move(chunk.begin(), chunk.end(), std::back_inserter(results));
+
+        return results;
+    }
+
+    /**
+     * @brief Finds all occurrences of a byte pattern that start inside of a chunk
+     * @param provider Provider to read from
+     * @param searchRegion Region that is being searched, the chunk is extended up to its end to complete occurrences crossing the end of the chunk
+     * @param chunk Chunk to search
+     * @param pattern Pattern to search for
+     * @return Regions of all occurrences in ascending order
+     */
+    static std::vector<Region> findPatternInChunk(prv::Provider *provider, Region searchRegion, Region chunk, const BytePattern &pattern) {
+        std::vector<u8> data(std::min<u64>(chunk.getSize() + pattern.size() - 1, searchRegion.getEndAddress() - chunk.getStartAddress() + 1));
+        provider->read(chunk.getStartAddress(), data.data(), data.size());
+
+        std::vector<Region> results;
+        for (auto offset = pattern.find(data); offset.has_value(); offset = pattern.find(data, *offset + 1))
+            results.push_back(Region { chunk.getStartAddress() + *offset, pattern.size() });
+
+        return results;
+    }
+
     std::vector<ViewFind::Occurrence> ViewFind::searchStrings(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Strings &settings) {
         using enum SearchSettings::StringType;
 
@@ -236,10 +287,6 @@ namespace hex::plugin::builtin {
             return results;
         }
 
-        auto reader = prv::ProviderReader(provider);
-        reader.seek(searchRegion.getStartAddress());
-        reader.setEndAddress(searchRegion.getEndAddress());
-
         const auto [decodeType, endian] = [&] -> std::pair<Occurrence::DecodeType, std::endian> {
             if (settings.type == ASCII)
                 return { Occurrence::DecodeType::ASCII, std::endian::native };
@@ -251,13 +298,8 @@ namespace hex::plugin::builtin {
                 return { Occurrence::DecodeType::Binary, std::endian::native };
         }();
 
-        size_t countedCharacters = 0;
-        u64 startAddress = reader.begin().getAddress();
-        u64 endAddress = reader.end().getAddress();
-
-        u64 progress = 0;
-        for (u8 byte : reader) {
-            bool validChar =
+        auto isCharacter = [&](u8 byte) {
+            return
                 (settings.lowerCaseLetters    && std::islower(byte))  ||
                 (settings.upperCaseLetters    && std::isupper(byte))  ||
                 (settings.numbers             && std::isdigit(byte))  ||
@@ -265,144 +307,211 @@ namespace hex::plugin::builtin {
                 (settings.underscores         && byte == '_')             ||
                 (settings.symbols             && std::ispunct(byte) && !std::isspace(byte))  ||
                 (settings.lineFeeds           && (byte == '\r' || byte == '\n'));
+        };
+
+        // Bytes that end a string no matter how many characters came before them
+        auto isStringBreak = [&](u8 byte) {
+            if (settings.type == ASCII)
+                return !isCharacter(byte);
+            else
+                return !isCharacter(byte) && byte != 0x00;
+        };
+
+        return searchChunks(task, searchRegion, [&](Region chunk) {
+            std::vector<Occurrence> results;
+
+            auto reader = prv::ProviderReader(provider);
+            reader.setEndAddress(searchRegion.getEndAddress());
+
+            u64 startAddress = chunk.getStartAddress();
+            const u64 endAddress = reader.end().getAddress();
 
-            if (settings.type == UTF16LE) {
-                // Check if second byte of UTF-16 encoded string is 0x00
-                if (countedCharacters % 2 == 1)
-                    validChar =  byte == 0x00;
-            } else if (settings.type == UTF16BE) {
-                // Check if first byte of UTF-16 encoded string is 0x00
-                if (countedCharacters % 2 == 0)
-                    validChar =  byte == 0x00;
+            // Strings can cross chunk boundaries. The previous chunk's search continues up to the first string break at or after the end of
+            // its chunk, so start right after that same byte. If there is none inside this chunk, the whole chunk is part of a string found by the previous one
+            if (startAddress != searchRegion.getStartAddress()) {
+                reader.seek(startAddress - 1);
+
+                auto it = reader.begin();
+                while (it != reader.end() && it.getAddress() < chunk.getEndAddress() && !isStringBreak(*it))
+                    ++it;
+
+                if (it == reader.end() || it.getAddress() >= chunk.getEndAddress())
+                    return results;
+
+                startAddress = it.getAddress() + 1;
             }
 
-            task.update(progress);
+            reader.seek(startAddress);
 
-            if (validChar)
-                countedCharacters++;
-            if (!validChar || startAddress + countedCharacters == endAddress) {
-                if (countedCharacters >= size_t(settings.minLength)) {
-                    if (!(settings.nullTermination && byte != 0x00)) {
-                        results.push_back(Occurrence { Region { startAddress, countedCharacters }, decodeType, endian });
-                    }
+            size_t countedCharacters = 0;
+            for (u8 byte : reader) {
+                bool validChar = isCharacter(byte);
+
+                if (settings.type == UTF16LE) {
+                    // Check if second byte of UTF-16 encoded string is 0x00
+                    if (countedCharacters % 2 == 1)
+                        validChar =  byte == 0x00;
+                } else if (settings.type == UTF16BE) {
+                    // Check if first byte of UTF-16 encoded string is 0x00
+                    if (countedCharacters % 2 == 0)
+                        validChar =  byte == 0x00;
                 }
 
-                startAddress += countedCharacters + 1;
-                countedCharacters = 0;
-                progress = startAddress - searchRegion.getStartAddress();
+                if (validChar)
+                    countedCharacters++;
+                if (!validChar || startAddress + countedCharacters == endAddress) {
+                    if (countedCharacters >= size_t(settings.minLength)) {
+                        if (!(settings.nullTermination && byte != 0x00)) {
+                            results.push_back(Occurrence { Region { startAddress, countedCharacters }, decodeType, endian });
+                        }
+                    }
 
+                    startAddress += countedCharacters + 1;
+                    countedCharacters = 0;
+
+                    // Everything after the first string break past the end of the chunk is handled by the next chunk
+                    if (!validChar && isStringBreak(byte) && startAddress > chunk.getEndAddress())
+                        break;
+                }
             }
-        }
 
-        return results;
+            return results;
+        });
     }
 
     std::vector<ViewFind::Occurrence> ViewFind::searchSequence(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Sequence &settings) {
-        std::vector<Occurrence> results;
-
-        auto reader = prv::ProviderReader(provider);
-        reader.seek(searchRegion.getStartAddress());
-        reader.setEndAddress(searchRegion.getEndAddress());
-
         auto bytes = hex::decodeByteString(settings.sequence);
 
         if (bytes.empty())
             return { };
 
-        auto occurrence = reader.begin();
-        u64 progress = 0;
-        while (true) {
-            task.update(progress);
+        const BytePattern pattern(bytes);
 
-            occurrence = std::search(reader.begin(), reader.end(), std::boyer_moore_horspool_searcher(bytes.begin(), bytes.end()));
-            if (occurrence == reader.end())
-                break;
-
-            auto address = occurrence.getAddress();
-            reader.seek(address + 1);
-            results.push_back(Occurrence{ Region { address, bytes.size() }, Occurrence::DecodeType::Binary, std::endian::native });
-            progress = address - searchRegion.getStartAddress();
-        }
+        return searchChunks(task, searchRegion, [&](Region chunk) {
+            std::vector<Occurrence> results;
+            for (const auto &region : findPatternInChunk(provider, searchRegion, chunk, pattern))
+                results.push_back(Occurrence { region, Occurrence::DecodeType::Binary, std::endian::native });
 
-        return results;
+            return results;
+        });
     }
 
     std::vector<ViewFind::Occurrence> ViewFind::searchRegex(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Regex &settings) {
-        auto stringOccurrences = searchStrings(task, provider, searchRegion, SearchSettings::Strings {
-            .minLength          = settings.minLength,
-            .nullTermination    = settings.nullTermination,
-            .type               = settings.type,
-            .lowerCaseLetters   = true,
-            .upperCaseLetters   = true,
-            .numbers            = true,
-            .underscores        = true,
-            .symbols            = true,
-            .spaces             = true,
-            .lineFeeds          = true
-        });
+        using enum SearchSettings::StringType;
 
-        std::vector<Occurrence> result;
-        std::regex regex(settings.pattern);
-        for (const auto &occurrence : stringOccurrences) {
-            std::string string(occurrence.region.getSize(), '\x00');
-            provider->read(occurrence.region.getStartAddress(), string.data(), occurrence.region.getSize());
+        if (searchRegion.getSize() == 0)
+            return { };
 
-            task.update();
+        std::vector<ByteRegex::Encoding> encodings;
+        if (settings.type == ASCII || settings.type == ASCII_UTF16LE || settings.type == ASCII_UTF16BE)
+            encodings.push_back(ByteRegex::Encoding::Bytes);
+        if (settings.type == UTF16LE || settings.type == ASCII_UTF16LE)
+            encodings.push_back(ByteRegex::Encoding::UTF16LE);
+        if (settings.type == UTF16BE || settings.type == ASCII_UTF16BE)
+            encodings.push_back(ByteRegex::Encoding::UTF16BE);
+
+        // Null terminated matches get searched for by appending the terminator to the pattern itself
+        const auto pattern = settings.nullTermination ? hex::format("(?:{})\\x00", settings.pattern) : settings.pattern;
+
+        std::vector<ByteRegex> regexes;
+        for (auto encoding : encodings) {
+            auto regex = ByteRegex::compile(pattern, encoding);
+            if (!regex.has_value())
+                return { };
+
+            regexes.push_back(std::move(*regex));
+        }
 
-            if (settings.fullMatch) {
-                if (std::regex_match(string, regex))
-                    result.push_back(occurrence);
+        // Reads the character at the given address, or nothing if it lies outside of the searched region
+        auto readCharacter = [&](u64 address, size_t characterSize, std::endian endian) -> std::optional<u16> {
+            if (address < searchRegion.getStartAddress() || address + characterSize - 1 > searchRegion.getEndAddress())
+                return std::nullopt;
+
+            u16 character = 0;
+            if (characterSize == sizeof(u8)) {
+                u8 byte = 0;
+                provider->read(address, &byte, sizeof(byte));
+                character = byte;
             } else {
-                if (std::regex_search(string, regex))
-                    result.push_back(occurrence);
+                provider->read(address, &character, sizeof(character));
+                character = hex::changeEndianess(character, endian);
             }
-        }
 
-        return result;
-    }
+            return character;
+        };
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchBinaryPattern(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::BinaryPattern &settings) {
-        std::vector<Occurrence> results;
+        // Full matches have to span an entire string, so the characters around them may not be part of one
+        auto isStringCharacter = [](std::optional<u16> character) {
+            return character.has_value() && *character <= 0xFF && (std::isprint(*character) || std::isspace(*character));
+        };
 
-        auto reader = prv::ProviderReader(provider);
-        reader.seek(searchRegion.getStartAddress());
-        reader.setEndAddress(searchRegion.getEndAddress());
+        std::vector<Occurrence> results;
+        std::vector<ByteRegex::Matcher> matchers;
+        matchers.reserve(regexes.size());
+
+        // Leftmost-longest matches depend on everything that came before them so the region is searched in a single pass
+        for (size_t i = 0; i < regexes.size(); i++) {
+            const auto encoding = encodings[i];
+            const size_t characterSize = encoding == ByteRegex::Encoding::Bytes ? sizeof(u8) : sizeof(u16);
+            const auto endian = encoding == ByteRegex::Encoding::UTF16BE ? std::endian::big : std::endian::little;
+            const auto decodeType = encoding == ByteRegex::Encoding::Bytes ? Occurrence::DecodeType::ASCII : Occurrence::DecodeType::UTF16;
+
+            matchers.emplace_back(regexes[i], searchRegion.getStartAddress(), [&, characterSize, endian, decodeType](Region match) {
+                if (settings.nullTermination)
+                    match.size -= characterSize;
+
+                if (match.getSize() / characterSize < size_t(settings.minLength))
+                    return;
+
+                if (settings.fullMatch) {
+                    if (isStringCharacter(readCharacter(match.getStartAddress() - characterSize, characterSize, endian)))
+                        return;
+                    if (!settings.nullTermination && isStringCharacter(readCharacter(match.getEndAddress() + 1, characterSize, endian)))
+                        return;
+                }
 
-        u32 matchedBytes = 0;
-        const size_t patternSize = settings.pattern.size();
+                results.push_back(Occurrence { match, decodeType, endian });
+            });
+        }
 
-        u64 progress = 0;
-        for (auto it = reader.begin(); it != reader.end(); ++it) {
-            auto byte = *it;
+        std::vector<u8> buffer(std::min<u64>(SearchChunkSize, searchRegion.getSize()));
+        for (u64 offset = 0; offset < searchRegion.getSize(); offset += buffer.size()) {
+            const auto size = std::min<u64>(buffer.size(), searchRegion.getSize() - offset);
+            provider->read(searchRegion.getStartAddress() + offset, buffer.data(), size);
 
-            task.update(progress);
-            if ((byte & settings.pattern[matchedBytes].mask) == settings.pattern[matchedBytes].value) {
-                matchedBytes++;
-                if (matchedBytes == settings.pattern.size()) {
-                    auto occurrenceAddress = it.getAddress() - (patternSize - 1);
+            for (auto &matcher : matchers)
+                matcher.feed({ buffer.data(), size });
 
-                    results.push_back(Occurrence { Region { occurrenceAddress, patternSize }, Occurrence::DecodeType::Binary, std::endian::native });
-                    progress = occurrenceAddress;
-                    it.setAddress(occurrenceAddress);
-                    matchedBytes = 0;
-                }
-            } else {
-                if (matchedBytes > 0)
-                    it -= matchedBytes;
-                matchedBytes = 0;
-            }
+            task.update(offset + size);
         }
 
+        for (auto &matcher : matchers)
+            matcher.finish();
+
+        // Every encoding reported its matches in ascending order
+        std::sort(results.begin(), results.end(), [](const Occurrence &a, const Occurrence &b) {
+            return a.region.getStartAddress() < b.region.getStartAddress();
+        });
+
         return results;
     }
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchValue(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Value &settings) {
-        std::vector<Occurrence> results;
+    std::vector<ViewFind::Occurrence> ViewFind::searchBinaryPattern(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::BinaryPattern &settings) {
+        if (settings.pattern.empty())
+            return { };
 
-        auto reader = prv::ProviderReader(provider);
-        reader.seek(searchRegion.getStartAddress());
-        reader.setEndAddress(searchRegion.getEndAddress());
+        const BytePattern pattern(settings.pattern);
+
+        return searchChunks(task, searchRegion, [&](Region chunk) {
+            std::vector<Occurrence> results;
+            for (const auto &region : findPatternInChunk(provider, searchRegion, chunk, pattern))
+                results.push_back(Occurrence { region, Occurrence::DecodeType::Binary, std::endian::native });
+
+            return results;
+        });
+    }
 
+    std::vector<ViewFind::Occurrence> ViewFind::searchValue(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Value &settings) {
         const auto [validMin, min, sizeMin] = parseNumericValueInput(settings.inputMin, settings.type);
         const auto [validMax, max, sizeMax] = parseNumericValueInput(settings.inputMax, settings.type);
 
@@ -411,68 +520,74 @@ namespace hex::plugin::builtin {
 
         const auto size = sizeMin;
 
-        u64 bytes = 0x00;
-        u64 address = searchRegion.getStartAddress();
-        size_t validBytes = 0;
-        for (u8 byte : reader) {
-            bytes <<= 8;
-            bytes |= byte;
-
-            if (validBytes == size) {
-                bytes &= hex::bitmask(size * 8);
-
-                task.update(address);
-
-                auto result = std::visit([&](auto tag) {
-                    using T = std::remove_cvref_t<std::decay_t<decltype(tag)>>;
-
-                    auto minValue = std::get<T>(min);
-                    auto maxValue = std::get<T>(max);
-
-                    T value = 0;
-                    std::memcpy(&value, &bytes, size);
-                    value = hex::changeEndianess(value, size, std::endian::big);
-                    value = hex::changeEndianess(value, size, settings.endian);
-
-                    return value >= minValue && value <= maxValue;
-                }, min);
-
-                if (result) {
-                    Occurrence::DecodeType decodeType = [&]{
-                        switch (settings.type) {
-                            using enum SearchSettings::Value::Type;
-                            using enum Occurrence::DecodeType;
-
-                            case U8:
-                            case U16:
-                            case U32:
-                            case U64:
-                                return Unsigned;
-                            case I8:
-                            case I16:
-                            case I32:
-                            case I64:
-                                return Signed;
-                            case F32:
-                                return Float;
-                            case F64:
-                                return Double;
-                            default:
-                                return Binary;
-                        }
-                    }();
+        const Occurrence::DecodeType decodeType = [&]{
+            switch (settings.type) {
+                using enum SearchSettings::Value::Type;
+                using enum Occurrence::DecodeType;
+
+                case U8:
+                case U16:
+                case U32:
+                case U64:
+                    return Unsigned;
+                case I8:
+                case I16:
+                case I32:
+                case I64:
+                    return Signed;
+                case F32:
+                    return Float;
+                case F64:
+                    return Double;
+                default:
+                    return Binary;
+            }
+        }();
+
+        return searchChunks(task, searchRegion, [&](Region chunk) {
+            std::vector<Occurrence> results;
+
+            // Read a little past the end of the chunk so values starting at its very end are found as well
+            auto reader = prv::ProviderReader(provider);
+            reader.seek(chunk.getStartAddress());
+            reader.setEndAddress(std::min<u64>(chunk.getEndAddress() + size - 1, searchRegion.getEndAddress()));
+
+            u64 bytes = 0x00;
+            u64 address = chunk.getStartAddress();
+            size_t validBytes = 0;
+            for (u8 byte : reader) {
+                bytes <<= 8;
+                bytes |= byte;
+
+                if (validBytes < size)
+                    validBytes++;
+
+                if (validBytes == size) {
+                    bytes &= hex::bitmask(size * 8);
+
+                    auto result = std::visit([&](auto tag) {
+                        using T = std::remove_cvref_t<std::decay_t<decltype(tag)>>;
+
+                        auto minValue = std::get<T>(min);
+                        auto maxValue = std::get<T>(max);
 
+                        T value = 0;
+                        std::memcpy(&value, &bytes, size);
+                        value = hex::changeEndianess(value, size, std::endian::big);
+                        value = hex::changeEndianess(value, size, settings.endian);
 
-                    results.push_back(Occurrence { Region { address - (size - 1), size }, decodeType, settings.endian });
+                        return value >= minValue && value <= maxValue;
+                    }, min);
+
+                    if (result)
+                        results.push_back(Occurrence { Region { address - (size - 1), size }, decodeType, settings.endian });
                 }
-            } else {
-                validBytes++;
-            }
 
-            address++;
-        }
+                address++;
+            }
 
-        return results;
+            return results;
+        });
     }
 
     void ViewFind::runSearch() {
@@ -485,6 +600,8 @@ namespace hex::plugin::builtin {
             }
         }();
 
+        EventManager::post<EventHighlightingChanged>();
+
         this->m_searchTask = TaskManager::createTask("hex.builtin.view.find.searching", searchRegion.getSize(), [this, settings = this->m_searchSettings, searchRegion](auto &task) {
             auto provider = ImHexApi::Provider::get();
 
@@ -513,6 +630,8 @@ namespace hex::plugin::builtin {
             for (const auto &occurrence : this->m_foundOccurrences[provider])
                 intervals.push_back(OccurrenceTree::interval(occurrence.region.getStartAddress(), occurrence.region.getEndAddress(), occurrence));
             this->m_occurrenceTree[provider] = std::move(intervals);
+
+            EventManager::post<EventHighlightingChanged>();
         });
     }
 
@@ -671,15 +790,7 @@ namespace hex::plugin::builtin {
 
                         ImGui::InputTextIcon("hex.builtin.view.find.regex.pattern"_lang, ICON_VS_REGEX, settings.pattern);
 
-                        try {
-                            std::regex regex(settings.pattern);
-                            this->m_settingsValid = true;
-                        } catch (std::regex_error &e) {
-                            this->m_settingsValid = false;
-                        }
-
-                        if (settings.pattern.empty())
-                            this->m_settingsValid = false;
+                        this->m_settingsValid = !settings.pattern.empty() && ByteRegex::compile(settings.pattern).has_value();
 
                         ImGui::Checkbox("hex.builtin.view.find.regex.full_match"_lang, &settings.fullMatch);
 
@@ -786,6 +897,8 @@ namespace hex::plugin::builtin {
                         this->m_foundOccurrences[provider].clear();
                         this->m_sortedOccurrences[provider].clear();
                         this->m_occurrenceTree[provider].clear();
+
+                        EventManager::post<EventHighlightingChanged>();
                     }
                 }
                 ImGui::EndDisabled();
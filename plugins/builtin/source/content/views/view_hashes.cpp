@@ -2,16 +2,75 @@
 #include "content/helpers/provider_extra_data.hpp"
 
 #include <hex/api/project_file_manager.hpp>
+#include <hex/api/task.hpp>
 #include <hex/helpers/crypto.hpp>
 
 #include <vector>
 
+#include <wolv/utils/guards.hpp>
+
 namespace hex::plugin::builtin {
 
+    // Amount of data read at once while calculating hashes
+    constexpr static size_t HashBlockSize = 0x40'0000;
+
+    namespace {
+
+        /**
+         * @brief Calculates multiple hashes of a region while reading the data only once
+         * The data is read in large blocks. Every block is handed to all hashers at once, each of them running on its own worker thread,
+         * while the next block is being read in the background
+         * @param task Task to report progress to
+         * @param provider Provider to read from
+         * @param region Region to hash
+         * @param hashers Hashers to feed the data to
+         */
+        void calculateHashes(Task &task, prv::Provider *provider, Region region, const std::vector<std::unique_ptr<crypt::Hasher>> &hashers) {
+            std::array<std::vector<u8>, 2> buffers;
+            std::array<prv::DataView, 2> blocks;
+
+            const auto readBlock = [&](u32 slot, u64 offset) {
+                const auto size = std::min<u64>(HashBlockSize, region.getSize() - offset);
+
+                if (auto view = provider->getDataView(region.getStartAddress() + offset, size); view.has_value()) {
+                    blocks[slot] = std::move(*view);
+                } else {
+                    buffers[slot].resize(size);
+                    provider->read(region.getStartAddress() + offset, buffers[slot].data(), size);
+                    blocks[slot] = prv::DataView(buffers[slot]);
+                }
+            };
+
+            if (region.getSize() == 0)
+                return;
+
+            readBlock(0, 0);
+
+            u32 currSlot = 0;
+            for (u64 offset = 0; offset < region.getSize(); offset += blocks[currSlot ^ 1].size()) {
+                const auto nextOffset = offset + blocks[currSlot].size();
+
+                // One chunk per hasher plus one that reads the next block into the other slot
+                task.parallelFor({ 0, hashers.size() + 1 }, 1, [&](Task &, Region chunk) {
+                    const auto index = chunk.getStartAddress();
+
+                    if (index < hashers.size())
+                        hashers[index]->update(blocks[currSlot]);
+                    else if (nextOffset < region.getSize())
+                        readBlock(currSlot ^ 1, nextOffset);
+                });
+
+                task.update(nextOffset);
+                currSlot ^= 1;
+            }
+        }
+
+    }
+
     ViewHashes::ViewHashes() : View("hex.builtin.view.hashes.name") {
         EventManager::subscribe<EventRegionSelected>(this, [](const auto &providerRegion) {
-            for (auto &function : ProviderExtraData::get(providerRegion.getProvider()).hashes.hashFunctions)
-                function.reset();
+            // Hashes of the previous selection aren't needed anymore
+            cancelCalculations(providerRegion.getProvider());
         });
 
         ImHexApi::HexEditor::addTooltipProvider([](u64 address, const u8 *data, size_t size) {
@@ -33,18 +92,24 @@ namespace hex::plugin::builtin {
 
                         ImGui::Indent();
                         if (ImGui::BeginTable("##hashes_tooltip", 3, ImGuiTableFlags_NoHostExtendX | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
-                            auto provider  = ImHexApi::Provider::get();
-                            for (auto &function : hashFunctions) {
+                            auto provider  = selection->getProvider();
+                            for (u32 i = 0; i < hashFunctions.size(); i++) {
                                 ImGui::TableNextRow();
                                 ImGui::TableNextColumn();
-                                ImGui::TextFormatted("{}", function.getName());
+                                ImGui::TextFormatted("{}", hashFunctions[i].getName());
 
                                 ImGui::TableNextColumn();
                                 ImGui::TextFormatted("    ");
 
                                 ImGui::TableNextColumn();
-                                if (provider != nullptr)
-                                    ImGui::TextFormatted("{}", crypt::encode16(function.get(*selection, provider)));
+                                if (provider != nullptr) {
+                                    if (auto hash = getHash(provider, i, *selection); hash.has_value())
+                                        ImGui::TextFormatted("{}", crypt::encode16(*hash));
+                                    else if (hasHashFailed(provider, i))
+                                        ImGui::TextFormattedColored(ImGui::GetCustomColorVec4(ImGuiCustomCol_ToolbarRed), "{}", "hex.builtin.view.hashes.failed"_lang);
+                                    else
+                                        ImGui::TextSpinner("hex.builtin.view.hashes.calculating"_lang);
+                                }
                             }
 
                             ImGui::EndTable();
@@ -68,6 +133,7 @@ namespace hex::plugin::builtin {
                     return true;
 
                 auto data = nlohmann::json::parse(fileContent.begin(), fileContent.end());
+                cancelCalculations(provider);
                 ProviderExtraData::get(provider).hashes.hashFunctions.clear();
 
                 return ViewHashes::importHashes(provider, data);
@@ -87,6 +153,81 @@ namespace hex::plugin::builtin {
         EventManager::unsubscribe<EventRegionSelected>(this);
     }
 
+    std::optional<std::vector<u8>> ViewHashes::getHash(prv::Provider *provider, u32 index, const Region &region) {
+        auto &hashes = ProviderExtraData::get(provider).hashes;
+        hashes.calculations.resize(hashes.hashFunctions.size());
+
+        if (auto &calculation = hashes.calculations[index].calculation; calculation == nullptr || calculation->region != region)
+            startCalculation(provider, region);
+
+        const auto &[calculation, resultIndex] = hashes.calculations[index];
+        if (!calculation->done)
+            return std::nullopt;
+
+        return calculation->results[resultIndex];
+    }
+
+    bool ViewHashes::hasHashFailed(prv::Provider *provider, u32 index) {
+        const auto &calculations = ProviderExtraData::get(provider).hashes.calculations;
+        if (index >= calculations.size() || calculations[index].calculation == nullptr)
+            return false;
+
+        return calculations[index].calculation->failed;
+    }
+
+    void ViewHashes::startCalculation(prv::Provider *provider, const Region &region) {
+        using Calculation = ProviderExtraData::Data::Hashes::Calculation;
+
+        auto &hashes = ProviderExtraData::get(provider).hashes;
+        hashes.calculations.resize(hashes.hashFunctions.size());
+
+        // Calculate all hashes that are out of date together so the data only needs to be read once
+        auto calculation = std::make_shared<Calculation>();
+        calculation->region = region;
+
+        std::vector<ContentRegistry::Hashes::Hash::Function> functions;
+        for (u32 i = 0; i < hashes.calculations.size(); i++) {
+            auto &entry = hashes.calculations[i];
+            if (entry.calculation != nullptr && entry.calculation->region == region)
+                continue;
+
+            if (entry.calculation != nullptr)
+                entry.calculation->task.interrupt();
+
+            entry = { calculation, functions.size() };
+            functions.push_back(hashes.hashFunctions[i]);
+        }
+
+        calculation->results.resize(functions.size());
+        calculation->task = TaskManager::createTask("hex.builtin.view.hashes.calculating", region.getSize(), [calculation, functions = std::move(functions), provider, region](Task &task) {
+            // Interrupting the task or an exception thrown by a hasher leaves the calculation unfinished
+            ON_SCOPE_EXIT {
+                if (!calculation->done)
+                    calculation->failed = true;
+            };
+
+            std::vector<std::unique_ptr<crypt::Hasher>> hashers;
+            for (const auto &function : functions)
+                hashers.push_back(function.createHasher());
+
+            calculateHashes(task, provider, region, hashers);
+
+            for (u32 i = 0; i < hashers.size(); i++)
+                calculation->results[i] = hashers[i]->finish();
+
+            calculation->done = true;
+        });
+    }
+
+    void ViewHashes::cancelCalculations(prv::Provider *provider) {
+        auto &calculations = ProviderExtraData::get(provider).hashes.calculations;
+        for (auto &entry : calculations) {
+            if (entry.calculation != nullptr)
+                entry.calculation->task.interrupt();
+        }
+
+        calculations.clear();
+    }
 
     void ViewHashes::drawContent() {
         const auto &hashes = ContentRegistry::Hashes::impl::getHashes();
@@ -181,20 +322,33 @@ namespace hex::plugin::builtin {
                     ImGui::TextFormatted("{}", LangEntry(function.getType()->getUnlocalizedName()));
 
                     ImGui::TableNextColumn();
-                    std::string result;
-                    if (provider != nullptr && selection.has_value())
-                        result = crypt::encode16(function.get(*selection, provider));
-                    else
+                    std::optional<std::string> result;
+                    if (provider != nullptr && selection.has_value()) {
+                        if (auto hash = getHash(provider, i, *selection); hash.has_value())
+                            result = crypt::encode16(*hash);
+                    } else {
                         result = "???";
+                    }
 
-                    ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
-                    ImGui::InputText("##result", result, ImGuiInputTextFlags_ReadOnly);
-                    ImGui::PopItemWidth();
+                    if (result.has_value()) {
+                        ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
+                        ImGui::InputText("##result", *result, ImGuiInputTextFlags_ReadOnly);
+                        ImGui::PopItemWidth();
+                    } else if (provider != nullptr && hasHashFailed(provider, i)) {
+                        ImGui::TextFormattedColored(ImGui::GetCustomColorVec4(ImGuiCustomCol_ToolbarRed), "{}", "hex.builtin.view.hashes.failed"_lang);
+                    } else {
+                        ImGui::TextSpinner("hex.builtin.view.hashes.calculating"_lang);
+                    }
 
                     ImGui::PopID();
                 }
 
                 if (indexToRemove.has_value()) {
+                    // Other hash functions might be part of the same calculation so it needs to keep running
+                    auto &calculations = ProviderExtraData::getCurrent().hashes.calculations;
+                    if (*indexToRemove < calculations.size())
+                        calculations.erase(calculations.begin() + indexToRemove.value());
+
                     hashFunctions.erase(hashFunctions.begin() + indexToRemove.value());
                 }
 
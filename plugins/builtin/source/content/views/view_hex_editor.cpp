@@ -3,6 +3,7 @@
 #include <hex/api/content_registry.hpp>
 #include <hex/api/keybinding.hpp>
 #include <hex/helpers/utils.hpp>
+#include <hex/helpers/byte_pattern.hpp>
 #include <hex/providers/buffered_reader.hpp>
 #include <hex/helpers/crypto.hpp>
 
@@ -12,6 +13,10 @@
 #include <imgui_internal.h>
 #include <nlohmann/json.hpp>
 
+#include <wolv/utils/guards.hpp>
+
+#include <chrono>
+#include <mutex>
 #include <thread>
 
 using namespace std::literals::string_literals;
@@ -155,10 +160,36 @@ namespace hex::plugin::builtin {
                 this->m_searchPosition = this->m_nextSearchPosition.value_or(region.getStartAddress());
                 this->m_nextSearchPosition.reset();
             });
+
+            EventManager::subscribe<EventProviderDataModified>(this, [hitIndex = this->m_hitIndex](prv::Provider *provider, const Region &) {
+                std::scoped_lock lock(hitIndex->mutex);
+                hitIndex->generation++;
+                if (hitIndex->provider == provider)
+                    hitIndex->valid = false;
+            });
+
+            EventManager::subscribe<EventProviderClosing>(this, [this](prv::Provider *provider, bool *) {
+                this->dropHitIndex(provider);
+            });
+
+            EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+                // The indexing task may be in the middle of reading from the provider. Let it stop before the provider is gone
+                auto task = this->m_indexTask;
+                this->dropHitIndex(provider);
+
+                while (task.isRunning())
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
         }
 
         ~PopupFind() override {
             EventManager::unsubscribe<EventRegionSelected>(this);
+            EventManager::unsubscribe<EventProviderDataModified>(this);
+            EventManager::unsubscribe<EventProviderClosing>(this);
+            EventManager::unsubscribe<EventProviderDeleted>(this);
+
+            this->m_searchTask.interrupt();
+            this->m_indexTask.interrupt();
         }
 
         void draw(ViewHexEditor *editor) override {
@@ -208,9 +239,28 @@ namespace hex::plugin::builtin {
             }
 
             if (!this->m_searchTask.isRunning() && !searchSequence.empty() && this->m_shouldSearch) {
-                this->m_searchTask = TaskManager::createTask("hex.builtin.common.processing", ImHexApi::Provider::get()->getActualSize(), [this, editor, searchSequence](auto &) {
+                auto provider = ImHexApi::Provider::get();
+
+                // Index all occurrences in the background so searching for the next or previous one doesn't need to scan the data again
+                const bool indexing = this->m_indexTask.isRunning() && this->m_indexedProvider == provider && this->m_indexedSequence == searchSequence;
+                if (!indexing && !this->m_hitIndex->contains(provider, searchSequence)) {
+                    this->m_indexTask.interrupt();
+                    this->m_indexTask = TaskManager::createBackgroundTask("Indexing search results", [hitIndex = this->m_hitIndex, provider, searchSequence](Task &task) {
+                        buildHitIndex(task, *hitIndex, provider, searchSequence);
+                    });
+
+                    this->m_indexedProvider = provider;
+                    this->m_indexedSequence = searchSequence;
+                }
+
+                this->m_searchTask = TaskManager::createTask("hex.builtin.common.processing", provider->getActualSize(), [this, editor, provider, searchSequence](auto &task) {
+                    ON_SCOPE_EXIT {
+                        this->m_shouldSearch = false;
+                        this->m_requestFocus = true;
+                    };
+
                     for (u8 retry = 0; retry < 2; retry++) {
-                        auto region = this->findSequence(searchSequence, this->m_backwards);
+                        auto region = this->findSequence(task, provider, searchSequence, this->m_backwards);
 
                         if (region.has_value()) {
                             if (editor->getSelection() == region) {
@@ -231,9 +281,6 @@ namespace hex::plugin::builtin {
                             this->m_reachedEnd = true;
                         }
                     }
-
-                    this->m_shouldSearch = false;
-                    this->m_requestFocus = true;
                 });
             }
         }
@@ -248,10 +295,15 @@ namespace hex::plugin::builtin {
                 this->m_requestFocus = false;
             }
 
+            ImGui::SameLine();
+            if (this->m_searchTask.isRunning()) {
+                if (ImGui::IconButton(ICON_VS_DEBUG_STOP "##stop", ImGui::GetCustomColorVec4(ImGuiCustomCol_ToolbarRed), ButtonSize))
+                    this->m_searchTask.interrupt();
+            }
+
             ImGui::BeginDisabled(this->m_searchTask.isRunning());
             {
-                ImGui::SameLine();
-                if (ImGui::IconButton(ICON_VS_SEARCH "##search", ButtonColor, ButtonSize)) {
+                if (!this->m_searchTask.isRunning() && ImGui::IconButton(ICON_VS_SEARCH "##search", ButtonColor, ButtonSize)) {
                     this->m_shouldSearch = true;
                     this->m_backwards = false;
                     this->m_reachedEnd = false;
@@ -289,32 +341,165 @@ namespace hex::plugin::builtin {
             ImGui::EndDisabled();
         }
 
-        std::optional<Region> findSequence(const std::vector<u8> &sequence, bool backwards) {
-            auto provider = ImHexApi::Provider::get();
+        constexpr static size_t SearchBlockSize = 0x10'0000;
+
+        // Addresses of all occurrences of the last searched sequence
+        struct HitIndex {
+            std::mutex mutex;
+
+            bool valid = false;
+            u64 generation = 0;
+            prv::Provider *provider = nullptr;
+            std::vector<u8> sequence;
+            std::vector<u64> hits;
+
+            // The sequence occurs too often to be indexed. The data gets scanned instead of looking up the hits
+            bool tooManyHits = false;
+
+            [[nodiscard]] bool contains(prv::Provider *searchedProvider, const std::vector<u8> &searchedSequence) {
+                std::scoped_lock lock(this->mutex);
+                return this->valid && this->provider == searchedProvider && this->sequence == searchedSequence;
+            }
+        };
+
+        static void buildHitIndex(Task &task, HitIndex &hitIndex, prv::Provider *provider, const std::vector<u8> &sequence) {
+            // Sequences occurring this often are cheap to find by scanning anyway
+            constexpr static size_t MaxHitCount = 1'000'000;
+
+            const BytePattern pattern(sequence);
+            const u64 dataStart = provider->getBaseAddress();
+            const u64 dataEnd   = dataStart + provider->getActualSize();
+
+            if (pattern.empty() || pattern.size() > provider->getActualSize())
+                return;
+
+            // The data might get modified while it's being searched. The hits are only valid if that didn't happen
+            const u64 generation = [&] {
+                std::scoped_lock lock(hitIndex.mutex);
+                return hitIndex.generation;
+            }();
+
+            std::vector<u64> hits;
+            std::vector<u8> buffer;
+            bool tooManyHits = false;
+            for (u64 address = dataStart; address + pattern.size() <= dataEnd && !tooManyHits; address += SearchBlockSize) {
+                task.update(address - dataStart);
+
+                buffer.resize(std::min<u64>(SearchBlockSize + pattern.size() - 1, dataEnd - address));
+                provider->read(address, buffer.data(), buffer.size());
+
+                // Occurrences starting in the overlap with the next block get found there
+                for (auto offset = pattern.find(buffer); offset.has_value() && *offset < SearchBlockSize; offset = pattern.find(buffer, *offset + 1)) {
+                    hits.push_back(address + *offset);
+
+                    // Remember that the sequence can't be indexed so the data doesn't get scanned again in the background for every search
+                    if (hits.size() > MaxHitCount) {
+                        hits.clear();
+                        tooManyHits = true;
+                        break;
+                    }
+                }
+            }
+
+            std::scoped_lock lock(hitIndex.mutex);
+            if (hitIndex.generation != generation)
+                return;
+
+            hitIndex.valid       = true;
+            hitIndex.provider    = provider;
+            hitIndex.sequence    = sequence;
+            hitIndex.tooManyHits = tooManyHits;
+            hitIndex.hits        = std::move(hits);
+        }
+
+        void dropHitIndex(prv::Provider *provider) {
+            if (this->m_indexedProvider == provider) {
+                this->m_indexTask.interrupt();
+                this->m_indexedProvider = nullptr;
+            }
 
-            prv::ProviderReader reader(provider);
+            std::scoped_lock lock(this->m_hitIndex->mutex);
+            this->m_hitIndex->generation++;
+            if (this->m_hitIndex->provider == provider) {
+                this->m_hitIndex->valid    = false;
+                this->m_hitIndex->provider = nullptr;
+            }
+        }
+
+        std::optional<Region> findSequence(Task &task, prv::Provider *provider, const std::vector<u8> &sequence, bool backwards) {
+            const BytePattern pattern(sequence);
+            const u64 dataStart = provider->getBaseAddress();
+            const u64 dataEnd   = dataStart + provider->getActualSize();
+            const u64 searchPosition = this->m_searchPosition.value_or(dataStart);
 
-            reader.seek(this->m_searchPosition.value_or(provider->getBaseAddress()));
+            if (pattern.empty() || pattern.size() > provider->getActualSize())
+                return std::nullopt;
+
+            // Look up the occurrence in the index if all occurrences of the sequence have been found already
+            {
+                std::scoped_lock lock(this->m_hitIndex->mutex);
+
+                const auto &hitIndex = *this->m_hitIndex;
+                if (hitIndex.valid && !hitIndex.tooManyHits && hitIndex.provider == provider && hitIndex.sequence == sequence) {
+                    if (!backwards) {
+                        if (auto hit = std::lower_bound(hitIndex.hits.begin(), hitIndex.hits.end(), searchPosition); hit != hitIndex.hits.end()) {
+                            this->m_nextSearchPosition = *hit + pattern.size();
+                            return Region { *hit, pattern.size() };
+                        }
+                    } else if (searchPosition + 1 >= dataStart + pattern.size()) {
+                        if (auto hit = std::upper_bound(hitIndex.hits.begin(), hitIndex.hits.end(), searchPosition + 1 - pattern.size()); hit != hitIndex.hits.begin()) {
+                            --hit;
+
+                            this->m_nextSearchPosition = *hit == 0x00 ? 0x00 : *hit - 1;
+                            return Region { *hit, pattern.size() };
+                        }
+                    }
 
-            constexpr static auto searchFunction = [](const auto &haystackBegin, const auto &haystackEnd, const auto &needleBegin, const auto &needleEnd) {
-                return std::search(haystackBegin, haystackEnd, std::boyer_moore_horspool_searcher(needleBegin, needleEnd));
-            };
+                    return std::nullopt;
+                }
+            }
 
+            // Search the data in blocks that overlap by the length of the sequence so occurrences crossing block boundaries are found too
+            std::vector<u8> buffer;
             if (!backwards) {
-                auto occurrence = searchFunction(reader.begin(), reader.end(), sequence.begin(), sequence.end());
-                if (occurrence != reader.end()) {
-                    this->m_nextSearchPosition = occurrence.getAddress() + sequence.size();
-                    return Region { occurrence.getAddress(), sequence.size() };
+                for (u64 address = searchPosition; address + pattern.size() <= dataEnd; address += SearchBlockSize) {
+                    task.update(address - searchPosition);
+
+                    buffer.resize(std::min<u64>(SearchBlockSize + pattern.size() - 1, dataEnd - address));
+                    provider->read(address, buffer.data(), buffer.size());
+
+                    if (auto offset = pattern.find(buffer); offset.has_value()) {
+                        const u64 occurrenceAddress = address + *offset;
+
+                        this->m_nextSearchPosition = occurrenceAddress + pattern.size();
+                        return Region { occurrenceAddress, pattern.size() };
+                    }
                 }
             } else {
-                auto occurrence = searchFunction(reader.rbegin(), reader.rend(), sequence.rbegin(), sequence.rend());
-                if (occurrence != reader.rend()) {
-                    if (occurrence.getAddress() < sequence.size())
-                        this->m_nextSearchPosition = 0x00;
-                    else
-                        this->m_nextSearchPosition = occurrence.getAddress() - sequence.size();
-
-                    return Region { occurrence.getAddress() - (sequence.size() - 1), sequence.size() };
+                u64 blockEnd = std::min(searchPosition + 1, dataEnd);
+                while (blockEnd >= dataStart + pattern.size()) {
+                    const u64 blockStart = blockEnd - std::min<u64>(SearchBlockSize + pattern.size() - 1, blockEnd - dataStart);
+
+                    task.update(searchPosition - blockStart);
+
+                    buffer.resize(blockEnd - blockStart);
+                    provider->read(blockStart, buffer.data(), buffer.size());
+
+                    if (auto offset = pattern.findLast(buffer); offset.has_value()) {
+                        const u64 occurrenceAddress = blockStart + *offset;
+
+                        if (occurrenceAddress == 0x00)
+                            this->m_nextSearchPosition = 0x00;
+                        else
+                            this->m_nextSearchPosition = occurrenceAddress - 1;
+
+                        return Region { occurrenceAddress, pattern.size() };
+                    }
+
+                    if (blockStart == dataStart)
+                        break;
+
+                    blockEnd = blockStart + pattern.size() - 1;
                 }
             }
 
@@ -329,7 +514,12 @@ namespace hex::plugin::builtin {
         std::atomic<bool> m_backwards    = false;
         std::atomic<bool> m_reachedEnd   = false;
 
-        TaskHolder m_searchTask;
+        TaskHolder m_searchTask, m_indexTask;
+        std::shared_ptr<HitIndex> m_hitIndex = std::make_shared<HitIndex>();
+
+        // Sequence the index task is currently searching for
+        prv::Provider *m_indexedProvider = nullptr;
+        std::vector<u8> m_indexedSequence;
     };
 
     class PopupBaseAddress : public ViewHexEditor::Popup {
@@ -470,15 +660,7 @@ namespace hex::plugin::builtin {
                     result = color;
             }
 
-            if (result.has_value())
-                return result;
-
-            for (const auto &[id, highlighting] : ImHexApi::HexEditor::impl::getForegroundHighlights()) {
-                if (highlighting.getRegion().overlaps({ address, size }))
-                    return highlighting.getColor();
-            }
-
-            return std::nullopt;
+            return result;
         });
 
         this->m_hexEditor.setBackgroundHighlightCallback([](u64 address, const u8 *data, size_t size) -> std::optional<color_t> {
@@ -488,15 +670,33 @@ namespace hex::plugin::builtin {
                     return color.value();
             }
 
-            if (result.has_value())
-                return result;
+            return result;
+        });
 
-            for (const auto &[id, highlighting] : ImHexApi::HexEditor::impl::getBackgroundHighlights()) {
-                if (highlighting.getRegion().overlaps({ address, size }))
-                    return highlighting.getColor();
+        this->m_hexEditor.setForegroundHighlightRegionCallback([](const Region &region) {
+            std::vector<ImHexApi::HexEditor::Highlighting> result;
+            for (const auto &[id, callback] : ImHexApi::HexEditor::impl::getForegroundHighlightingRegionFunctions()) {
+                auto highlights = callback(region);
+                std::move(highlights.begin(), highlights.end(), std::back_inserter(result));
             }
 
-            return std::nullopt;
+            auto highlights = ImHexApi::HexEditor::impl::findForegroundHighlights(region);
+            std::move(highlights.begin(), highlights.end(), std::back_inserter(result));
+
+            return result;
+        });
+
+        this->m_hexEditor.setBackgroundHighlightRegionCallback([](const Region &region) {
+            std::vector<ImHexApi::HexEditor::Highlighting> result;
+            for (const auto &[id, callback] : ImHexApi::HexEditor::impl::getBackgroundHighlightingRegionFunctions()) {
+                auto highlights = callback(region);
+                std::move(highlights.begin(), highlights.end(), std::back_inserter(result));
+            }
+
+            auto highlights = ImHexApi::HexEditor::impl::findBackgroundHighlights(region);
+            std::move(highlights.begin(), highlights.end(), std::back_inserter(result));
+
+            return result;
         });
 
         this->m_hexEditor.setTooltipCallback([](u64 address, const u8 *data, size_t size) {
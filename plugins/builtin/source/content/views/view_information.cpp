@@ -1,6 +1,7 @@
 #include "content/views/view_information.hpp"
 
 #include <hex/api/content_registry.hpp>
+#include <hex/api/project_file_manager.hpp>
 
 #include <hex/providers/provider.hpp>
 #include <hex/providers/buffered_reader.hpp>
@@ -8,40 +9,86 @@
 #include <hex/helpers/fs.hpp>
 #include <hex/helpers/magic.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <cmath>
 #include <filesystem>
 #include <span>
 
+#include <nlohmann/json.hpp>
+
 #include <implot.h>
 
 namespace hex::plugin::builtin {
 
     using namespace hex::literals;
 
+    // Size of the blocks the byte value counts are kept for. Modifying the data requires all blocks touched by the modification to be analyzed again
+    constexpr static u64 SummaryBlockSize = 0x1'0000;
+
+    // Amount of data at the start of the provider the magic database looks at
+    constexpr static u64 MagicDataSize = 100_KiB;
+
+    // Number of separate modified regions remembered per provider before they get combined into a single one
+    constexpr static size_t MaxModifiedRegionCount = 0x100;
+
+    namespace {
+
+        /**
+         * @brief Adds a region to a sorted list of disjoint regions, merging it with all regions it overlaps or touches
+         * Once the list gets too long, it's replaced by a single region covering all of them. That causes more data to be
+         * analyzed again but keeps the list from growing without bound while the data keeps getting modified
+         */
+        void addModifiedRegion(std::vector<Region> &regions, Region region) {
+            u64 startAddress = region.getStartAddress();
+            u64 endAddress   = region.getEndAddress();
+
+            auto first = std::lower_bound(regions.begin(), regions.end(), startAddress, [](const Region &other, u64 address) {
+                return other.getEndAddress() + 1 < address;
+            });
+
+            auto last = first;
+            for (; last != regions.end() && last->getStartAddress() <= endAddress + 1; ++last) {
+                startAddress = std::min(startAddress, last->getStartAddress());
+                endAddress   = std::max(endAddress, last->getEndAddress());
+            }
+
+            regions.insert(regions.erase(first, last), Region { startAddress, endAddress - startAddress + 1 });
+
+            if (regions.size() > MaxModifiedRegionCount) {
+                startAddress = regions.front().getStartAddress();
+                endAddress   = regions.back().getEndAddress();
+
+                regions = { Region { startAddress, endAddress - startAddress + 1 } };
+            }
+        }
+
+    }
+
     ViewInformation::ViewInformation() : View("hex.builtin.view.information.name") {
-        EventManager::subscribe<EventDataChanged>(this, [this]() {
-            this->m_dataValid = false;
-            this->m_plainTextCharacterPercentage = -1.0;
-            this->m_averageEntropy = -1.0;
-            this->m_highestBlockEntropy = -1.0;
-            this->m_blockSize = 0;
-            this->m_dataMimeType.clear();
-            this->m_dataDescription.clear();
-            this->m_analyzedRegion = { 0, 0 };
+        EventManager::subscribe<EventProviderDataModified>(this, [this](prv::Provider *provider, Region region) {
+            // Providers may be modified from any thread, only remember the modification here and analyze it the next frame
+            std::scoped_lock lock(this->m_analysisMutex);
+
+            if (region.getSize() > 0 && this->m_analyses.contains(provider))
+                addModifiedRegion(this->m_modifiedRegions[provider], region);
         });
 
-        EventManager::subscribe<EventRegionSelected>(this, [this](Region region) {
+        EventManager::subscribe<EventRegionSelected>(this, [this](const ImHexApi::HexEditor::ProviderRegion &region) {
             // Set the position of the diagram relative to the place where 
             // the user clicked inside the hex editor view 
-            if (this->m_blockSize != 0) {
-                this->m_byteTypesDistribution.setHandlePosition(region.getStartAddress());
-                this->m_chunkBasedEntropy.setHandlePosition(region.getStartAddress());
+            if (auto analysis = this->getAnalysis(region.getProvider()); analysis != nullptr && analysis->dataValid) {
+                analysis->byteTypesDistribution.setHandlePosition(region.getStartAddress());
+                analysis->chunkBasedEntropy.setHandlePosition(region.getStartAddress());
             } 
         });
 
-        EventManager::subscribe<EventProviderDeleted>(this, [this](const auto*) {
-            this->m_dataValid = false;
+        EventManager::subscribe<EventProviderDeleted>(this, [this](const prv::Provider *provider) {
+            std::scoped_lock lock(this->m_analysisMutex);
+
+            this->m_analyses.erase(provider);
+            this->m_modifiedRegions.erase(provider);
         });
 
         ContentRegistry::FileHandler::add({ ".mgc" }, [](const auto &path) {
@@ -54,89 +101,362 @@ namespace hex::plugin::builtin {
 
             return false;
         });
+
+        ProjectFile::registerPerProviderHandler({
+            .basePath = "information",
+            .required = false,
+            .load = [this](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) -> bool {
+                auto analysis = loadAnalysis(provider, basePath, tar);
+
+                std::scoped_lock lock(this->m_analysisMutex);
+                if (analysis != nullptr)
+                    this->m_analyses[provider] = std::move(analysis);
+                else
+                    this->m_analyses.erase(provider);
+                this->m_modifiedRegions.erase(provider);
+
+                return true;
+            },
+            .store = [this](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) -> bool {
+                // Only store results that match the current data
+                if (this->m_analyzerTask.isRunning())
+                    return true;
+
+                std::shared_ptr<Analysis> analysis;
+                {
+                    std::scoped_lock lock(this->m_analysisMutex);
+                    if (this->m_modifiedRegions.contains(provider))
+                        return true;
+                    if (auto it = this->m_analyses.find(provider); it != this->m_analyses.end())
+                        analysis = it->second;
+                }
+
+                if (analysis == nullptr || !analysis->dataValid)
+                    return true;
+
+                return storeAnalysis(*analysis, basePath, tar);
+            }
+        });
     }
 
     ViewInformation::~ViewInformation() {
-        EventManager::unsubscribe<EventDataChanged>(this);
+        EventManager::unsubscribe<EventProviderDataModified>(this);
         EventManager::unsubscribe<EventRegionSelected>(this);
         EventManager::unsubscribe<EventProviderDeleted>(this);
     }
 
-    void ViewInformation::analyze() {
-        this->m_analyzerTask = TaskManager::createTask("hex.builtin.view.information.analyzing", 0, [this](auto &task) {
-            auto provider = ImHexApi::Provider::get();
-
-            if ((this->m_inputChunkSize <= 0)
-             || (this->m_inputStartAddress >= this->m_inputEndAddress)
-             || ((size_t) this->m_inputEndAddress > provider->getActualSize())) {
-                // Invalid parameters, set default one
-                this->m_inputChunkSize    = 256;
-                this->m_inputStartAddress = 0;
-                this->m_inputEndAddress   = provider->getActualSize();
+    std::shared_ptr<ViewInformation::Analysis> ViewInformation::getAnalysis(const prv::Provider *provider) {
+        std::scoped_lock lock(this->m_analysisMutex);
+
+        if (auto it = this->m_analyses.find(provider); it != this->m_analyses.end())
+            return it->second;
+        else
+            return nullptr;
+    }
+
+    void ViewInformation::resetAnalysis(Analysis &analysis, prv::Provider *provider, Region region, u64 chunkSize) {
+        const u64 startOffset = region.getStartAddress() - provider->getBaseAddress();
+        const u64 endOffset   = startOffset + region.getSize();
+
+        analysis.dataValid      = false;
+        analysis.chunksAnalyzed = false;
+        analysis.analyzedRegion = region;
+        analysis.chunkSize      = chunkSize;
+        analysis.dataSize       = provider->getActualSize();
+
+        analysis.blockValueCounts = BlockValueCounts(region, std::max<u64>(SummaryBlockSize / chunkSize, 1) * chunkSize);
+
+        analysis.byteDistribution.reset();
+        analysis.byteTypesDistribution.reset(chunkSize, startOffset, endOffset, provider->getBaseAddress(), provider->getActualSize());
+        analysis.chunkBasedEntropy.reset(chunkSize, startOffset, endOffset, provider->getBaseAddress(), provider->getActualSize());
+    }
+
+    void ViewInformation::analyzeBlocks(Task &task, Analysis &analysis, prv::Provider *provider, Region region) {
+        const auto analyzedRegion = analysis.analyzedRegion;
+        const auto chunkSize      = analysis.chunkSize;
+
+        // Count the byte values of every chunk of every summary block in parallel.
+        // All diagrams are then calculated from those counts instead of looking at every byte separately
+        std::mutex distributionMutex;
+        task.parallelFor(region, analysis.blockValueCounts.getBlockSize(), [&](Task &, Region block) {
+            std::vector<u8> buffer(block.getSize());
+            provider->read(block.getStartAddress(), buffer.data(), buffer.size());
+
+            BlockValueCounts::Counts blockValueCounts = { };
+            for (u64 offset = 0; offset < buffer.size(); offset += chunkSize) {
+                const auto size = std::min<u64>(chunkSize, buffer.size() - offset);
+                const auto chunkIndex = (block.getStartAddress() + offset - analyzedRegion.getStartAddress()) / chunkSize;
+
+                std::array<ImU64, 256> chunkValueCounts = { };
+                countByteValues({ buffer.data() + offset, size }, chunkValueCounts);
+
+                analysis.chunkBasedEntropy.update(chunkIndex, chunkValueCounts, size);
+                analysis.byteTypesDistribution.update(chunkIndex, chunkValueCounts, size);
+
+                for (u32 value = 0; value < chunkValueCounts.size(); value++)
+                    blockValueCounts[value] += chunkValueCounts[value];
             }
 
-            task.setMaxValue(this->m_inputEndAddress - this->m_inputStartAddress);
+            // Replace the previous counts of this block in the counts of the whole region
+            std::scoped_lock lock(distributionMutex);
+            analysis.blockValueCounts.setBlock(block.getStartAddress(), blockValueCounts);
+        });
+
+        const auto &totals = analysis.blockValueCounts.getTotals();
+        std::copy(totals.begin(), totals.end(), analysis.byteDistribution.get().begin());
+    }
+
+    void ViewInformation::updateResults(Analysis &analysis) {
+        analysis.chunkBasedEntropy.finish();
+        analysis.byteTypesDistribution.finish();
 
-            // Modify the analyzed region  
-            this->m_analyzedRegion = { 
-                provider->getBaseAddress() + this->m_inputStartAddress, 
-                size_t(this->m_inputEndAddress - this->m_inputStartAddress)
-            };
+        analysis.averageEntropy = analysis.chunkBasedEntropy.calculateEntropy(analysis.byteDistribution.get(), analysis.analyzedRegion.getSize());
+        analysis.highestBlockEntropy = analysis.chunkBasedEntropy.getHighestEntropyBlockValue();
+        analysis.highestBlockEntropyAddress = analysis.chunkBasedEntropy.getHighestEntropyBlockAddress();
+        analysis.lowestBlockEntropy = analysis.chunkBasedEntropy.getLowestEntropyBlockValue();
+        analysis.lowestBlockEntropyAddress = analysis.chunkBasedEntropy.getLowestEntropyBlockAddress();
+        analysis.plainTextCharacterPercentage = analysis.byteTypesDistribution.getPlainTextCharacterPercentage();
 
+        analysis.dataValid = true;
+    }
+
+    void ViewInformation::analyze(prv::Provider *provider, Region region, u64 chunkSize) {
+        auto analysis = std::make_shared<Analysis>();
+        {
+            std::scoped_lock lock(this->m_analysisMutex);
+            this->m_analyses[provider] = analysis;
+            this->m_modifiedRegions.erase(provider);
+        }
+
+        this->m_analyzerTask = TaskManager::createTask("hex.builtin.view.information.analyzing", region.getSize(), [analysis, provider, region, chunkSize](auto &task) {
             {
                 magic::compile();
 
-                this->m_dataDescription = magic::getDescription(provider);
-                this->m_dataMimeType    = magic::getMIMEType(provider);
+                analysis->dataDescription = magic::getDescription(provider);
+                analysis->dataMimeType    = magic::getMIMEType(provider);
             }
 
-            {
-                this->m_blockSize = std::max<u32>(std::ceil(provider->getActualSize() / 2048.0F), 256);
-
-                this->m_averageEntropy = -1.0;
-                this->m_highestBlockEntropy = -1.0;
-                this->m_plainTextCharacterPercentage = -1.0;
-
-                // Setup / start each analysis
-
-                this->m_byteDistribution.reset();
-                this->m_digram.reset(this->m_inputEndAddress - this->m_inputStartAddress);
-                this->m_layeredDistribution.reset(this->m_inputEndAddress - this->m_inputStartAddress);
-                this->m_byteTypesDistribution.reset(this->m_inputStartAddress, this->m_inputEndAddress, 
-                    provider->getBaseAddress(), provider->getActualSize());
-                this->m_chunkBasedEntropy.reset(this->m_inputChunkSize, this->m_inputStartAddress, this->m_inputEndAddress,
-                    provider->getBaseAddress(), provider->getActualSize());
-
-                // Create a handle to the file
-                auto reader = prv::ProviderReader(provider);
-                reader.seek(provider->getBaseAddress() + this->m_inputStartAddress);
-                reader.setEndAddress(provider->getBaseAddress() + this->m_inputEndAddress);
-
-                u64 count = 0;
-
-                // Loop over each byte of the [part of the] file and update each analysis 
-                // one byte at the time in order to process the file only once
-                for (u8 byte : reader) {
-                    this->m_byteDistribution.update(byte);
-                    this->m_byteTypesDistribution.update(byte);
-                    this->m_chunkBasedEntropy.update(byte);
-                    this->m_layeredDistribution.update(byte);
-                    this->m_digram.update(byte);
-                    ++count;
-                    task.update(count);
-                }
+            resetAnalysis(*analysis, provider, region, chunkSize);
+
+            // The digram and the layered distribution only ever display a small sample of the data
+            analysis->digram.process(provider, region.getStartAddress(), region.getSize());
+            analysis->layeredDistribution.process(provider, region.getStartAddress(), region.getSize());
+
+            analyzeBlocks(task, *analysis, provider, region);
+
+            analysis->chunksAnalyzed = true;
+            updateResults(*analysis);
+        });
+    }
+
+    void ViewInformation::analyzeModifications(prv::Provider *provider) {
+        auto analysis = this->getAnalysis(provider);
+        if (analysis == nullptr || !analysis->dataValid)
+            return;
+
+        std::vector<Region> modifiedRegions;
+        {
+            std::scoped_lock lock(this->m_analysisMutex);
+
+            auto it = this->m_modifiedRegions.find(provider);
+            if (it == this->m_modifiedRegions.end())
+                return;
 
-                this->m_averageEntropy = this->m_chunkBasedEntropy.calculateEntropy(this->m_byteDistribution.get(), this->m_inputEndAddress - this->m_inputStartAddress);
-                this->m_highestBlockEntropy = this->m_chunkBasedEntropy.getHighestEntropyBlockValue();
-                this->m_highestBlockEntropyAddress = this->m_chunkBasedEntropy.getHighestEntropyBlockAddress();
-                this->m_lowestBlockEntropy = this->m_chunkBasedEntropy.getLowestEntropyBlockValue();
-                this->m_lowestBlockEntropyAddress = this->m_chunkBasedEntropy.getLowestEntropyBlockAddress();
-                this->m_plainTextCharacterPercentage = this->m_byteTypesDistribution.getPlainTextCharacterPercentage();
+            modifiedRegions = std::move(it->second);
+            this->m_modifiedRegions.erase(it);
+        }
+
+        const auto analyzedRegion = analysis->analyzedRegion;
+
+        // Data moved around when the size changed so the previous results can't be corrected block by block anymore.
+        // Analyze whatever is left of the previously analyzed region again instead
+        if (provider->getActualSize() != analysis->dataSize) {
+            const u64 endAddress = std::min<u64>(analyzedRegion.getEndAddress() + 1, provider->getBaseAddress() + provider->getActualSize());
+
+            if (endAddress > analyzedRegion.getStartAddress()) {
+                this->analyze(provider, { analyzedRegion.getStartAddress(), endAddress - analyzedRegion.getStartAddress() }, analysis->chunkSize);
+            } else {
+                std::scoped_lock lock(this->m_analysisMutex);
+                this->m_analyses.erase(provider);
             }
-                
-            this->m_dataValid = true;
+
+            return;
+        }
+
+        // The modified regions are sorted by address so only the first one can overlap the data the magic database looks at
+        const bool magicDataModified = !modifiedRegions.empty() && modifiedRegions.front().getStartAddress() < provider->getBaseAddress() + MagicDataSize;
+
+        auto modifiedBlocks = analysis->blockValueCounts.getModifiedBlocks(modifiedRegions);
+
+        // The plots can only be corrected block by block once the values of all chunks are known again
+        if (!modifiedBlocks.empty() && !analysis->chunksAnalyzed)
+            modifiedBlocks = { analyzedRegion };
+
+        u64 modifiedSize = 0;
+        for (const auto &blocks : modifiedBlocks)
+            modifiedSize += blocks.getSize();
+
+        if (modifiedBlocks.empty() && !magicDataModified)
+            return;
+
+        this->m_analyzerTask = TaskManager::createTask("hex.builtin.view.information.analyzing", modifiedSize, [analysis, provider, modifiedBlocks, magicDataModified](auto &task) {
+            if (magicDataModified) {
+                analysis->dataDescription = magic::getDescription(provider);
+                analysis->dataMimeType    = magic::getMIMEType(provider);
+            }
+
+            if (!modifiedBlocks.empty()) {
+                for (const auto &blocks : modifiedBlocks)
+                    analyzeBlocks(task, *analysis, provider, blocks);
+
+                analysis->chunksAnalyzed = true;
+            }
+
+            if (analysis->chunksAnalyzed)
+                updateResults(*analysis);
         });
-    }        
+    }
+
+    namespace {
+
+        template<typename T>
+        void appendBytes(std::vector<u8> &buffer, std::span<const T> values) {
+            const auto bytes = std::as_bytes(values);
+            buffer.insert(buffer.end(), reinterpret_cast<const u8 *>(bytes.data()), reinterpret_cast<const u8 *>(bytes.data() + bytes.size()));
+        }
+
+        template<typename T>
+        bool extractBytes(std::span<const u8> &buffer, std::span<T> values) {
+            const auto bytes = std::as_writable_bytes(values);
+            if (buffer.size() < bytes.size())
+                return false;
+
+            std::memcpy(bytes.data(), buffer.data(), bytes.size());
+            buffer = buffer.subspan(bytes.size());
+
+            return true;
+        }
+
+        // Plotted values are stored with a precision of 1/255 of their range, which is more than what ends up being visible on screen
+        template<typename T>
+        void appendQuantized(std::vector<u8> &buffer, std::span<const T> values, T maxValue) {
+            for (auto value : values)
+                buffer.push_back(u8(std::lround(std::clamp<T>(value / maxValue, 0, 1) * 0xFF)));
+        }
+
+        template<typename T>
+        std::vector<T> extractQuantized(std::span<const u8> values, T maxValue) {
+            std::vector<T> result;
+            result.reserve(values.size());
+            for (auto value : values)
+                result.push_back(value * maxValue / 0xFF);
+
+            return result;
+        }
+
+    }
+
+    bool ViewInformation::storeAnalysis(const Analysis &analysis, const std::fs::path &basePath, Tar &tar) {
+        nlohmann::json data;
+        data["address"]     = analysis.analyzedRegion.getStartAddress();
+        data["size"]        = analysis.analyzedRegion.getSize();
+        data["chunkSize"]   = analysis.chunkSize;
+        data["dataSize"]    = analysis.dataSize;
+        data["description"] = analysis.dataDescription;
+        data["mimeType"]    = analysis.dataMimeType;
+
+        data["highestBlockEntropy"]          = analysis.highestBlockEntropy;
+        data["highestBlockEntropyAddress"]   = analysis.highestBlockEntropyAddress;
+        data["lowestBlockEntropy"]           = analysis.lowestBlockEntropy;
+        data["lowestBlockEntropyAddress"]    = analysis.lowestBlockEntropyAddress;
+        data["plainTextCharacterPercentage"] = analysis.plainTextCharacterPercentage;
+
+        // The byte value counts of the summary blocks are needed to analyze modifications block by block after loading.
+        // The results of the single chunks are not stored, only the small samples of them shown in the plots
+        std::vector<u8> blockValueCounts;
+        appendBytes<BlockValueCounts::BlockCounts>(blockValueCounts, analysis.blockValueCounts.getBlocks());
+
+        std::vector<u8> plots;
+        appendQuantized<double>(plots, analysis.chunkBasedEntropy.getSampledEntropies(), 1.0);
+        for (const auto &typeDistribution : analysis.byteTypesDistribution.getSampledTypeDistributions())
+            appendQuantized<float>(plots, typeDistribution, 100.0F);
+
+        tar.writeString(basePath / "analysis.json", data.dump(4));
+        tar.writeVector(basePath / "block_value_counts.bin", blockValueCounts);
+        tar.writeVector(basePath / "plots.bin", plots);
+
+        return true;
+    }
+
+    std::shared_ptr<ViewInformation::Analysis> ViewInformation::loadAnalysis(prv::Provider *provider, const std::fs::path &basePath, Tar &tar) {
+        if (!tar.contains(basePath / "analysis.json") || !tar.contains(basePath / "block_value_counts.bin") || !tar.contains(basePath / "plots.bin"))
+            return nullptr;
+
+        auto fileContent = tar.readString(basePath / "analysis.json");
+        auto data = nlohmann::json::parse(fileContent.begin(), fileContent.end());
+
+        // The data got modified outside of ImHex, the stored results are worthless then
+        if (data["dataSize"].get<size_t>() != provider->getActualSize())
+            return nullptr;
+
+        const Region region  = { data["address"].get<u64>(), data["size"].get<size_t>() };
+        const auto chunkSize = data["chunkSize"].get<u64>();
+        if (chunkSize == 0 || region.getSize() == 0)
+            return nullptr;
+
+        auto analysis = std::make_shared<Analysis>();
+        resetAnalysis(*analysis, provider, region, chunkSize);
+
+        analysis->dataDescription = data["description"].get<std::string>();
+        analysis->dataMimeType    = data["mimeType"].get<std::string>();
+
+        analysis->highestBlockEntropy          = data["highestBlockEntropy"].get<double>();
+        analysis->highestBlockEntropyAddress   = data["highestBlockEntropyAddress"].get<u64>();
+        analysis->lowestBlockEntropy           = data["lowestBlockEntropy"].get<double>();
+        analysis->lowestBlockEntropyAddress    = data["lowestBlockEntropyAddress"].get<u64>();
+        analysis->plainTextCharacterPercentage = data["plainTextCharacterPercentage"].get<double>();
+
+        {
+            const auto storedCounts = tar.readVector(basePath / "block_value_counts.bin");
+            std::span<const u8> remainingCounts = storedCounts;
+
+            std::vector<BlockValueCounts::BlockCounts> blockValueCounts(analysis->blockValueCounts.getBlocks().size());
+            if (!extractBytes<BlockValueCounts::BlockCounts>(remainingCounts, blockValueCounts) || !remainingCounts.empty())
+                return nullptr;
+
+            analysis->blockValueCounts.setBlocks(std::move(blockValueCounts));
+        }
+
+        {
+            // The entropy and all 12 byte types are plotted with the same number of samples
+            const auto plots = tar.readVector(basePath / "plots.bin");
+            const size_t sampleCount = plots.size() / 13;
+            if (sampleCount == 0 || plots.size() != sampleCount * 13)
+                return nullptr;
+
+            std::span<const u8> remainingPlots = plots;
+            analysis->chunkBasedEntropy.setSampledEntropies(extractQuantized<double>(remainingPlots.first(sampleCount), 1.0));
+            remainingPlots = remainingPlots.subspan(sampleCount);
+
+            std::array<std::vector<float>, 12> typeDistributions;
+            for (auto &typeDistribution : typeDistributions) {
+                typeDistribution = extractQuantized<float>(remainingPlots.first(sampleCount), 100.0F);
+                remainingPlots = remainingPlots.subspan(sampleCount);
+            }
+            analysis->byteTypesDistribution.setSampledTypeDistributions(std::move(typeDistributions));
+        }
+
+        const auto &totals = analysis->blockValueCounts.getTotals();
+        std::copy(totals.begin(), totals.end(), analysis->byteDistribution.get().begin());
+        analysis->averageEntropy = analysis->chunkBasedEntropy.calculateEntropy(analysis->byteDistribution.get(), region.getSize());
+
+        analysis->digram.process(provider, region.getStartAddress(), region.getSize());
+        analysis->layeredDistribution.process(provider, region.getStartAddress(), region.getSize());
+
+        analysis->dataValid = true;
+
+        return analysis;
+    }
 
     void ViewInformation::drawContent() {
         if (ImGui::Begin(View::toWindowName("hex.builtin.view.information.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
@@ -157,18 +477,37 @@ namespace hex::plugin::builtin {
 
                         ImGui::InputInt("hex.builtin.view.information.block_size"_lang, &this->m_inputChunkSize, ImGuiInputTextFlags_CharsDecimal);
 
-                        if (ImGui::Button("hex.builtin.view.information.analyze"_lang, ImVec2(ImGui::GetContentRegionAvail().x, 0)))
-                            this->analyze();
+                        if (ImGui::Button("hex.builtin.view.information.analyze"_lang, ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+                            if ((this->m_inputChunkSize <= 0)
+                             || (this->m_inputStartAddress >= this->m_inputEndAddress)
+                             || ((size_t) this->m_inputEndAddress > provider->getActualSize())) {
+                                // Invalid parameters, set default one
+                                this->m_inputChunkSize    = 256;
+                                this->m_inputStartAddress = 0;
+                                this->m_inputEndAddress   = provider->getActualSize();
+                            }
+
+                            this->analyze(provider, {
+                                provider->getBaseAddress() + this->m_inputStartAddress,
+                                size_t(this->m_inputEndAddress - this->m_inputStartAddress)
+                            }, this->m_inputChunkSize);
+                        }
                     }
                     ImGui::EndDisabled();
 
+                    // Only analyze the parts of the data that changed since the last analysis
+                    if (!this->m_analyzerTask.isRunning())
+                        this->analyzeModifications(provider);
+
+                    auto analysis = this->getAnalysis(provider);
+
                     if (this->m_analyzerTask.isRunning()) {
                         ImGui::TextSpinner("hex.builtin.view.information.analyzing"_lang);
                     } else {
                         ImGui::NewLine();
                     }
 
-                    if (!this->m_analyzerTask.isRunning() && this->m_dataValid) {
+                    if (!this->m_analyzerTask.isRunning() && analysis != nullptr && analysis->dataValid) {
 
                         // Provider information
                         ImGui::Header("hex.builtin.view.information.provider_information"_lang, true);
@@ -189,13 +528,13 @@ namespace hex::plugin::builtin {
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.region"_lang);
                             ImGui::TableNextColumn();
-                            ImGui::TextFormatted("0x{:X} - 0x{:X}", this->m_analyzedRegion.getStartAddress(), this->m_analyzedRegion.getEndAddress());
+                            ImGui::TextFormatted("0x{:X} - 0x{:X}", analysis->analyzedRegion.getStartAddress(), analysis->analyzedRegion.getEndAddress());
 
                             ImGui::EndTable();
                         }
 
                         // Magic information
-                        if (!(this->m_dataDescription.empty() && this->m_dataMimeType.empty())) {
+                        if (!(analysis->dataDescription.empty() && analysis->dataMimeType.empty())) {
                             ImGui::Header("hex.builtin.view.information.magic"_lang);
 
                             if (ImGui::BeginTable("magic", 2, ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg)) {
@@ -204,18 +543,18 @@ namespace hex::plugin::builtin {
 
                                 ImGui::TableNextRow();
 
-                                if (!this->m_dataDescription.empty()) {
+                                if (!analysis->dataDescription.empty()) {
                                     ImGui::TableNextColumn();
                                     ImGui::TextUnformatted("hex.builtin.view.information.description"_lang);
                                     ImGui::TableNextColumn();
-                                    ImGui::TextFormattedWrapped("{}", this->m_dataDescription.c_str());
+                                    ImGui::TextFormattedWrapped("{}", analysis->dataDescription.c_str());
                                 }
 
-                                if (!this->m_dataMimeType.empty()) {
+                                if (!analysis->dataMimeType.empty()) {
                                     ImGui::TableNextColumn();
                                     ImGui::TextUnformatted("hex.builtin.view.information.mime"_lang);
                                     ImGui::TableNextColumn();
-                                    ImGui::TextFormattedWrapped("{}", this->m_dataMimeType.c_str());
+                                    ImGui::TextFormattedWrapped("{}", analysis->dataMimeType.c_str());
                                 }
 
                                 ImGui::EndTable();
@@ -232,14 +571,14 @@ namespace hex::plugin::builtin {
 
                             // Display byte distribution analysis
                             ImGui::TextUnformatted("hex.builtin.view.information.distribution"_lang);
-                            this->m_byteDistribution.draw(
+                            analysis->byteDistribution.draw(
                                 ImVec2(-1, 0), 
                                 ImPlotFlags_NoChild | ImPlotFlags_NoLegend | ImPlotFlags_NoMenus | ImPlotFlags_NoBoxSelect
                             );
 
                             // Display byte types distribution analysis
                             ImGui::TextUnformatted("hex.builtin.view.information.byte_types"_lang);
-                            this->m_byteTypesDistribution.draw(
+                            analysis->byteTypesDistribution.draw(
                                     ImVec2(-1, 0), 
                                     ImPlotFlags_NoChild | ImPlotFlags_NoMenus | ImPlotFlags_NoBoxSelect | ImPlotFlags_AntiAliased,
                                     true
@@ -247,7 +586,7 @@ namespace hex::plugin::builtin {
 
                             // Display chunk based entropy analysis
                             ImGui::TextUnformatted("hex.builtin.view.information.entropy"_lang);
-                            this->m_chunkBasedEntropy.draw(
+                            analysis->chunkBasedEntropy.draw(
                                 ImVec2(-1, 0), 
                                 ImPlotFlags_NoChild | ImPlotFlags_CanvasOnly | ImPlotFlags_AntiAliased,
                                 true
@@ -269,29 +608,29 @@ namespace hex::plugin::builtin {
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.block_size"_lang);
                             ImGui::TableNextColumn();
-                            ImGui::TextFormatted("hex.builtin.view.information.block_size.desc"_lang, this->m_chunkBasedEntropy.getSize(), this->m_chunkBasedEntropy.getChunkSize());
+                            ImGui::TextFormatted("hex.builtin.view.information.block_size.desc"_lang, analysis->chunkBasedEntropy.getSize(), analysis->chunkBasedEntropy.getChunkSize());
 
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.file_entropy"_lang);
                             ImGui::TableNextColumn();
-                            if (this->m_averageEntropy < 0) ImGui::TextUnformatted("???");
-                            else ImGui::TextFormatted("{:.5f}", this->m_averageEntropy);
+                            if (analysis->averageEntropy < 0) ImGui::TextUnformatted("???");
+                            else ImGui::TextFormatted("{:.5f}", analysis->averageEntropy);
 
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.highest_entropy"_lang);
                             ImGui::TableNextColumn();
-                            ImGui::TextFormatted("{:.5f} @ 0x{:02X}", this->m_highestBlockEntropy, this->m_highestBlockEntropyAddress);
+                            ImGui::TextFormatted("{:.5f} @ 0x{:02X}", analysis->highestBlockEntropy, analysis->highestBlockEntropyAddress);
 
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.lowest_entropy"_lang);
                             ImGui::TableNextColumn();
-                            ImGui::TextFormatted("{:.5f} @ 0x{:02X}", this->m_lowestBlockEntropy, this->m_lowestBlockEntropyAddress);
+                            ImGui::TextFormatted("{:.5f} @ 0x{:02X}", analysis->lowestBlockEntropy, analysis->lowestBlockEntropyAddress);
 
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.plain_text_percentage"_lang);
                             ImGui::TableNextColumn();
-                            if (this->m_plainTextCharacterPercentage < 0) ImGui::TextUnformatted("???");
-                            else ImGui::TextFormatted("{:.2f}%", this->m_plainTextCharacterPercentage);
+                            if (analysis->plainTextCharacterPercentage < 0) ImGui::TextUnformatted("???");
+                            else ImGui::TextFormatted("{:.2f}%", analysis->plainTextCharacterPercentage);
 
                             ImGui::EndTable();
                         }
@@ -303,12 +642,12 @@ namespace hex::plugin::builtin {
                             ImGui::TableSetupColumn("value", ImGuiTableColumnFlags_WidthStretch);
                             ImGui::TableNextRow();
 
-                            if (this->m_averageEntropy > 0.83 && this->m_highestBlockEntropy > 0.9) {
+                            if (analysis->averageEntropy > 0.83 && analysis->highestBlockEntropy > 0.9) {
                                 ImGui::TableNextColumn();
                                 ImGui::TextFormattedColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "{}", "hex.builtin.view.information.encrypted"_lang);
                             }
 
-                            if (this->m_plainTextCharacterPercentage > 95) {
+                            if (analysis->plainTextCharacterPercentage > 95) {
                                 ImGui::TableNextColumn();
                                 ImGui::TextFormattedColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "{}", "hex.builtin.view.information.plain_text"_lang);
                             }
@@ -319,7 +658,7 @@ namespace hex::plugin::builtin {
                         ImGui::BeginGroup();
                         {
                             ImGui::TextUnformatted("hex.builtin.view.information.digram"_lang);
-                            this->m_digram.draw(scaled(ImVec2(300, 300)));
+                            analysis->digram.draw(scaled(ImVec2(300, 300)));
                         }
                         ImGui::EndGroup();
 
@@ -328,7 +667,7 @@ namespace hex::plugin::builtin {
                         ImGui::BeginGroup();
                         {
                             ImGui::TextUnformatted("hex.builtin.view.information.layered_distribution"_lang);
-                            this->m_layeredDistribution.draw(scaled(ImVec2(300, 300)));
+                            analysis->layeredDistribution.draw(scaled(ImVec2(300, 300)));
                         }
                         ImGui::EndGroup();
                     }
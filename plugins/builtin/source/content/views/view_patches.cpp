@@ -3,14 +3,34 @@
 #include <hex/providers/provider.hpp>
 
 #include <hex/api/project_file_manager.hpp>
+#include <hex/helpers/fmt.hpp>
 #include <nlohmann/json.hpp>
 
+#include <iterator>
 #include <string>
+#include <vector>
 
 using namespace std::literals::string_literals;
 
 namespace hex::plugin::builtin {
 
+    namespace {
+
+        constexpr static auto MaxPreviewBytes = 8;
+
+        std::string formatPreviewBytes(const std::vector<u8> &bytes, size_t totalSize) {
+            std::string result;
+            for (const auto byte : bytes)
+                result += hex::format("{:02X} ", byte);
+
+            if (totalSize > bytes.size())
+                result += "...";
+
+            return result;
+        }
+
+    }
+
     ViewPatches::ViewPatches() : View("hex.builtin.view.patches.name") {
 
         ProjectFile::registerPerProviderHandler({
@@ -18,12 +38,29 @@ namespace hex::plugin::builtin {
             .required = false,
             .load = [](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) {
                 auto json = nlohmann::json::parse(tar.readString(basePath));
-                provider->getPatches() = json["patches"].get<std::map<u64, u8>>();
+
+                auto &patches = provider->getPatches();
+                patches.clear();
+                for (const auto &patch : json["patches"]) {
+                    const u64 address = patch[0];
+
+                    // Older projects stored every patched byte as its own [ address, value ] pair
+                    if (patch[1].is_array()) {
+                        const auto bytes = patch[1].get<std::vector<u8>>();
+                        patches.set(address, bytes.data(), bytes.size());
+                    } else {
+                        patches.set(address, patch[1].get<u8>());
+                    }
+                }
+
                 return true;
             },
             .store = [](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) {
                 nlohmann::json json;
-                json["patches"] = provider->getPatches();
+                json["patches"] = nlohmann::json::array();
+                for (const auto &[address, bytes] : provider->getPatches())
+                    json["patches"].push_back({ address, bytes });
+
                 tar.writeString(basePath, json.dump(4));
 
                 return true;
@@ -38,11 +75,14 @@ namespace hex::plugin::builtin {
 
             auto provider = ImHexApi::Provider::get();
 
+            auto patch = provider->getPatches().get(offset);
+            if (!patch.has_value())
+                return std::nullopt;
+
             u8 byte = 0x00;
             provider->read(offset, &byte, sizeof(u8), false);
 
-            const auto &patches = provider->getPatches();
-            if (patches.contains(offset) && patches.at(offset) != byte)
+            if (*patch != byte)
                 return ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarRed);
             else
                 return std::nullopt;
@@ -68,35 +108,38 @@ namespace hex::plugin::builtin {
 
                     ImGuiListClipper clipper;
 
-                    clipper.Begin(patches.size());
+                    clipper.Begin(patches.getExtentCount());
                     while (clipper.Step()) {
-                        auto iter = patches.begin();
-                        for (auto i = 0; i < clipper.DisplayStart; i++)
-                            iter++;
+                        auto iter = std::next(patches.begin(), clipper.DisplayStart);
 
                         for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-                            const auto &[address, patch] = *iter;
+                            const auto &[address, bytes] = *iter;
 
                             ImGui::TableNextRow();
                             ImGui::TableNextColumn();
 
                             if (ImGui::Selectable(("##patchLine" + std::to_string(index)).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
-                                ImHexApi::HexEditor::setSelection(address, 1);
+                                ImHexApi::HexEditor::setSelection(address, bytes.size());
                             }
                             if (ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
                                 ImGui::OpenPopup("PatchContextMenu");
-                                this->m_selectedPatch = address;
+                                this->m_selectedPatch = { address, bytes.size() };
                             }
                             ImGui::SameLine();
-                            ImGui::TextFormatted("0x{0:08X}", address);
+                            if (bytes.size() == 1)
+                                ImGui::TextFormatted("0x{0:08X}", address);
+                            else
+                                ImGui::TextFormatted("0x{0:08X} - 0x{1:08X}", address, address + bytes.size() - 1);
+
+                            const auto previewSize = std::min<size_t>(bytes.size(), MaxPreviewBytes);
 
                             ImGui::TableNextColumn();
-                            u8 previousValue = 0x00;
-                            provider->readRaw(address, &previousValue, sizeof(u8));
-                            ImGui::TextFormatted("0x{0:02X}", previousValue);
+                            std::vector<u8> previousValues(previewSize, 0x00);
+                            provider->readRaw(address, previousValues.data(), previousValues.size());
+                            ImGui::TextUnformatted(formatPreviewBytes(previousValues, bytes.size()).c_str());
 
                             ImGui::TableNextColumn();
-                            ImGui::TextFormatted("0x{0:02X}", patch);
+                            ImGui::TextUnformatted(formatPreviewBytes({ bytes.begin(), bytes.begin() + previewSize }, bytes.size()).c_str());
                             index += 1;
 
                             iter++;
@@ -105,7 +148,7 @@ namespace hex::plugin::builtin {
 
                     if (ImGui::BeginPopup("PatchContextMenu")) {
                         if (ImGui::MenuItem("hex.builtin.view.patches.remove"_lang)) {
-                            patches.erase(this->m_selectedPatch);
+                            patches.erase(this->m_selectedPatch.getStartAddress(), this->m_selectedPatch.getSize());
                         }
                         ImGui::EndPopup();
                     }
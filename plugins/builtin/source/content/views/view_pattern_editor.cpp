@@ -3,6 +3,8 @@
 #include <hex/api/content_registry.hpp>
 
 #include <pl/patterns/pattern.hpp>
+#include <pl/patterns/pattern_bitfield.hpp>
+#include <pl/patterns/pattern_pointer.hpp>
 #include <pl/core/preprocessor.hpp>
 #include <pl/core/parser.hpp>
 #include <pl/core/ast/ast_node_variable_decl.hpp>
@@ -442,24 +444,21 @@ namespace hex::plugin::builtin {
 
                     auto hexEditor = auto(this->m_sectionHexEditor);
 
-                    hexEditor.setBackgroundHighlightCallback([this, id](u64 address, const u8 *, size_t) -> std::optional<color_t> {
+                    hexEditor.setBackgroundHighlightRegionCallback([this, id](const Region &region) {
+                        std::vector<ImHexApi::HexEditor::Highlighting> result;
+
                         if (this->m_runningEvaluators != 0)
-                            return std::nullopt;
+                            return result;
                         if (!ImHexApi::Provider::isValid())
-                            return std::nullopt;
-
-                        std::optional<ImColor> color;
-                        for (const auto &pattern : ProviderExtraData::getCurrent().patternLanguage.runtime->getPatternsAtAddress(address, id)) {
-                            if (pattern->getVisibility() != pl::ptrn::Visibility::Visible)
-                                continue;
+                            return result;
 
-                            if (color.has_value())
-                                color = ImAlphaBlendColors(*color, pattern->getColor());
-                            else
-                                color = pattern->getColor();
+                        const auto &sectionHighlights = ProviderExtraData::getCurrent().patternLanguage.sectionHighlights;
+                        if (auto it = sectionHighlights.find(id); it != sectionHighlights.end()) {
+                            for (const auto &[spanRegion, color] : it->second.find(region))
+                                result.emplace_back(spanRegion, color);
                         }
 
-                        return color;
+                        return result;
                     });
 
                     auto patternProvider = ImHexApi::Provider::get();
@@ -683,6 +682,33 @@ namespace hex::plugin::builtin {
         this->m_runningParsers--;
     }
 
+    static void collectHighlights(pl::ptrn::Pattern &pattern, std::vector<ColorSpanIndex::Span> &highlights) {
+        // Only the innermost patterns get highlighted. Bitfields are highlighted as a whole since their fields aren't byte aligned
+        if (dynamic_cast<pl::ptrn::PatternBitfield *>(&pattern) == nullptr) {
+            if (auto iteratable = dynamic_cast<pl::ptrn::Iteratable *>(&pattern); iteratable != nullptr) {
+                iteratable->forEachEntry(0, iteratable->getEntryCount(), [&](u64, pl::ptrn::Pattern *entry) {
+                    collectHighlights(*entry, highlights);
+                });
+
+                return;
+            }
+        }
+
+        if (pattern.getVisibility() == pl::ptrn::Visibility::Visible && pattern.getSize() > 0)
+            highlights.push_back({ { pattern.getOffset(), pattern.getSize() }, pattern.getColor() });
+
+        if (auto pointer = dynamic_cast<pl::ptrn::PatternPointer *>(&pattern); pointer != nullptr && pointer->getPointedAtPattern() != nullptr)
+            collectHighlights(*pointer->getPointedAtPattern(), highlights);
+    }
+
+    static ColorSpanIndex createHighlightIndex(const std::vector<std::shared_ptr<pl::ptrn::Pattern>> &patterns) {
+        std::vector<ColorSpanIndex::Span> highlights;
+        for (const auto &pattern : patterns)
+            collectHighlights(*pattern, highlights);
+
+        return ColorSpanIndex(std::move(highlights));
+    }
+
     void ViewPatternEditor::evaluatePattern(const std::string &code, prv::Provider *provider) {
         auto &patternLanguage = ProviderExtraData::get(provider).patternLanguage;
 
@@ -740,10 +766,19 @@ namespace hex::plugin::builtin {
             };
 
 
+            patternLanguage.highlights = { };
+            patternLanguage.sectionHighlights.clear();
+
             this->m_lastEvaluationResult = runtime->executeString(code, envVars, inVariables);
             if (!this->m_lastEvaluationResult) {
                 patternLanguage.lastEvaluationError = runtime->getError();
+                return;
             }
+
+            // Resolve the colors of all patterns once here so drawing the highlighting doesn't need to look up the patterns of every byte
+            patternLanguage.highlights = createHighlightIndex(runtime->getAllPatterns());
+            for (const auto &[id, section] : runtime->getSections())
+                patternLanguage.sectionHighlights[id] = createHighlightIndex(runtime->getAllPatterns(id));
         });
     }
 
@@ -972,24 +1007,16 @@ namespace hex::plugin::builtin {
             }
         });
 
-        ImHexApi::HexEditor::addBackgroundHighlightingProvider([this](u64 address, const u8 *data, size_t size, bool) -> std::optional<color_t> {
-            hex::unused(data, size);
+        ImHexApi::HexEditor::addBackgroundHighlightingRegionProvider([this](const Region &region) {
+            std::vector<ImHexApi::HexEditor::Highlighting> result;
 
             if (this->m_runningEvaluators != 0)
-                return std::nullopt;
-
-            std::optional<ImColor> color;
-            for (const auto &pattern : ProviderExtraData::getCurrent().patternLanguage.runtime->getPatternsAtAddress(address)) {
-                if (pattern->getVisibility() != pl::ptrn::Visibility::Visible)
-                    continue;
+                return result;
 
-                if (color.has_value())
-                    color = ImAlphaBlendColors(*color, pattern->getColor());
-                else
-                    color = pattern->getColor();
-            }
+            for (const auto &[spanRegion, color] : ProviderExtraData::getCurrent().patternLanguage.highlights.find(region))
+                result.emplace_back(spanRegion, color);
 
-            return color;
+            return result;
         });
 
         ImHexApi::HexEditor::addTooltipProvider([this](u64 address, const u8 *data, size_t size) {
@@ -14,6 +14,7 @@
 #include <yara.h>
 #pragma GCC diagnostic pop
 
+#include <cstring>
 #include <filesystem>
 #include <thread>
 
@@ -96,6 +97,7 @@ namespace hex::plugin::builtin {
     }
 
     ViewYara::~ViewYara() {
+        this->m_compiledRules.clear();
         yr_finalize();
     }
 
@@ -268,173 +270,257 @@ namespace hex::plugin::builtin {
         this->m_consoleMessages.clear();
     }
 
-    void ViewYara::applyRules() {
-        this->clearResult();
+    namespace {
 
-        this->m_matcherTask = TaskManager::createTask("hex.builtin.view.yara.matching", 0, [this](auto &task) {
-            if (!ImHexApi::Provider::isValid()) return;
+        // Amount of data handed to YARA at once
+        constexpr static u64 ScanBlockSize = 10_MiB;
 
-            auto &extraData = ProviderExtraData::getCurrent().yara;
-            auto &rules = extraData.rules;
-            auto &matches = extraData.matches;
+        struct ResultContext {
+            Task *task = nullptr;
+            std::vector<ProviderExtraData::Data::Yara::YaraMatch> newMatches;
+            std::vector<std::string> consoleMessages;
+        };
 
-            struct ResultContext {
+        u64 getOverlapSize(YR_RULES *rules) {
+            u64 result = 0;
+
+            YR_RULE *rule;
+            YR_STRING *string;
+            yr_rules_foreach(rules, rule) {
+                if (rule->strings == nullptr)
+                    continue;
+
+                yr_rule_strings_foreach(rule, string) {
+                    // Wide literals match twice as many bytes as their length. Everything else can match up to YARA's regex scan limit
+                    if (STRING_IS_LITERAL(string))
+                        result = std::max<u64>(result, u64(string->length) * 2);
+                    else
+                        result = std::max<u64>(result, YR_RE_SCAN_LIMIT);
+                }
+            }
+
+            return result;
+        }
+
+        void scanProvider(Task &task, prv::Provider *provider, YR_RULES *rules, u64 overlapSize, ResultContext &results) {
+            struct ScanContext {
                 Task *task = nullptr;
-                std::vector<ProviderExtraData::Data::Yara::YaraMatch> newMatches;
-                std::vector<std::string> consoleMessages;
+                prv::Provider *provider = nullptr;
+                u64 dataSize = 0;
+                u64 overlapSize = 0;
+                u64 nextAddress = 0;
+                std::vector<u8> buffer;
+                prv::DataView view;
+                YR_MEMORY_BLOCK currBlock = {};
             };
 
-            ResultContext resultContext;
-            resultContext.task = &task;
-
-            for (const auto &[fileName, filePath] : rules) {
-                YR_COMPILER *compiler = nullptr;
-                yr_compiler_create(&compiler);
-                ON_SCOPE_EXIT {
-                    yr_compiler_destroy(compiler);
-                };
-
-                auto currFilePath = wolv::util::toUTF8String(wolv::io::fs::toShortPath(filePath));
-
-                yr_compiler_set_include_callback(
-                    compiler,
-                    [](const char *includeName, const char *, const char *, void *userData) -> const char * {
-                        wolv::io::File file(std::fs::path(static_cast<const char *>(userData)).parent_path() / includeName, wolv::io::File::Mode::Read);
-                        if (!file.isValid())
-                            return nullptr;
-
-                        auto size    = file.getSize();
-                        char *buffer = new char[size + 1];
-                        file.readBuffer(reinterpret_cast<u8 *>(buffer), size);
-                        buffer[size] = 0x00;
-
-                        return buffer;
-                    },
-                    [](const char *ptr, void *userData) {
-                        hex::unused(userData);
+            ScanContext context;
+            context.task        = &task;
+            context.provider    = provider;
+            context.dataSize    = provider->getActualSize();
+            context.overlapSize = overlapSize;
+
+            context.currBlock.fetch_data = [](auto *block) -> const u8 * {
+                auto &context = *static_cast<ScanContext *>(block->context);
+                const auto address = context.provider->getBaseAddress() + block->base;
+
+                if (block->size == 0)
+                    return nullptr;
+
+                // Hand the provider's data to YARA directly if possible instead of copying it first
+                if (auto view = context.provider->getDataView(address, block->size); view.has_value()) {
+                    context.view = std::move(*view);
+                    return context.view.data();
+                }
+
+                context.buffer.resize(block->size);
+                context.provider->read(address, context.buffer.data(), context.buffer.size());
+
+                return context.buffer.data();
+            };
+
+            YR_MEMORY_BLOCK_ITERATOR iterator;
+            iterator.context   = &context;
+            iterator.file_size = [](auto *iterator) -> u64 {
+                return static_cast<ScanContext *>(iterator->context)->dataSize;
+            };
+            iterator.first = [](YR_MEMORY_BLOCK_ITERATOR *iterator) -> YR_MEMORY_BLOCK * {
+                auto &context = *static_cast<ScanContext *>(iterator->context);
+
+                context.nextAddress = 0;
+                iterator->last_error = ERROR_SUCCESS;
+
+                return iterator->next(iterator);
+            };
+            iterator.next = [](YR_MEMORY_BLOCK_ITERATOR *iterator) -> YR_MEMORY_BLOCK * {
+                auto &context = *static_cast<ScanContext *>(iterator->context);
+
+                iterator->last_error = ERROR_SUCCESS;
+
+                const u64 address = context.nextAddress;
+                if (address >= context.dataSize)
+                    return nullptr;
+
+                context.task->update(address);
+
+                // Blocks overlap by the length of the longest possible match so matches crossing a block boundary are found as well.
+                // YARA ignores matches it already found at the same offset in the previous block
+                context.currBlock.base    = address;
+                context.currBlock.size    = std::min<u64>(context.dataSize - address, ScanBlockSize + context.overlapSize);
+                context.currBlock.context = &context;
+                context.nextAddress       = address + ScanBlockSize;
+
+                return &context.currBlock;
+            };
+
+            yr_rules_scan_mem_blocks(
+                    rules, &iterator, 0, [](YR_SCAN_CONTEXT *context, int message, void *data, void *userData) -> int {
+                        auto &results = *static_cast<ResultContext *>(userData);
 
-                        delete[] ptr;
+                        switch (message) {
+                            case CALLBACK_MSG_RULE_MATCHING:
+                            {
+                                auto rule = static_cast<YR_RULE *>(data);
+
+                                YR_STRING *string;
+                                YR_MATCH *match;
+
+                                if (rule->strings != nullptr) {
+                                    yr_rule_strings_foreach(rule, string) {
+                                        yr_string_matches_foreach(context, string, match) {
+                                                results.newMatches.push_back({ rule->identifier, string->identifier, u64(match->base + match->offset), size_t(match->match_length), false, 0, 0 });
+                                            }
+                                    }
+                                } else {
+                                    results.newMatches.push_back({ rule->identifier, "", 0, 0, true, 0, 0 });
+                                }
+                            }
+                                break;
+                            case CALLBACK_MSG_CONSOLE_LOG:
+                            {
+                                results.consoleMessages.emplace_back(static_cast<const char *>(data));
+                            }
+                                break;
+                            default:
+                                break;
+                        }
+
+                        return results.task->shouldInterrupt() ? CALLBACK_ABORT : CALLBACK_CONTINUE;
                     },
-                    currFilePath.data()
-                );
+                    &results,
+                    0);
+        }
 
-                wolv::io::File file(rules[this->m_selectedRule].second, wolv::io::File::Mode::Read);
-                if (!file.isValid()) return;
+    }
 
-                if (yr_compiler_add_file(compiler, file.getHandle(), nullptr, nullptr) != 0) {
-                    std::string errorMessage(0xFFFF, '\x00');
-                    yr_compiler_get_error_message(compiler, errorMessage.data(), errorMessage.size());
+    ViewYara::CompiledRules ViewYara::getCompiledRules(const std::fs::path &path) {
+        std::scoped_lock lock(this->m_compiledRulesMutex);
 
-                    TaskManager::doLater([this, errorMessage = wolv::util::trim(errorMessage)] {
-                        this->clearResult();
+        std::error_code error;
+        const auto lastWriteTime = std::fs::last_write_time(path, error);
 
-                        this->m_consoleMessages.push_back("Error: " + errorMessage);
-                    });
+        if (auto it = this->m_compiledRules.find(path); it != this->m_compiledRules.end() && !error && it->second.lastWriteTime == lastWriteTime)
+            return it->second;
 
-                    return;
-                }
+        CompiledRules result;
+        result.lastWriteTime = lastWriteTime;
+
+        YR_COMPILER *compiler = nullptr;
+        yr_compiler_create(&compiler);
+        ON_SCOPE_EXIT {
+            yr_compiler_destroy(compiler);
+        };
+
+        auto currFilePath = wolv::util::toUTF8String(wolv::io::fs::toShortPath(path));
+
+        yr_compiler_set_include_callback(
+            compiler,
+            [](const char *includeName, const char *, const char *, void *userData) -> const char * {
+                wolv::io::File file(std::fs::path(static_cast<const char *>(userData)).parent_path() / includeName, wolv::io::File::Mode::Read);
+                if (!file.isValid())
+                    return nullptr;
 
-                YR_RULES *yaraRules;
-                yr_compiler_get_rules(compiler, &yaraRules);
-                ON_SCOPE_EXIT { yr_rules_destroy(yaraRules); };
+                auto size    = file.getSize();
+                char *buffer = new char[size + 1];
+                file.readBuffer(reinterpret_cast<u8 *>(buffer), size);
+                buffer[size] = 0x00;
 
-                YR_MEMORY_BLOCK_ITERATOR iterator;
+                return buffer;
+            },
+            [](const char *ptr, void *userData) {
+                hex::unused(userData);
 
-                struct ScanContext {
-                    Task *task = nullptr;
-                    std::vector<u8> buffer;
-                    YR_MEMORY_BLOCK currBlock = {};
-                };
+                delete[] ptr;
+            },
+            currFilePath.data()
+        );
 
-                ScanContext context;
-                context.task                 = &task;
-                context.currBlock.base       = 0;
-                context.currBlock.fetch_data = [](auto *block) -> const u8 * {
-                    auto &context = *static_cast<ScanContext *>(block->context);
-                    auto provider = ImHexApi::Provider::get();
+        wolv::io::File file(path, wolv::io::File::Mode::Read);
+        if (!file.isValid()) {
+            result.error = hex::format("Failed to open {}", currFilePath);
+            return result;
+        }
 
-                    context.buffer.resize(context.currBlock.size);
+        if (yr_compiler_add_file(compiler, file.getHandle(), nullptr, nullptr) != 0) {
+            std::string errorMessage(0xFFFF, '\x00');
+            yr_compiler_get_error_message(compiler, errorMessage.data(), errorMessage.size());
 
-                    if (context.buffer.empty())
-                        return nullptr;
+            errorMessage.resize(std::strlen(errorMessage.c_str()));
 
-                    block->size = context.currBlock.size;
-                    provider->read(context.currBlock.base + provider->getBaseAddress(), context.buffer.data(), context.buffer.size());
+            result.error = wolv::util::trim(errorMessage);
+        } else {
+            YR_RULES *yaraRules = nullptr;
+            yr_compiler_get_rules(compiler, &yaraRules);
 
-                    return context.buffer.data();
-                };
-                iterator.file_size = [](auto *iterator) -> u64 {
-                    hex::unused(iterator);
+            result.rules = std::shared_ptr<YR_RULES>(yaraRules, yr_rules_destroy);
+            result.overlapSize = getOverlapSize(yaraRules);
+        }
 
-                    return ImHexApi::Provider::get()->getActualSize();
-                };
+        this->m_compiledRules[path] = result;
 
-                iterator.context = &context;
-                iterator.first   = [](YR_MEMORY_BLOCK_ITERATOR *iterator) -> YR_MEMORY_BLOCK   *{
-                    auto &context = *static_cast<ScanContext *>(iterator->context);
+        return result;
+    }
 
-                    context.currBlock.base = 0;
-                    context.currBlock.size = 0;
-                    context.buffer.clear();
-                    iterator->last_error = ERROR_SUCCESS;
+    void ViewYara::applyRules() {
+        this->clearResult();
 
-                    return iterator->next(iterator);
-                };
-                iterator.next = [](YR_MEMORY_BLOCK_ITERATOR *iterator) -> YR_MEMORY_BLOCK * {
-                    auto &context = *static_cast<ScanContext *>(iterator->context);
+        if (!ImHexApi::Provider::isValid())
+            return;
 
-                    u64 address = context.currBlock.base + context.currBlock.size;
+        auto provider = ImHexApi::Provider::get();
+        auto rules = ProviderExtraData::get(provider).yara.rules;
 
-                    iterator->last_error      = ERROR_SUCCESS;
-                    context.currBlock.base    = address;
-                    context.currBlock.size    = std::min<size_t>(ImHexApi::Provider::get()->getActualSize() - address, 10_MiB);
-                    context.currBlock.context = &context;
-                    context.task->update(address);
+        this->m_matcherTask = TaskManager::createTask("hex.builtin.view.yara.matching", 0, [this, provider, rules](auto &task) {
+            std::mutex resultMutex;
+            ResultContext resultContext;
 
-                    if (context.currBlock.size == 0) return nullptr;
+            // Every rule file is scanned on its own worker. Each one gets a slice of the task's progress as big as the data
+            const u64 dataSize = std::max<u64>(provider->getActualSize(), 1);
+            task.setMaxValue(dataSize * rules.size());
 
-                    return &context.currBlock;
-                };
+            task.parallelFor({ 0, dataSize * rules.size() }, dataSize, [&](Task &subtask, Region chunk) {
+                const auto &[fileName, filePath] = rules[chunk.getStartAddress() / dataSize];
 
-                yr_rules_scan_mem_blocks(
-                        yaraRules, &iterator, 0, [](YR_SCAN_CONTEXT *context, int message, void *data, void *userData) -> int {
-                            auto &results = *static_cast<ResultContext *>(userData);
+                auto compiledRules = this->getCompiledRules(filePath);
+                if (compiledRules.rules == nullptr) {
+                    std::scoped_lock lock(resultMutex);
+                    resultContext.consoleMessages.push_back("Error: " + compiledRules.error);
 
-                            switch (message) {
-                                case CALLBACK_MSG_RULE_MATCHING:
-                                {
-                                    auto rule = static_cast<YR_RULE *>(data);
+                    return;
+                }
 
-                                    YR_STRING *string;
-                                    YR_MATCH *match;
+                ResultContext results;
+                results.task = &subtask;
+                scanProvider(subtask, provider, compiledRules.rules.get(), compiledRules.overlapSize, results);
 
-                                    if (rule->strings != nullptr) {
-                                        yr_rule_strings_foreach(rule, string) {
-                                            yr_string_matches_foreach(context, string, match) {
-                                                    results.newMatches.push_back({ rule->identifier, string->identifier, u64(match->offset), size_t(match->match_length), false, 0, 0 });
-                                                }
-                                        }
-                                    } else {
-                                        results.newMatches.push_back({ rule->identifier, "", 0, 0, true, 0, 0 });
-                                    }
-                                }
-                                    break;
-                                case CALLBACK_MSG_CONSOLE_LOG:
-                                {
-                                    results.consoleMessages.emplace_back(static_cast<const char *>(data));
-                                }
-                                    break;
-                                default:
-                                    break;
-                            }
+                std::scoped_lock lock(resultMutex);
+                std::move(results.newMatches.begin(), results.newMatches.end(), std::back_inserter(resultContext.newMatches));
+                std::move(results.consoleMessages.begin(), results.consoleMessages.end(), std::back_inserter(resultContext.consoleMessages));
+            });
 
-                            return results.task->shouldInterrupt() ? CALLBACK_ABORT : CALLBACK_CONTINUE;
-                        },
-                        &resultContext,
-                        0);
+            TaskManager::doLater([this, provider, resultContext] {
+                auto &matches = ProviderExtraData::get(provider).yara.matches;
 
-            }
-            TaskManager::doLater([this, &matches, resultContext] {
                 for (const auto &match : matches) {
                     ImHexApi::HexEditor::removeBackgroundHighlight(match.highlightId);
                     ImHexApi::HexEditor::removeTooltip(match.tooltipId);
@@ -452,7 +538,7 @@ namespace hex::plugin::builtin {
                 std::move(uniques.begin(), uniques.end(), std::back_inserter(matches));
 
                 constexpr static color_t YaraColor = 0x70B4771F;
-                for (auto &match : uniques) {
+                for (auto &match : matches) {
                     match.highlightId = ImHexApi::HexEditor::addBackgroundHighlight({ match.address, match.size }, YaraColor);
                     match.tooltipId = ImHexApi::HexEditor::addTooltip({ match. address, match.size }, hex::format("{0} [{1}]", match.identifier, match.variable), YaraColor);
                 }
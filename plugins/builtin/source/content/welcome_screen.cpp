@@ -7,6 +7,8 @@
 #include <hex/ui/view.hpp>
 #include <hex/helpers/fs.hpp>
 #include <hex/helpers/logger.hpp>
+#include <hex/helpers/literals.hpp>
+#include <hex/providers/undo_stack.hpp>
 
 #include <hex/api/project_file_manager.hpp>
 
@@ -30,6 +32,8 @@
 
 namespace hex::plugin::builtin {
 
+    using namespace hex::literals;
+
     constexpr static auto MaxRecentProviders = 5;
 
     static ImGui::Texture s_bannerTexture, s_backdropTexture;
@@ -465,6 +469,12 @@ namespace hex::plugin::builtin {
 
                 ImHexApi::System::setTargetFPS(targetFps);
             }
+
+            {
+                auto undoMemoryLimit = ContentRegistry::Settings::read("hex.builtin.setting.general", "hex.builtin.setting.general.undo_memory_limit", 512);
+
+                prv::UndoStack::setMemoryLimit(size_t(undoMemoryLimit) * 1_MiB);
+            }
         });
 
         (void)EventManager::subscribe<RequestChangeTheme>([](const std::string &theme) {
@@ -7,6 +7,9 @@
 #include <hex/helpers/encoding_file.hpp>
 #include <hex/helpers/utils.hpp>
 
+#include <chrono>
+#include <thread>
+
 namespace hex::plugin::builtin::ui {
 
     /* Data Visualizer */
@@ -92,7 +95,6 @@ namespace hex::plugin::builtin::ui {
         EventManager::subscribe<EventSettingsChanged>(this, [this] {
             {
                 this->m_bytesPerRow = ContentRegistry::Settings::read("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.bytes_per_row", 16);
-                this->m_encodingLineStartAddresses.clear();
             }
 
             {
@@ -113,11 +115,100 @@ namespace hex::plugin::builtin::ui {
             this->m_byteCellPadding = ContentRegistry::Settings::read("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.byte_padding", 0);
             this->m_characterCellPadding = ContentRegistry::Settings::read("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.char_padding", 0);
         });
+
+        EventManager::subscribe<EventHighlightingChanged>(this, [this] {
+            this->invalidateHighlights();
+        });
+
+        // Modifications may be posted from any thread, the encoding index only gets built again during the next frame
+        EventManager::subscribe<EventProviderDataModified>(this, [this](prv::Provider *, Region) {
+            this->m_encodingLineIndexValid = false;
+        });
+
+        EventManager::subscribe<EventProviderClosing>(this, [this](prv::Provider *provider, bool *) {
+            if (this->m_encodingLineIndex != nullptr && this->m_encodingLineIndex->provider == provider)
+                this->resetEncodingLineIndex();
+        });
+
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            if (this->m_encodingLineIndex == nullptr || this->m_encodingLineIndex->provider != provider)
+                return;
+
+            // The indexing task may be in the middle of reading from the provider. Let it stop before the provider is gone
+            auto task = this->m_encodingIndexTask;
+            this->resetEncodingLineIndex();
+
+            while (task.isRunning())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
     }
 
     HexEditor::~HexEditor() {
         ImHexApi::HexEditor::removeForegroundHighlightingProvider(this->m_grayZeroHighlighter);
         EventManager::unsubscribe<EventSettingsChanged>(this);
+        EventManager::unsubscribe<EventHighlightingChanged>(this);
+        EventManager::unsubscribe<EventProviderDataModified>(this);
+        EventManager::unsubscribe<EventProviderClosing>(this);
+        EventManager::unsubscribe<EventProviderDeleted>(this);
+
+        this->m_encodingIndexTask.interrupt();
+    }
+
+    static std::vector<std::optional<color_t>> resolveHighlights(const std::vector<ImHexApi::HexEditor::Highlighting> &highlights, const Region &region) {
+        std::vector<std::optional<color_t>> colors(region.getSize());
+
+        // Paint the highlightings back to front so earlier ones take precedence
+        for (auto it = highlights.rbegin(); it != highlights.rend(); ++it) {
+            const auto &highlightRegion = it->getRegion();
+            if (!highlightRegion.overlaps(region))
+                continue;
+
+            const auto start = std::max(highlightRegion.getStartAddress(), region.getStartAddress()) - region.getStartAddress();
+            const auto end   = std::min(highlightRegion.getEndAddress(), region.getEndAddress()) - region.getStartAddress();
+
+            std::fill(colors.begin() + start, colors.begin() + end + 1, it->getColor());
+        }
+
+        return colors;
+    }
+
+    void HexEditor::updateHighlightCache(const Region &visibleRegion) {
+        const u64 dataStart = this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress();
+        const u64 dataEnd   = dataStart + this->m_provider->getSize();
+
+        auto &cache = this->m_highlightCache;
+        if (visibleRegion.getStartAddress() >= dataEnd) {
+            cache = { };
+            return;
+        }
+
+        const Region visibleData = { visibleRegion.getStartAddress(), std::min(visibleRegion.getEndAddress() + 1, dataEnd) - visibleRegion.getStartAddress() };
+
+        // Mark the cache as valid before querying the highlightings so changes made in the meantime invalidate it again
+        if (this->m_highlightCacheValid.exchange(true) && visibleData.isWithin(cache.region))
+            return;
+
+        // Also cache the rows around the visible ones so scrolling doesn't require querying the highlightings every frame
+        const u64 margin = u64(std::max<u16>(this->m_visibleRowCount, 1)) * this->m_bytesPerRow;
+        const u64 start  = std::max(visibleData.getStartAddress(), dataStart + margin) - margin;
+        const u64 end    = std::min(visibleData.getEndAddress() + 1 + margin, dataEnd);
+
+        cache.region = { start, end - start };
+        cache.foregroundColors = resolveHighlights(this->m_foregroundRegionCallback(cache.region), cache.region);
+        cache.backgroundColors = resolveHighlights(this->m_backgroundRegionCallback(cache.region), cache.region);
+    }
+
+    std::optional<color_t> HexEditor::getCachedHighlightColor(const std::vector<std::optional<color_t>> &colors, u64 address, size_t size) const {
+        const auto &region = this->m_highlightCache.region;
+        if (colors.empty() || address < region.getStartAddress())
+            return std::nullopt;
+
+        for (u64 offset = address - region.getStartAddress(); offset < colors.size() && offset < address - region.getStartAddress() + size; offset++) {
+            if (colors[offset].has_value())
+                return colors[offset];
+        }
+
+        return std::nullopt;
     }
 
     constexpr static u16 getByteColumnSeparatorCount(u16 columnCount) {
@@ -152,40 +243,11 @@ namespace hex::plugin::builtin::ui {
         ImColor color;
     };
 
-    static CustomEncodingData queryCustomEncodingData(prv::Provider *provider, const EncodingFile &encodingFile, std::vector<u64> &lineStartAddresses, u32 bytesPerRow, u64 address) {
-        const auto longestSequence = encodingFile.getLongestSequence();
-
-        if (longestSequence == 0)
+    static CustomEncodingData queryCustomEncodingData(const EncodingFile &encodingFile, std::span<const u8> data) {
+        if (encodingFile.getLongestSequence() == 0)
             return { ".", 1, 0xFFFF8000 };
 
-        if (lineStartAddresses.empty() || lineStartAddresses.size() <= address / bytesPerRow) {
-            auto prevSize = lineStartAddresses.size();
-            auto newSize = address / bytesPerRow + 1;
-            lineStartAddresses.reserve(newSize);
-
-            std::vector<u8> buffer;
-            for (auto i = prevSize; i < newSize; i++) {
-                u32 offset = 0;
-                while (offset < bytesPerRow) {
-                    size_t readSize   = std::min<size_t>(longestSequence, provider->getActualSize() - address);
-                    buffer.resize(readSize);
-                    provider->read(address, buffer.data(), readSize);
-
-                    offset += encodingFile.getEncodingLengthFor(buffer);
-                }
-
-                lineStartAddresses.push_back(offset % bytesPerRow);
-            }
-        }
-
-        address += lineStartAddresses[address / bytesPerRow];
-
-        size_t size   = std::min<size_t>(longestSequence, provider->getActualSize() - address);
-
-        std::vector<u8> buffer(size);
-        provider->read(address, buffer.data(), size);
-
-        const auto [decoded, advance] = encodingFile.getEncodingFor(buffer);
+        const auto [decoded, advance] = encodingFile.getEncodingFor(data);
         const ImColor color = [&decoded = decoded, &advance = advance]{
             if (decoded.length() == 1 && std::isalnum(decoded[0]))
                 return ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarBlue);
@@ -202,6 +264,106 @@ namespace hex::plugin::builtin::ui {
         return { std::string(decoded), advance, color };
     }
 
+    void HexEditor::updateEncodingLineIndex() {
+        const u64 startAddress = this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress();
+
+        auto &index = this->m_encodingLineIndex;
+        const bool valid = this->m_encodingLineIndexValid.exchange(true);
+        if (valid && index != nullptr && index->provider == this->m_provider && index->startAddress == startAddress && index->bytesPerRow == this->m_bytesPerRow)
+            return;
+
+        this->resetEncodingLineIndex();
+        this->m_encodingLineIndexValid = true;
+
+        index = std::make_shared<EncodingLineIndex>();
+        index->provider     = this->m_provider;
+        index->startAddress = startAddress;
+        index->bytesPerRow  = this->m_bytesPerRow;
+
+        // Without any multi byte sequences every row starts with a new character, there's nothing to index
+        if (this->m_currCustomEncoding->getLongestSequence() <= 1)
+            return;
+
+        this->m_encodingIndexTask = TaskManager::createBackgroundTask("Indexing custom encoding", [index, encoding = *this->m_currCustomEncoding, size = this->m_provider->getSize()](auto &task) {
+            constexpr static u64 ChunkSize = 0x10000;
+
+            const u64 longestSequence = std::max<u64>(encoding.getLongestSequence(), 1);
+            const u64 bytesPerRow     = index->bytesPerRow;
+
+            std::vector<u8> buffer(ChunkSize + longestSequence);
+            u64 bufferOffset = 0, bufferSize = 0;
+
+            u64 offset = 0, checkpointRow = 0;
+            while (true) {
+                // The first character starting at or after the start of a checkpoint row determines where decoding that row starts
+                while (checkpointRow * bytesPerRow <= offset && checkpointRow * bytesPerRow < size) {
+                    std::scoped_lock lock(index->mutex);
+                    index->checkpoints.push_back(offset - checkpointRow * bytesPerRow);
+
+                    checkpointRow += EncodingCheckpointInterval;
+                }
+
+                if (offset >= size)
+                    break;
+
+                if (offset + longestSequence > bufferOffset + bufferSize && bufferOffset + bufferSize < size) {
+                    // Stop once the editor doesn't use this index anymore
+                    if (index.use_count() == 1)
+                        return;
+
+                    task.update(offset);
+
+                    bufferOffset = offset;
+                    bufferSize   = std::min<u64>(buffer.size(), size - offset);
+                    index->provider->read(index->startAddress + bufferOffset, buffer.data(), bufferSize);
+                }
+
+                offset += encoding.getEncodingLengthFor({ buffer.data() + (offset - bufferOffset), std::min<u64>(longestSequence, bufferOffset + bufferSize - offset) });
+            }
+        });
+    }
+
+    void HexEditor::resetEncodingLineIndex() {
+        this->m_encodingIndexTask.interrupt();
+        this->m_encodingLineIndex.reset();
+    }
+
+    void HexEditor::decodeEncodingRows(u64 firstRow, u64 lastRow) {
+        const auto &encoding = *this->m_currCustomEncoding;
+
+        const u64 startAddress    = this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress();
+        const u64 longestSequence = std::max<u64>(encoding.getLongestSequence(), 1);
+        const u64 bytesPerRow     = this->m_bytesPerRow;
+
+        // Start decoding at the closest checkpoint before the first row. Rows that haven't been indexed yet are decoded as if they started with a new character
+        u64 row = firstRow, offset = firstRow * bytesPerRow;
+        {
+            std::scoped_lock lock(this->m_encodingLineIndex->mutex);
+
+            const auto &checkpoints = this->m_encodingLineIndex->checkpoints;
+            if (const u64 checkpoint = firstRow / EncodingCheckpointInterval; checkpoint < checkpoints.size()) {
+                row    = checkpoint * EncodingCheckpointInterval;
+                offset = row * bytesPerRow + checkpoints[checkpoint];
+            }
+        }
+
+        // Read all data needed to decode the rows at once
+        const u64 endOffset = std::min<u64>(lastRow * bytesPerRow + longestSequence, this->m_provider->getSize());
+        this->m_encodingDataOffset = std::min(offset, endOffset);
+        this->m_encodingData.resize(endOffset - this->m_encodingDataOffset);
+        if (!this->m_encodingData.empty())
+            this->m_provider->read(startAddress + this->m_encodingDataOffset, this->m_encodingData.data(), this->m_encodingData.size());
+
+        this->m_encodingRowOffsets.clear();
+        for (; row < lastRow; row++) {
+            while (offset < row * bytesPerRow && offset < endOffset)
+                offset += encoding.getEncodingLengthFor(std::span(this->m_encodingData).subspan(offset - this->m_encodingDataOffset));
+
+            if (row >= firstRow)
+                this->m_encodingRowOffsets.push_back(offset);
+        }
+    }
+
     static auto getCellPosition() {
         return ImGui::GetCursorScreenPos() - ImGui::GetStyle().CellPadding;
     }
@@ -373,6 +535,28 @@ namespace hex::plugin::builtin::ui {
                 while (clipper.Step()) {
                     this->m_visibleRowCount = clipper.DisplayEnd - clipper.DisplayStart;
 
+                    this->updateHighlightCache({
+                        u64(clipper.DisplayStart) * this->m_bytesPerRow + this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress(),
+                        u64(std::max(clipper.DisplayEnd - clipper.DisplayStart, 1)) * this->m_bytesPerRow
+                    });
+
+                    // Read the data of all visible rows at once instead of doing one read per row
+                    {
+                        const u64 visibleOffset = u64(clipper.DisplayStart) * this->m_bytesPerRow;
+                        const u64 visibleSize   = u64(std::max(clipper.DisplayEnd - clipper.DisplayStart, 0)) * this->m_bytesPerRow;
+
+                        this->m_visibleData.assign(visibleSize, 0x00);
+
+                        const u64 readSize = std::min<u64>(visibleSize, this->m_provider->getSize() - std::min<u64>(visibleOffset, this->m_provider->getSize()));
+                        if (readSize > 0)
+                            this->m_provider->read(visibleOffset + this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress(), this->m_visibleData.data(), readSize);
+                    }
+
+                    if (this->m_currCustomEncoding.has_value()) {
+                        this->updateEncodingLineIndex();
+                        this->decodeEncodingRows(clipper.DisplayStart, clipper.DisplayEnd);
+                    }
+
                     // Loop over rows
                     for (u64 y = u64(clipper.DisplayStart); y < u64(clipper.DisplayEnd); y++) {
                         // Draw address column
@@ -383,10 +567,10 @@ namespace hex::plugin::builtin::ui {
 
                         const u8 validBytes = std::min<u64>(this->m_bytesPerRow, this->m_provider->getSize() - y * this->m_bytesPerRow);
 
-                        std::vector<u8> bytes(this->m_bytesPerRow, 0x00);
-                        this->m_provider->read(y * this->m_bytesPerRow + this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress(), bytes.data(), validBytes);
+                        u8 *bytes = &this->m_visibleData[(y - u64(clipper.DisplayStart)) * this->m_bytesPerRow];
 
-                        std::vector<std::tuple<std::optional<color_t>, std::optional<color_t>>> cellColors;
+                        auto &cellColors = this->m_rowCellColors;
+                        cellColors.clear();
                         {
                             for (u64 x = 0; x <  std::ceil(float(validBytes) / bytesPerCell); x++) {
                                 const u64 byteAddress = y * this->m_bytesPerRow + x * bytesPerCell + this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress();
@@ -395,8 +579,13 @@ namespace hex::plugin::builtin::ui {
 
                                 // Query cell colors
                                 if (x < std::ceil(float(validBytes) / bytesPerCell)) {
-                                    const auto foregroundColor = this->m_foregroundColorCallback(byteAddress, &bytes[x * cellBytes], cellBytes);
-                                    const auto backgroundColor = this->m_backgroundColorCallback(byteAddress, &bytes[x * cellBytes], cellBytes);
+                                    auto foregroundColor = this->m_foregroundColorCallback(byteAddress, &bytes[x * cellBytes], cellBytes);
+                                    auto backgroundColor = this->m_backgroundColorCallback(byteAddress, &bytes[x * cellBytes], cellBytes);
+
+                                    if (!foregroundColor.has_value())
+                                        foregroundColor = this->getCachedHighlightColor(this->m_highlightCache.foregroundColors, byteAddress, cellBytes);
+                                    if (!backgroundColor.has_value())
+                                        backgroundColor = this->getCachedHighlightColor(this->m_highlightCache.backgroundColors, byteAddress, cellBytes);
 
                                     cellColors.emplace_back(
                                             foregroundColor,
@@ -537,19 +726,18 @@ namespace hex::plugin::builtin::ui {
                         // Draw Custom encoding column
                         if (this->m_currCustomEncoding.has_value()) {
                             std::vector<std::pair<u64, CustomEncodingData>> encodingData;
-                            u32 offset = 0;
-                            do {
-                                const u64 address = y * this->m_bytesPerRow + offset + this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress();
 
-                                auto result = queryCustomEncodingData(this->m_provider, *this->m_currCustomEncoding, this->m_encodingLineStartAddresses, this->m_bytesPerRow, address);
-                                offset += std::max<size_t>(1, result.advance);
+                            const u64 rowEnd = std::min<u64>((y + 1) * this->m_bytesPerRow, this->m_provider->getSize());
+                            for (u64 offset = this->m_encodingRowOffsets[y - u64(clipper.DisplayStart)]; offset < rowEnd;) {
+                                auto result = queryCustomEncodingData(*this->m_currCustomEncoding, std::span(this->m_encodingData).subspan(offset - this->m_encodingDataOffset));
 
-                                encodingData.emplace_back(address, result);
-                            } while (offset < this->m_bytesPerRow);
+                                encodingData.emplace_back(offset + this->m_provider->getBaseAddress() + this->m_provider->getCurrentPageAddress(), result);
+                                offset += std::max<size_t>(1, result.advance);
+                            }
 
                             ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(0, 0));
                             ImGui::PushID(y);
-                            if (ImGui::BeginTable("##encoding_cell", encodingData.size(), ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_NoKeepColumnsVisible)) {
+                            if (!encodingData.empty() && ImGui::BeginTable("##encoding_cell", encodingData.size(), ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_NoKeepColumnsVisible)) {
                                 ImGui::TableNextRow();
 
                                 for (const auto &[address, data] : encodingData) {
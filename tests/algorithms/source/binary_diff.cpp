@@ -0,0 +1,83 @@
+#include <hex/api/task.hpp>
+#include <hex/helpers/binary_diff.hpp>
+#include <hex/test/test_provider.hpp>
+#include <hex/test/test_task.hpp>
+#include <hex/test/tests.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using hex::diff::Difference;
+using hex::diff::DifferenceType;
+
+static std::vector<Difference> diff(std::vector<u8> dataA, std::vector<u8> dataB) {
+    hex::test::TestProvider providerA(&dataA), providerB(&dataB);
+
+    std::vector<Difference> result;
+    hex::test::runTask([&](hex::Task &task) {
+        result = hex::diff::compare(task, &providerA, { 0, dataA.size() }, &providerB, { 0, dataB.size() });
+    });
+
+    return result;
+}
+
+static std::vector<u8> generateData(size_t size, u32 seed) {
+    std::mt19937 gen(seed);
+
+    std::vector<u8> data(size);
+    std::generate(data.begin(), data.end(), [&] { return u8(gen()); });
+
+    return data;
+}
+
+TEST_SEQUENCE("BinaryDiffModifications") {
+    hex::test::TaskManagerScope taskManager;
+
+    const auto original = generateData(0x10'0000, 1337);
+    TEST_ASSERT(diff(original, original).empty());
+
+    auto modified = original;
+    for (u64 address : { 0x1000, 0x1001, 0x1002, 0x8'0000 })
+        modified[address] = ~original[address];
+
+    TEST_ASSERT(diff(modified, original) == std::vector<Difference>({
+        { { 0x1000, 3 }, { 0x1000, 3 }, DifferenceType::Modified },
+        { { 0x8'0000, 1 }, { 0x8'0000, 1 }, DifferenceType::Modified }
+    }));
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("BinaryDiffInsertions") {
+    hex::test::TaskManagerScope taskManager;
+
+    auto original = generateData(0x40'0000, 42);
+    original[0x3'FFFF] = original[0x4'0000] = 0x00;
+
+    // Data that got inserted into the first provider is reported as added, everything behind it is still aligned
+    auto inserted = original;
+    inserted.insert(inserted.begin() + 0x4'0000, 100, 0xAA);
+    TEST_ASSERT(diff(inserted, original) == std::vector<Difference>({
+        { { 0x4'0000, 100 }, { 0x4'0000, 0 }, DifferenceType::Added }
+    }));
+    TEST_ASSERT(diff(original, inserted) == std::vector<Difference>({
+        { { 0x4'0000, 0 }, { 0x4'0000, 100 }, DifferenceType::Removed }
+    }));
+
+    // Shifted data containing modifications
+    auto shifted = original;
+    shifted.erase(shifted.begin() + 0x10, shifted.begin() + 0x30);
+    shifted[0x30'0000] = ~original[0x30'0020];
+    TEST_ASSERT(diff(shifted, original) == std::vector<Difference>({
+        { { 0x10, 0 }, { 0x10, 0x20 }, DifferenceType::Removed },
+        { { 0x30'0000, 1 }, { 0x30'0020, 1 }, DifferenceType::Modified }
+    }));
+
+    // Repetitive data can't be aligned unambiguously, but the amount of inserted data still has to be right
+    std::vector<u8> zeros(0x10'0000, 0x00), moreZeros(0x10'0010, 0x00);
+    auto differences = diff(zeros, moreZeros);
+    TEST_ASSERT(differences.size() == 1 && differences.front().type == DifferenceType::Removed && differences.front().regionB.getSize() == 0x10);
+
+    TEST_SUCCESS();
+};
@@ -0,0 +1,142 @@
+#include <hex/helpers/byte_pattern.hpp>
+#include <hex/helpers/logger.hpp>
+#include <hex/test/tests.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
+
+using Implementation = hex::BytePattern::Implementation;
+
+constexpr static auto Implementations = { Implementation::Scalar, Implementation::SSE2, Implementation::AVX2 };
+
+// Previous matcher of the Find view, kept as a reference
+static std::optional<size_t> findNaive(const std::vector<u8> &data, const std::vector<hex::BytePattern::Byte> &pattern, size_t offset) {
+    for (size_t i = offset; i + pattern.size() <= data.size(); i++) {
+        bool matches = std::equal(pattern.begin(), pattern.end(), data.begin() + i, [](const auto &patternByte, u8 byte) {
+            return (byte & patternByte.mask) == patternByte.value;
+        });
+
+        if (matches)
+            return i;
+    }
+
+    return std::nullopt;
+}
+
+TEST_SEQUENCE("BytePatternFind") {
+    std::mt19937 gen(1337);
+    std::uniform_int_distribution<u16> byteDistribution(0, 3);
+    std::uniform_int_distribution<size_t> sizeDistribution(1, 40);
+
+    const std::array<u8, 3> masks = { 0x00, 0x0F, 0xFF };
+
+    for (int i = 0; i < 500; i++) {
+        // Small alphabet so there are plenty of partial matches
+        std::vector<u8> data(sizeDistribution(gen) * 10);
+        std::generate(data.begin(), data.end(), [&] { return u8(0xA0 | byteDistribution(gen)); });
+
+        std::vector<hex::BytePattern::Byte> bytes(sizeDistribution(gen) % 12 + 1);
+        std::generate(bytes.begin(), bytes.end(), [&] {
+            const u8 mask = masks[byteDistribution(gen) % masks.size()];
+            return hex::BytePattern::Byte { mask, u8((0xA0 | byteDistribution(gen)) & mask) };
+        });
+
+        const hex::BytePattern pattern(bytes);
+
+        for (auto implementation : Implementations) {
+            size_t offset = 0;
+            while (true) {
+                auto expected = findNaive(data, bytes, offset);
+                auto actual   = pattern.find(implementation, data, offset);
+
+                TEST_ASSERT(expected == actual, "implementation {} at offset {}", u32(implementation), offset);
+
+                if (!expected.has_value())
+                    break;
+
+                offset = *expected + 1;
+            }
+        }
+
+        std::optional<size_t> expectedLast;
+        for (auto occurrence = findNaive(data, bytes, 0); occurrence.has_value(); occurrence = findNaive(data, bytes, *occurrence + 1))
+            expectedLast = occurrence;
+        TEST_ASSERT(pattern.findLast(data) == expectedLast);
+    }
+
+    const std::vector<u8> data = { 0x11, 0x22, 0x33, 0x11, 0x22, 0x33, 0x44 };
+    const std::vector<u8> sequence = { 0x11, 0x22 };
+    TEST_ASSERT(hex::BytePattern(sequence).find(data) == 0);
+    TEST_ASSERT(hex::BytePattern(sequence).findLast(data) == 3);
+    TEST_ASSERT(!hex::BytePattern(sequence).find(std::span(data).first(1)).has_value());
+
+    // findLast searches backwards in windows, make sure occurrences crossing a window border are found
+    std::vector<u8> largeData(0x3'0000, 0x00);
+    std::copy(sequence.begin(), sequence.end(), largeData.begin() + 5);
+    TEST_ASSERT(hex::BytePattern(sequence).findLast(largeData) == 5);
+    for (size_t position = 0x2'0000 - 4; position < 0x2'0000 + 4; position++) {
+        auto copy = largeData;
+        std::copy(sequence.begin(), sequence.end(), copy.begin() + position);
+        TEST_ASSERT(hex::BytePattern(sequence).findLast(copy) == position, "position {}", position);
+    }
+
+    TEST_SUCCESS();
+};
+
+// Not registered with CTest because of its runtime, run it manually using `algorithms_test BytePatternBenchmark`
+TEST_SEQUENCE("BytePatternBenchmark") {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<u16> byteDistribution(0, 0xFF);
+
+    std::vector<u8> data(64 * 1024 * 1024);
+    std::generate(data.begin(), data.end(), [&] { return u8(byteDistribution(gen)); });
+
+    const std::vector<u8> sequence = { 0xDE, 0xAD, 0xBE, 0xEF, 0x13, 0x37, 0xCA, 0xFE };
+    std::copy(sequence.begin(), sequence.end(), data.end() - sequence.size());
+
+    std::vector<hex::BytePattern::Byte> masked;
+    for (u8 byte : sequence)
+        masked.push_back({ 0xFF, byte });
+    masked[2] = { 0x00, 0x00 };
+    masked[5] = { 0xF0, 0x30 };
+
+    auto measure = [](const std::string &name, const std::function<std::optional<size_t>()> &function) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = function();
+        const auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        hex::log::info("{:<32} {:8.2f} ms", name, duration.count());
+
+        return result;
+    };
+
+    const auto expected = data.size() - sequence.size();
+
+    auto bmhResult = measure("Sequence: Boyer-Moore-Horspool", [&]() -> std::optional<size_t> {
+        auto it = std::search(data.begin(), data.end(), std::boyer_moore_horspool_searcher(sequence.begin(), sequence.end()));
+        return it == data.end() ? std::nullopt : std::optional<size_t>(it - data.begin());
+    });
+    TEST_ASSERT(bmhResult == expected);
+
+    auto naiveResult = measure("Masked: Naive", [&] { return findNaive(data, masked, 0); });
+    TEST_ASSERT(naiveResult == expected);
+
+    for (auto implementation : Implementations) {
+        if (!hex::BytePattern::isSupported(implementation))
+            continue;
+
+        const auto name = std::array { "Scalar", "SSE2", "AVX2" }[u32(implementation)];
+
+        auto sequenceResult = measure(hex::format("Sequence: {}", name), [&] { return hex::BytePattern(sequence).find(implementation, data); });
+        TEST_ASSERT(sequenceResult == expected);
+
+        auto maskedResult = measure(hex::format("Masked: {}", name), [&] { return hex::BytePattern(masked).find(implementation, data); });
+        TEST_ASSERT(maskedResult == expected);
+    }
+
+    TEST_SUCCESS();
+};
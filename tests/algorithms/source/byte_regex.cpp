@@ -0,0 +1,136 @@
+#include <hex/helpers/byte_regex.hpp>
+#include <hex/test/tests.hpp>
+
+#include <algorithm>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+static std::vector<hex::Region> findAll(const hex::ByteRegex &regex, std::span<const u8> data, size_t pieceSize) {
+    std::vector<hex::Region> result;
+
+    hex::ByteRegex::Matcher matcher(regex, 0, [&](hex::Region match) { result.push_back(match); });
+    for (size_t offset = 0; offset < data.size(); offset += pieceSize)
+        matcher.feed(data.subspan(offset, std::min(pieceSize, data.size() - offset)));
+    matcher.finish();
+
+    return result;
+}
+
+static std::vector<hex::Region> findAll(const std::string &pattern, const std::string &data) {
+    auto regex = hex::ByteRegex::compile(pattern);
+    if (!regex.has_value())
+        return { };
+
+    return findAll(*regex, { reinterpret_cast<const u8 *>(data.data()), data.size() }, data.size() + 1);
+}
+
+// Brute force reference. std::regex_search doesn't guarantee leftmost-longest matches, so try every substring with std::regex_match instead
+static std::vector<hex::Region> findAllReference(const std::string &pattern, const std::string &data) {
+    std::vector<hex::Region> result;
+
+    const std::regex regex(pattern);
+
+    size_t start = 0;
+    while (start < data.size()) {
+        size_t length = 0;
+        for (size_t end = data.size(); end > start; end--) {
+            if (std::regex_match(data.begin() + start, data.begin() + end, regex)) {
+                length = end - start;
+                break;
+            }
+        }
+
+        if (length == 0) {
+            start += 1;
+        } else {
+            result.push_back({ start, length });
+            start += length;
+        }
+    }
+
+    return result;
+}
+
+TEST_SEQUENCE("ByteRegexMatches") {
+    using Regions = std::vector<hex::Region>;
+
+    TEST_ASSERT(findAll("abc", "xxabcxabc") == Regions({ { 2, 3 }, { 6, 3 } }));
+    TEST_ASSERT(findAll("a+", "baaab") == Regions({ { 1, 3 } }));
+    TEST_ASSERT(findAll("a*", "bab") == Regions({ { 1, 1 } }));
+    TEST_ASSERT(findAll("ab|abcd", "abcd") == Regions({ { 0, 4 } }));
+    TEST_ASSERT(findAll("[0-9]{2,3}", "1 12 12345") == Regions({ { 2, 2 }, { 5, 3 }, { 8, 2 } }));
+    TEST_ASSERT(findAll("\\x00\\xFF.", std::string("\x00\xFF\x00\x00\xFF", 5)) == Regions({ { 0, 3 } }));
+    TEST_ASSERT(findAll("[^\\x00]+\\x00", std::string("ab\x00\x00" "cd\x00", 7)) == Regions({ { 0, 3 }, { 4, 3 } }));
+    TEST_ASSERT(findAll("a{", "a{") == Regions({ { 0, 2 } }));
+    TEST_ASSERT(findAll("(?:ab)+c", "abababc") == Regions({ { 0, 7 } }));
+
+    for (auto invalid : { "(", "a)", "*a", "a*?", "[a", "a{3,1}", "a{2000}", "^a", "a$", "(?=a)", "\\1", "\\x4", "(a{1000}){1000}" })
+        TEST_ASSERT(!hex::ByteRegex::compile(invalid).has_value(), "pattern '{}'", invalid);
+
+    // Compare against std::regex using random patterns on data with a small alphabet
+    std::mt19937 gen(1337);
+    const std::vector<std::string> atoms = { "a", "b", "c", "[ab]", "[^a]", ".", "(a|bc)", "(ab|a)", "(b|)" };
+    const std::vector<std::string> quantifiers = { "", "", "*", "+", "?", "{2}", "{1,3}" };
+
+    for (int i = 0; i < 500; i++) {
+        std::string pattern;
+        for (size_t j = 0; j < gen() % 4 + 1; j++)
+            pattern += atoms[gen() % atoms.size()] + quantifiers[gen() % quantifiers.size()];
+        if (gen() % 4 == 0)
+            pattern += "|" + atoms[gen() % atoms.size()];
+
+        std::string data(gen() % 24, '\x00');
+        std::generate(data.begin(), data.end(), [&] { return char('a' + gen() % 3); });
+
+        TEST_ASSERT(findAll(pattern, data) == findAllReference(pattern, data), "pattern '{}' on '{}'", pattern, data);
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ByteRegexStreaming") {
+    std::mt19937 gen(42);
+
+    std::vector<u8> data(0x10000);
+    std::generate(data.begin(), data.end(), [&] { return u8("ab\x00\xFF"[gen() % 4]); });
+
+    for (auto pattern : { "ab+a", "(a|b)*\\x00", "[^\\x00]{4,}", "a.{0,8}\\xFF", "(ab|ba|aab)+" }) {
+        auto regex = hex::ByteRegex::compile(pattern);
+        TEST_ASSERT(regex.has_value(), "pattern '{}'", pattern);
+
+        const auto expected = findAll(*regex, data, data.size());
+        TEST_ASSERT(!expected.empty(), "pattern '{}'", pattern);
+
+        for (size_t pieceSize : { 1, 3, 7, 0x1000 })
+            TEST_ASSERT(findAll(*regex, data, pieceSize) == expected, "pattern '{}' fed in pieces of {}", pattern, pieceSize);
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ByteRegexUTF16") {
+    using Regions = std::vector<hex::Region>;
+    using enum hex::ByteRegex::Encoding;
+
+    auto findAllEncoded = [](const std::string &pattern, hex::ByteRegex::Encoding encoding, const std::string &data) {
+        auto regex = hex::ByteRegex::compile(pattern, encoding);
+        if (!regex.has_value())
+            return Regions();
+
+        return findAll(*regex, { reinterpret_cast<const u8 *>(data.data()), data.size() }, data.size() + 1);
+    };
+
+    const std::string littleEndian("x\x00" "a\x00" "b\x00" "\x34\x12" "a\x00" "b\x00", 12);
+    TEST_ASSERT(findAllEncoded("ab", UTF16LE, littleEndian) == Regions({ { 2, 4 }, { 8, 4 } }));
+    TEST_ASSERT(findAllEncoded("[^x]+", UTF16LE, littleEndian) == Regions({ { 2, 4 }, { 8, 4 } }));
+    TEST_ASSERT(findAllEncoded("a..", UTF16LE, littleEndian) == Regions({ { 2, 6 } }));
+    TEST_ASSERT(findAllEncoded("ab", Bytes, littleEndian).empty());
+
+    const std::string bigEndian("\x00" "a\x00" "b\x00" "c", 6);
+    TEST_ASSERT(findAllEncoded("b[a-z]", UTF16BE, bigEndian) == Regions({ { 2, 4 } }));
+    TEST_ASSERT(findAllEncoded("ab", Bytes, bigEndian).empty());
+
+    TEST_SUCCESS();
+};
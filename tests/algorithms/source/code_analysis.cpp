@@ -0,0 +1,109 @@
+#include <hex/api/task.hpp>
+#include <hex/helpers/code_analysis.hpp>
+#include <hex/test/test_task.hpp>
+#include <hex/test/tests.hpp>
+
+#include <map>
+#include <vector>
+
+using hex::CodeAnalysis;
+using FlowType = CodeAnalysis::FlowType;
+
+using Program = std::map<u64, CodeAnalysis::Instruction>;
+
+static CodeAnalysis analyze(const Program &program, const std::vector<u64> &entryPoints) {
+    const auto createDecoder = [&program] {
+        return [&program](u64 address) -> std::optional<CodeAnalysis::Instruction> {
+            auto it = program.find(address);
+            if (it == program.end())
+                return std::nullopt;
+
+            return it->second;
+        };
+    };
+
+    CodeAnalysis result;
+    hex::test::runTask([&](hex::Task &task) {
+        result = CodeAnalysis::analyze(task, createDecoder, entryPoints);
+    });
+
+    return result;
+}
+
+TEST_SEQUENCE("CodeAnalysisControlFlow") {
+    hex::test::TaskManagerScope taskManager;
+
+    using Reference = CodeAnalysis::Reference;
+    using ReferenceType = CodeAnalysis::ReferenceType;
+
+    const Program program = {
+        { 0x00, { 0x00, 2, FlowType::Normal,          std::nullopt, { } } },
+        { 0x02, { 0x02, 2, FlowType::Call,            0x20,         { } } },
+        { 0x04, { 0x04, 2, FlowType::ConditionalJump, 0x0A,         { } } },
+        { 0x06, { 0x06, 2, FlowType::Normal,          std::nullopt, { 0x40 } } },
+        { 0x08, { 0x08, 2, FlowType::Jump,            0x0C,         { } } },
+        { 0x0A, { 0x0A, 2, FlowType::Normal,          std::nullopt, { } } },
+        { 0x0C, { 0x0C, 2, FlowType::Return,          std::nullopt, { } } },
+        { 0x0E, { 0x0E, 2, FlowType::Normal,          std::nullopt, { } } },
+
+        { 0x20, { 0x20, 4, FlowType::Normal,          std::nullopt, { 0x40 } } },
+        { 0x24, { 0x24, 1, FlowType::Call,            0x00,         { } } },
+        { 0x25, { 0x25, 1, FlowType::Return,          std::nullopt, { } } },
+    };
+
+    auto analysis = analyze(program, { 0x00 });
+
+    TEST_ASSERT(analysis.getFunctions() == std::vector<u64>({ 0x00, 0x20 }));
+
+    // Code that's never reached doesn't get analyzed
+    TEST_ASSERT(analysis.findBasicBlock(0x0E) == nullptr);
+
+    const auto &blocks = analysis.getBasicBlocks();
+    TEST_ASSERT(blocks.size() == 5);
+    TEST_ASSERT(blocks[0].address == 0x00 && blocks[0].size == 6 && blocks[0].instructionCount == 3);
+    TEST_ASSERT(blocks[1].address == 0x06 && blocks[1].size == 4 && blocks[1].instructionCount == 2);
+    TEST_ASSERT(blocks[2].address == 0x0A && blocks[2].size == 2);
+    TEST_ASSERT(blocks[3].address == 0x0C && blocks[3].size == 2);
+    TEST_ASSERT(blocks[4].address == 0x20 && blocks[4].size == 6 && blocks[4].instructionCount == 3);
+
+    TEST_ASSERT(analysis.findBasicBlock(0x07) == &blocks[1]);
+    TEST_ASSERT(analysis.getBasicBlocks(hex::Region { 0x07, 0x10 }).size() == 3);
+    TEST_ASSERT(analysis.getBasicBlocks(hex::Region { 0x07, 0x10 }).front().address == 0x06);
+
+    auto toReferences = [](std::span<const Reference> references) { return std::vector<Reference>(references.begin(), references.end()); };
+    TEST_ASSERT(toReferences(analysis.getReferencesTo(0x00)) == std::vector<Reference>({ { 0x24, 0x00, ReferenceType::Call } }));
+    TEST_ASSERT(toReferences(analysis.getReferencesTo(0x06)) == std::vector<Reference>({ { 0x04, 0x06, ReferenceType::FallThrough } }));
+    TEST_ASSERT(toReferences(analysis.getReferencesTo(0x0A)) == std::vector<Reference>({ { 0x04, 0x0A, ReferenceType::ConditionalJump } }));
+    TEST_ASSERT(toReferences(analysis.getReferencesTo(0x0C)) == std::vector<Reference>({ { 0x08, 0x0C, ReferenceType::Jump }, { 0x0A, 0x0C, ReferenceType::FallThrough } }));
+    TEST_ASSERT(toReferences(analysis.getReferencesTo(0x40)) == std::vector<Reference>({ { 0x06, 0x40, ReferenceType::Data }, { 0x20, 0x40, ReferenceType::Data } }));
+    TEST_ASSERT(analysis.getReferencesTo(0x0E).empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("CodeAnalysisCallChain") {
+    hex::test::TaskManagerScope taskManager;
+
+    constexpr static u64 FunctionCount = 1000;
+
+    // Every function calls the next one, so each round of the analysis discovers a single new function
+    Program program;
+    for (u64 i = 0; i < FunctionCount; i++) {
+        const u64 address = i * 0x10;
+        if (i + 1 < FunctionCount)
+            program[address] = { address, 4, FlowType::Call, address + 0x10, { } };
+        else
+            program[address] = { address, 4, FlowType::Normal,          std::nullopt, { } };
+
+        program[address + 4] = { address + 4, 1, FlowType::Return,          std::nullopt, { } };
+    }
+
+    // Entry points that can't be decoded aren't functions
+    auto analysis = analyze(program, { 0x00, 0x08 });
+
+    TEST_ASSERT(analysis.getFunctions().size() == FunctionCount);
+    TEST_ASSERT(analysis.getBasicBlocks().size() == FunctionCount);
+    TEST_ASSERT(analysis.getReferencesTo((FunctionCount - 1) * 0x10).size() == 1);
+
+    TEST_SUCCESS();
+};
@@ -8,6 +8,7 @@
 #include <array>
 #include <algorithm>
 #include <fmt/ranges.h>
+#include <cstring>
 
 struct EncodeChek {
     std::vector<u8> vec;
@@ -473,3 +474,37 @@ TEST_SEQUENCE("sha512") {
 
     TEST_SUCCESS();
 };
+
+TEST_SEQUENCE("HasherStreaming") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u8> distribution;
+
+    std::vector<u8> data(0x1'2345);
+    std::generate(data.begin(), data.end(), [&] { return distribution(gen); });
+
+    hex::test::TestProvider testprovider(&data);
+    hex::prv::Provider *provider = &testprovider;
+
+    const auto hashInPieces = [&](const std::unique_ptr<hex::crypt::Hasher> &hasher, size_t pieceSize) {
+        for (size_t offset = 0; offset < data.size(); offset += pieceSize)
+            hasher->update(std::span(data).subspan(offset, std::min(pieceSize, data.size() - offset)));
+
+        return hasher->finish();
+    };
+
+    for (size_t pieceSize : { 1, 7, 0x1000, 0x2'0000 }) {
+        auto crc8 = hashInPieces(hex::crypt::crc8Hasher(0x07, 0x00, 0x00, false, false), pieceSize);
+        TEST_ASSERT(crc8 == std::vector<u8>({ hex::crypt::crc8(provider, 0, data.size(), 0x07, 0x00, 0x00, false, false) }), "piece size {}", pieceSize);
+
+        auto crc32 = hashInPieces(hex::crypt::crc32Hasher(0x4C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true), pieceSize);
+        auto expectedCrc32 = hex::crypt::crc32(provider, 0, data.size(), 0x4C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true);
+        TEST_ASSERT(crc32.size() == sizeof(expectedCrc32) && std::memcmp(crc32.data(), &expectedCrc32, sizeof(expectedCrc32)) == 0, "piece size {}", pieceSize);
+
+        auto sha256 = hashInPieces(hex::crypt::sha256Hasher(), pieceSize);
+        auto expectedSha256 = hex::crypt::sha256(provider, 0, data.size());
+        TEST_ASSERT(std::equal(sha256.begin(), sha256.end(), expectedSha256.begin(), expectedSha256.end()), "piece size {}", pieceSize);
+    }
+
+    TEST_SUCCESS();
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <hex/api/task.hpp>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace hex::test {
+
+    /**
+     * @brief Keeps the task manager running for as long as the object exists
+     */
+    class TaskManagerScope {
+    public:
+        TaskManagerScope() { TaskManager::init(); }
+        ~TaskManagerScope() { TaskManager::exit(); }
+
+        TaskManagerScope(const TaskManagerScope &) = delete;
+        TaskManagerScope &operator=(const TaskManagerScope &) = delete;
+    };
+
+    /**
+     * @brief Blocks until a task has finished
+     * @param task Task to wait for
+     */
+    inline void waitForTask(const TaskHolder &task) {
+        while (task.isRunning())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    /**
+     * @brief Runs a function as a task and blocks until it has finished
+     * @param function Function to run
+     * @param maxValue Maximum progress value of the task
+     */
+    inline void runTask(const std::function<void(Task &)> &function, u64 maxValue = TaskManager::NoProgress) {
+        waitForTask(TaskManager::createTask("Test", maxValue, function));
+    }
+
+}
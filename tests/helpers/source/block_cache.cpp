@@ -0,0 +1,70 @@
+#include <hex/test/tests.hpp>
+
+#include <hex/providers/block_cache.hpp>
+
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+TEST_SEQUENCE("BlockCacheLRU") {
+    std::vector<u8> data(0x1000);
+    std::iota(data.begin(), data.end(), 0);
+
+    size_t backendReads = 0;
+    hex::prv::BlockCache cache([&](u64 offset, u8 *buffer, size_t size) {
+        backendReads += 1;
+        std::memcpy(buffer, data.data() + offset, size);
+    }, 0x10, 2);
+
+    std::vector<u8> buffer(0x18);
+
+    // Unaligned read spanning two blocks gets fetched in one go
+    cache.read(0x08, buffer.data(), buffer.size());
+    TEST_ASSERT(std::memcmp(buffer.data(), data.data() + 0x08, buffer.size()) == 0);
+    TEST_ASSERT(backendReads == 1);
+    TEST_ASSERT(cache.getMissCount() == 2 && cache.getHitCount() == 0);
+
+    cache.read(0x10, buffer.data(), 4);
+    TEST_ASSERT(backendReads == 1);
+    TEST_ASSERT(cache.getHitCount() == 1);
+
+    // Reading a third block evicts the least recently used one, which is block 0x00
+    cache.read(0x40, buffer.data(), 4);
+    cache.read(0x10, buffer.data(), 4);
+    TEST_ASSERT(backendReads == 2);
+    cache.read(0x00, buffer.data(), 4);
+    TEST_ASSERT(backendReads == 3);
+    TEST_ASSERT(cache.getCachedBlockCount() == 2);
+
+    // Invalidated blocks have to be fetched again and see the new data
+    data[0x02] = 0xAA;
+    cache.invalidate(0x02, 1);
+    cache.read(0x00, buffer.data(), 4);
+    TEST_ASSERT(backendReads == 4);
+    TEST_ASSERT(buffer[2] == 0xAA);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("BlockCacheReadAhead") {
+    std::vector<u8> data(0x1000);
+    std::iota(data.begin(), data.end(), 0);
+
+    size_t backendReads = 0;
+    hex::prv::BlockCache cache([&](u64 offset, u8 *buffer, size_t size) {
+        backendReads += 1;
+        std::memcpy(buffer, data.data() + offset, size);
+    }, 0x10, 0x20, 4);
+
+    // Reading sequentially only goes to the backend every few blocks
+    u8 byte = 0;
+    for (u64 offset = 0; offset < 0x100; offset++) {
+        cache.read(offset, &byte, 1);
+        TEST_ASSERT(byte == data[offset]);
+    }
+
+    TEST_ASSERT(backendReads < 0x10);
+    TEST_ASSERT(cache.getMissCount() == backendReads);
+
+    TEST_SUCCESS();
+};
@@ -0,0 +1,90 @@
+#include <hex/test/tests.hpp>
+#include <hex/test/test_provider.hpp>
+#include <hex/test/test_task.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/helpers/block_hash_index.hpp>
+
+#include <random>
+#include <vector>
+
+static void updateIndex(hex::BlockHashIndex &index, hex::prv::Provider *provider) {
+    hex::test::runTask([&](hex::Task &task) {
+        index.update(task, provider);
+    });
+}
+
+TEST_SEQUENCE("BlockHashIndexChanges") {
+    hex::test::TaskManagerScope taskManager;
+
+    std::mt19937 gen(1337);
+    std::vector<u8> data(0x1'0000 + 0x123);
+    std::generate(data.begin(), data.end(), [&] { return u8(gen()); });
+    auto modifiedData = data;
+
+    hex::test::TestProvider provider(&data), modifiedProvider(&modifiedData);
+
+    hex::BlockHashIndex index(0x100), modifiedIndex(0x100);
+    updateIndex(index, &provider);
+    updateIndex(modifiedIndex, &modifiedProvider);
+
+    TEST_ASSERT(index.isUpToDate() && index.getBlockCount() == 0x102);
+    TEST_ASSERT(index.getRootHash() == modifiedIndex.getRootHash());
+    TEST_ASSERT(index.getChangedRegions(modifiedIndex).empty());
+
+    // Only the modified blocks need to be hashed again
+    modifiedData[0x250] ^= 0xFF;
+    modifiedData[0x8000] ^= 0xFF;
+    modifiedData[0x80FF] ^= 0xFF;
+    modifiedIndex.invalidate({ 0x250, 1 });
+    modifiedIndex.invalidate({ 0x8000, 0x100 });
+    TEST_ASSERT(modifiedIndex.getOutdatedSize() == 0x200);
+
+    updateIndex(modifiedIndex, &modifiedProvider);
+    TEST_ASSERT(index.getRootHash() != modifiedIndex.getRootHash());
+    TEST_ASSERT(index.getChangedRegions(modifiedIndex) == std::vector<hex::Region>({ { 0x200, 0x100 }, { 0x8000, 0x100 } }));
+
+    // Growing the data marks the previously last block and all new blocks as changed
+    modifiedData.resize(data.size() + 0x200, 0x00);
+    updateIndex(modifiedIndex, &modifiedProvider);
+    TEST_ASSERT(modifiedIndex.getBlockCount() == 0x104);
+    TEST_ASSERT(index.getChangedRegions(modifiedIndex) == std::vector<hex::Region>({ { 0x200, 0x100 }, { 0x8000, 0x100 }, { 0x1'0100, 0x223 } }));
+    TEST_ASSERT(modifiedIndex.getChangedRegions(index) == index.getChangedRegions(modifiedIndex));
+
+    // Restoring the original data results in the original tree
+    modifiedData = data;
+    modifiedIndex.invalidate({ 0x00, modifiedData.size() });
+    updateIndex(modifiedIndex, &modifiedProvider);
+    TEST_ASSERT(index.getRootHash() == modifiedIndex.getRootHash());
+    TEST_ASSERT(index.getChangedRegions(modifiedIndex).empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("BlockHashIndexSerialization") {
+    hex::test::TaskManagerScope taskManager;
+
+    std::vector<u8> data(0x4321);
+    std::generate(data.begin(), data.end(), [value = u8(0)]() mutable { return value += 7; });
+
+    hex::test::TestProvider provider(&data);
+
+    hex::BlockHashIndex index(0x400);
+    updateIndex(index, &provider);
+
+    auto restored = hex::BlockHashIndex::deserialize(index.serialize());
+    TEST_ASSERT(restored.has_value());
+    TEST_ASSERT(restored->getBlockSize() == 0x400 && restored->getDataSize() == data.size());
+    TEST_ASSERT(restored->getRootHash() == index.getRootHash());
+    TEST_ASSERT(restored->getChangedRegions(index).empty());
+
+    auto serialized = index.serialize();
+    serialized.pop_back();
+    TEST_ASSERT(!hex::BlockHashIndex::deserialize(serialized).has_value());
+
+    // Outdated indices can't be serialized
+    index.invalidate({ 0x10, 1 });
+    TEST_ASSERT(index.serialize().empty());
+
+    TEST_SUCCESS();
+};
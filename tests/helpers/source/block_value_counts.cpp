@@ -0,0 +1,68 @@
+#include <hex/test/tests.hpp>
+
+#include <hex/helpers/block_value_counts.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+static void countBlocks(hex::BlockValueCounts &counts, const std::vector<u8> &data, const std::vector<hex::Region> &blocks) {
+    for (const auto &region : blocks) {
+        for (u64 address = region.getStartAddress(); address <= region.getEndAddress(); address += counts.getBlockSize()) {
+            const u64 endAddress = std::min(address + counts.getBlockSize(), region.getEndAddress() + 1);
+
+            hex::BlockValueCounts::Counts blockCounts = { };
+            for (u64 i = address; i < endAddress; i++)
+                blockCounts[data[i]]++;
+
+            counts.setBlock(address, blockCounts);
+        }
+    }
+}
+
+TEST_SEQUENCE("BlockValueCountsModifications") {
+    constexpr static hex::Region CountedRegion = { 0x100, 0x5'4321 };
+
+    std::mt19937 gen(1337);
+    std::vector<u8> data(0x6'0000);
+    std::generate(data.begin(), data.end(), [&] { return u8(gen() % 0x20); });
+
+    hex::BlockValueCounts counts(CountedRegion, 0x1'0000);
+    countBlocks(counts, data, { CountedRegion });
+    TEST_ASSERT(counts.getBlocks().size() == 6);
+
+    // Overlapping and adjacent modifications get merged, everything outside of the counted region is ignored
+    const std::vector<hex::Region> modifications = {
+        { 0x3'0000, 0x10 },
+        { 0x00, 0x200 },
+        { 0x2'FFF0, 0x20 },
+        { 0x1'0100, 0x04 },
+        { 0x5'4421, 0x100 },
+        { 0x5'0000, 0x8000 },
+    };
+
+    for (const auto &modification : modifications) {
+        for (u64 address = modification.getStartAddress(); address <= modification.getEndAddress(); address++)
+            data[address] = u8(0x80 + gen() % 0x10);
+    }
+
+    const auto modifiedBlocks = counts.getModifiedBlocks(modifications);
+    TEST_ASSERT(modifiedBlocks == std::vector<hex::Region>({ { 0x100, 0x3'0000 }, { 0x4'0100, 0x1'4321 } }));
+
+    // Counting only the modified blocks again gives the same result as counting everything from scratch
+    countBlocks(counts, data, modifiedBlocks);
+
+    hex::BlockValueCounts expectedCounts(CountedRegion, 0x1'0000);
+    countBlocks(expectedCounts, data, { CountedRegion });
+
+    TEST_ASSERT(counts.getTotals() == expectedCounts.getTotals());
+    TEST_ASSERT(counts.getBlocks() == expectedCounts.getBlocks());
+
+    // Restoring stored block counts recalculates the totals
+    hex::BlockValueCounts restoredCounts(CountedRegion, 0x1'0000);
+    TEST_ASSERT(!restoredCounts.setBlocks({ }));
+    TEST_ASSERT(restoredCounts.setBlocks(counts.getBlocks()));
+    TEST_ASSERT(restoredCounts.getTotals() == expectedCounts.getTotals());
+
+    TEST_SUCCESS();
+};
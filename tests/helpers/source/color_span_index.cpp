@@ -0,0 +1,54 @@
+#include <hex/test/tests.hpp>
+
+#include <hex/helpers/color_span_index.hpp>
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+using Span = hex::ColorSpanIndex::Span;
+
+TEST_SEQUENCE("ColorSpanIndexDisjoint") {
+    hex::ColorSpanIndex index({
+        { { 0x00, 0x04 }, 0xFF0000FF },
+        { { 0x04, 0x04 }, 0xFF0000FF },
+        { { 0x10, 0x08 }, 0xFF00FF00 },
+        { { 0x18, 0x00 }, 0xFFFF0000 },
+    });
+
+    // Adjacent spans with the same color get merged, empty ones get dropped
+    TEST_ASSERT(index.getSpans().size() == 2);
+    TEST_ASSERT((index.getSpans()[0] == Span { { 0x00, 0x08 }, 0xFF0000FF }));
+
+    TEST_ASSERT(index.find({ 0x08, 0x08 }).empty());
+    TEST_ASSERT(index.find({ 0x07, 0x0A }).size() == 2);
+    TEST_ASSERT(index.find({ 0x14, 0x100 }).size() == 1);
+    TEST_ASSERT(index.find({ 0x18, 0x100 }).empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ColorSpanIndexBlending") {
+    const color_t outer = 0x80FF0000, inner = 0x8000FF00;
+
+    hex::ColorSpanIndex index({
+        { { 0x00, 0x10 }, outer },
+        { { 0x04, 0x04 }, inner },
+        { { 0x06, 0x10 }, outer },
+    });
+
+    const auto &spans = index.getSpans();
+    TEST_ASSERT(spans.size() == 5);
+    TEST_ASSERT((spans[0] == Span { { 0x00, 0x04 }, outer }));
+    TEST_ASSERT((spans[1] == Span { { 0x04, 0x02 }, ImAlphaBlendColors(outer, inner) }));
+    TEST_ASSERT((spans[2] == Span { { 0x06, 0x02 }, ImAlphaBlendColors(ImAlphaBlendColors(outer, inner), outer) }));
+    TEST_ASSERT((spans[3] == Span { { 0x08, 0x08 }, ImAlphaBlendColors(outer, outer) }));
+    TEST_ASSERT((spans[4] == Span { { 0x10, 0x06 }, outer }));
+
+    // Spans only partially inside of the searched region are included as well
+    auto found = index.find({ 0x05, 0x02 });
+    TEST_ASSERT(found.size() == 2);
+    TEST_ASSERT(found.front().region.getStartAddress() == 0x04);
+    TEST_ASSERT(found.back().region.getStartAddress() == 0x06);
+
+    TEST_SUCCESS();
+};
@@ -0,0 +1,169 @@
+#include <hex/data_processor/node.hpp>
+#include <hex/test/tests.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <memory>
+#include <vector>
+
+using hex::dp::Attribute;
+using hex::dp::Node;
+
+namespace {
+
+    class NodeConstant : public Node {
+    public:
+        explicit NodeConstant(bool isVolatile = false) : Node("Constant", { Attribute(Attribute::IOType::Out, Attribute::Type::Integer, "") }), m_volatile(isVolatile) { }
+
+        [[nodiscard]] bool isVolatile() const override { return this->m_volatile; }
+
+        void process() override {
+            this->processCount++;
+            this->setIntegerOnOutput(0, this->value);
+        }
+
+        void store(nlohmann::json &j) const override {
+            j = nlohmann::json::object();
+            j["value"] = this->value;
+        }
+
+        u64 value = 0;
+        u32 processCount = 0;
+
+    private:
+        bool m_volatile;
+    };
+
+    class NodeAdd : public Node {
+    public:
+        NodeAdd() : Node("Add", { Attribute(Attribute::IOType::In, Attribute::Type::Integer, "a"), Attribute(Attribute::IOType::In, Attribute::Type::Integer, "b"), Attribute(Attribute::IOType::Out, Attribute::Type::Integer, "") }) { }
+
+        void process() override {
+            this->processCount++;
+            this->setIntegerOnOutput(2, this->getIntegerOnInput(0) + this->getIntegerOnInput(1));
+        }
+
+        u32 processCount = 0;
+    };
+
+    class NodeDisplay : public Node {
+    public:
+        NodeDisplay() : Node("Display", { Attribute(Attribute::IOType::In, Attribute::Type::Integer, "") }) { }
+
+        void process() override {
+            this->processCount++;
+            this->value = this->getIntegerOnInput(0);
+        }
+
+        i128 value = 0;
+        u32 processCount = 0;
+    };
+
+    class NodeNested : public Node {
+    public:
+        explicit NodeNested(std::vector<Node *> plan) : Node("Nested", { }), m_plan(std::move(plan)) { }
+
+        void process() override {
+            Node::execute(this->m_plan);
+        }
+
+    private:
+        std::vector<Node *> m_plan;
+    };
+
+    void connect(Node &from, u32 fromIndex, Node &to, u32 toIndex) {
+        static int linkId = 1;
+
+        auto &fromAttribute = from.getAttributes()[fromIndex];
+        auto &toAttribute   = to.getAttributes()[toIndex];
+
+        fromAttribute.addConnectedAttribute(linkId, &toAttribute);
+        toAttribute.addConnectedAttribute(linkId, &fromAttribute);
+        linkId++;
+    }
+
+}
+
+TEST_SEQUENCE("DataProcessorMemoization") {
+    NodeConstant constantA, constantB(true);
+    NodeAdd add;
+    NodeDisplay displayA, displayB;
+
+    connect(constantA, 0, add, 0);
+    connect(constantB, 0, add, 1);
+    connect(add, 2, displayA, 0);
+    connect(add, 2, displayB, 0);
+
+    std::vector<Node *> endNodes = { &displayA, &displayB };
+    auto plan = Node::createExecutionPlan(endNodes);
+    TEST_ASSERT(plan.size() == 5);
+    TEST_ASSERT(plan.back() == &displayB);
+
+    // Nodes shared by multiple end nodes are only processed once
+    constantA.value = 1;
+    constantB.value = 2;
+    Node::execute(plan);
+    TEST_ASSERT(displayA.value == 3 && displayB.value == 3);
+    TEST_ASSERT(constantA.processCount == 1 && add.processCount == 1 && displayA.processCount == 1 && displayB.processCount == 1);
+
+    // Nothing changed, so only the volatile node gets processed again
+    Node::execute(plan);
+    TEST_ASSERT(constantA.processCount == 1 && constantB.processCount == 2 && add.processCount == 1 && displayA.processCount == 1);
+
+    // Changing a node's settings processes all nodes depending on it again
+    constantA.value = 5;
+    Node::execute(plan);
+    TEST_ASSERT(displayA.value == 7 && displayB.value == 7);
+    TEST_ASSERT(constantA.processCount == 2 && add.processCount == 2 && displayB.processCount == 2);
+
+    // So does a changed output of a volatile node
+    constantB.value = 10;
+    Node::execute(plan);
+    TEST_ASSERT(displayA.value == 15 && add.processCount == 3 && constantA.processCount == 2);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("DataProcessorNestedExecution") {
+    NodeConstant innerConstant, outerConstant(true);
+    NodeDisplay innerDisplay, outerDisplayA, outerDisplayB;
+
+    connect(innerConstant, 0, innerDisplay, 0);
+    std::vector<Node *> innerEndNodes = { &innerDisplay };
+    NodeNested nested(Node::createExecutionPlan(innerEndNodes));
+
+    connect(outerConstant, 0, outerDisplayA, 0);
+    connect(outerConstant, 0, outerDisplayB, 0);
+    std::vector<Node *> outerEndNodes = { &outerDisplayA, &nested, &outerDisplayB };
+    auto plan = Node::createExecutionPlan(outerEndNodes);
+
+    // Executing the nested graph in between must not cause the outer nodes to be evaluated a second time
+    innerConstant.value = 1;
+    outerConstant.value = 2;
+    Node::execute(plan);
+    TEST_ASSERT(innerDisplay.value == 1 && outerDisplayA.value == 2 && outerDisplayB.value == 2);
+    TEST_ASSERT(innerConstant.processCount == 1 && outerConstant.processCount == 1, "{} {}", innerConstant.processCount, outerConstant.processCount);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("DataProcessorRecursion") {
+    NodeAdd addA, addB;
+    NodeDisplay display;
+
+    connect(addA, 2, addB, 0);
+    connect(addB, 2, addA, 0);
+    connect(addB, 2, display, 0);
+
+    std::vector<Node *> endNodes = { &display };
+
+    bool recursionDetected = false;
+    try {
+        auto plan = Node::createExecutionPlan(endNodes);
+    } catch (const Node::NodeError &error) {
+        recursionDetected = error.message == "Recursion detected!";
+    }
+    TEST_ASSERT(recursionDetected);
+
+    TEST_SUCCESS();
+};
@@ -0,0 +1,46 @@
+#include <hex/test/tests.hpp>
+
+#include <hex/helpers/encoding_file.hpp>
+
+#include <wolv/io/file.hpp>
+
+#include <array>
+
+TEST_SEQUENCE("EncodingFileLongestMatch") {
+    const auto FilePath = std::fs::current_path() / "encoding.tbl";
+
+    {
+        wolv::io::File file(FilePath, wolv::io::File::Mode::Create);
+        TEST_ASSERT(file.isValid());
+
+        file.writeString("41=A\n4142=AB\n414243=ABC\n42=B\n43=Second C\n43=C\nFF00= \n");
+    }
+
+    hex::EncodingFile encoding(hex::EncodingFile::Type::Thingy, FilePath);
+    wolv::io::File(FilePath, wolv::io::File::Mode::Write).remove();
+
+    TEST_ASSERT(encoding.valid());
+    TEST_ASSERT(encoding.getLongestSequence() == 3);
+
+    constexpr static std::array<u8, 4> Data = { 0x41, 0x42, 0x43, 0x44 };
+
+    // The longest sequence matching the data wins
+    TEST_ASSERT((encoding.getEncodingFor(Data) == std::pair<std::string_view, size_t>("ABC", 3)));
+    TEST_ASSERT((encoding.getEncodingFor(std::span(Data).first(2)) == std::pair<std::string_view, size_t>("AB", 2)));
+
+    // Prefixes of longer sequences without a mapping fall back to shorter ones
+    constexpr static std::array<u8, 3> Partial = { 0x41, 0x42, 0x44 };
+    TEST_ASSERT(encoding.getEncodingLengthFor(Partial) == 2);
+
+    // The first mapping of a sequence is used
+    TEST_ASSERT(encoding.getEncodingFor(std::span(Data).subspan(2)).first == "Second C");
+
+    // Unknown bytes decode to a single placeholder character
+    TEST_ASSERT((encoding.getEncodingFor(std::span(Data).subspan(3)) == std::pair<std::string_view, size_t>(".", 1)));
+    TEST_ASSERT(encoding.getEncodingLengthFor(std::span<const u8>()) == 1);
+
+    constexpr static std::array<u8, 2> Space = { 0xFF, 0x00 };
+    TEST_ASSERT(encoding.getEncodingFor(Space).first == " ");
+
+    TEST_SUCCESS();
+};
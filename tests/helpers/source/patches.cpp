@@ -0,0 +1,130 @@
+#include <hex/test/tests.hpp>
+
+#include <hex/helpers/patches.hpp>
+#include <hex/providers/undo_stack.hpp>
+
+#include <array>
+#include <vector>
+
+TEST_SEQUENCE("PatchesMergeExtents") {
+    hex::Patches patches;
+
+    constexpr std::array<u8, 4> Bytes = { 0x11, 0x22, 0x33, 0x44 };
+
+    patches.set(0x10, Bytes.data(), 2);
+    patches.set(0x14, Bytes.data(), 2);
+    TEST_ASSERT(patches.getExtentCount() == 2);
+    TEST_ASSERT(patches.size() == 4);
+
+    // Filling the gap merges both extents into one
+    patches.set(0x12, Bytes.data() + 2, 2);
+    TEST_ASSERT(patches.getExtentCount() == 1);
+    TEST_ASSERT(patches.size() == 6);
+    TEST_ASSERT(patches.get(0x12) == 0x33);
+    TEST_ASSERT(patches.get(0x15) == 0x22);
+    TEST_ASSERT(!patches.contains(0x16));
+
+    // Overwriting the front of an extent extends it
+    patches.set(0x0E, Bytes.data(), 4);
+    TEST_ASSERT(patches.getExtentCount() == 1);
+    TEST_ASSERT(patches.size() == 8);
+    TEST_ASSERT(patches.begin()->first == 0x0E);
+    TEST_ASSERT(patches.get(0x11) == 0x44);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("PatchesEraseSplitsExtents") {
+    hex::Patches patches;
+
+    constexpr std::array<u8, 8> Bytes = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 };
+    patches.set(0x100, Bytes.data(), Bytes.size());
+
+    patches.erase(0x102, 3);
+    TEST_ASSERT(patches.getExtentCount() == 2);
+    TEST_ASSERT(patches.size() == 5);
+    TEST_ASSERT(!patches.contains(0x103));
+    TEST_ASSERT(patches.get(0x105) == 0x55);
+
+    std::array<u8, 8> buffer = { };
+    buffer.fill(0xFF);
+    patches.apply(0x100, buffer.data(), buffer.size());
+    TEST_ASSERT(buffer == (std::array<u8, 8>{ 0x00, 0x11, 0xFF, 0xFF, 0xFF, 0x55, 0x66, 0x77 }));
+
+    // Removing the gap joins both halves again
+    patches.remove(0x102, 3);
+    TEST_ASSERT(patches.getExtentCount() == 1);
+    TEST_ASSERT(patches.get(0x102) == 0x55);
+
+    patches.insert(0x101, 0x10);
+    TEST_ASSERT(patches.getExtentCount() == 2);
+    TEST_ASSERT(patches.get(0x100) == 0x00);
+    TEST_ASSERT(patches.get(0x111) == 0x11);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("PatchesIPSRoundTrip") {
+    hex::Patches patches;
+
+    constexpr std::array<u8, 3> Bytes = { 0xAA, 0xBB, 0xCC };
+    patches.set(0x1234, Bytes.data(), Bytes.size());
+    patches.set(0x8000, 0x42);
+
+    // Extents larger than a single record get split into multiple records
+    const std::vector<u8> largeExtent(0x1'2345, 0x5A);
+    patches.set(0x1'0000, largeExtent.data(), largeExtent.size());
+
+    auto ips = hex::generateIPSPatch(patches);
+    TEST_ASSERT(ips.has_value());
+    auto loadedIPS = hex::loadIPSPatch(*ips);
+    TEST_ASSERT(loadedIPS.has_value() && *loadedIPS == patches);
+
+    auto ips32 = hex::generateIPS32Patch(patches);
+    TEST_ASSERT(ips32.has_value());
+    auto loadedIPS32 = hex::loadIPS32Patch(*ips32);
+    TEST_ASSERT(loadedIPS32.has_value() && *loadedIPS32 == patches);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("UndoStackDeltas") {
+    hex::Patches patches;
+    hex::prv::UndoStack undoStack;
+
+    constexpr std::array<u8, 4> Bytes = { 0x11, 0x22, 0x33, 0x44 };
+
+    // Consecutive standalone modifications of adjacent bytes get merged into a single undo step
+    for (u64 i = 0; i < Bytes.size(); i++) {
+        undoStack.prepare(patches, { 0x10 + i, 1 }, true);
+        patches.set(0x10 + i, Bytes[i]);
+        undoStack.commit(patches);
+    }
+
+    // Collected modifications form one undo step once committed
+    undoStack.prepare(patches, { 0x100, 2 }, false);
+    patches.set(0x100, Bytes.data(), 2);
+    undoStack.prepare(patches, { 0x12, 4 }, false);
+    patches.set(0x12, Bytes.data(), 4);
+    undoStack.commit(patches);
+
+    TEST_ASSERT(patches.size() == 8);
+    TEST_ASSERT(patches.get(0x12) == 0x11);
+
+    TEST_ASSERT(undoStack.undo(patches) == hex::Region({ 0x12, 0xF0 }));
+    TEST_ASSERT(patches.size() == 4);
+    TEST_ASSERT(patches.get(0x12) == 0x33);
+    TEST_ASSERT(!patches.contains(0x100));
+
+    TEST_ASSERT(undoStack.undo(patches));
+    TEST_ASSERT(patches.empty());
+    TEST_ASSERT(!undoStack.canUndo());
+
+    TEST_ASSERT(undoStack.redo(patches));
+    TEST_ASSERT(patches.size() == 4);
+    TEST_ASSERT(undoStack.redo(patches));
+    TEST_ASSERT(patches.size() == 8);
+    TEST_ASSERT(!undoStack.canRedo());
+
+    TEST_SUCCESS();
+};
@@ -0,0 +1,81 @@
+#include <hex/api/task.hpp>
+#include <hex/test/tests.hpp>
+#include <hex/test/test_task.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using hex::test::waitForTask;
+
+TEST_SEQUENCE("TaskParallelFor") {
+    hex::test::TaskManagerScope taskManager;
+
+    constexpr static hex::Region SearchRegion = { 0x1000, 0x10'0123 };
+
+    std::vector<std::atomic<u32>> visits(SearchRegion.getSize());
+    std::atomic<u64> nestedChunks = 0;
+    bool progressCorrect = false, exceptionForwarded = false;
+
+    auto task = hex::TaskManager::createTask("Test", SearchRegion.getSize(), [&](hex::Task &task) {
+        task.parallelFor(SearchRegion, 0x1000, [&](hex::Task &subtask, hex::Region chunk) {
+            for (u64 address = chunk.getStartAddress(); address <= chunk.getEndAddress(); address++)
+                visits[address - SearchRegion.getStartAddress()]++;
+
+            // Partial progress of a subtask must not get counted twice
+            subtask.update(chunk.getSize() / 2);
+
+            subtask.parallelFor(chunk, 0x400, [&](hex::Task &, hex::Region) { nestedChunks++; });
+        });
+
+        progressCorrect = task.getValue() == SearchRegion.getSize();
+
+        try {
+            task.parallelFor(SearchRegion, 0x1000, [](hex::Task &, hex::Region chunk) {
+                if (chunk.getStartAddress() == SearchRegion.getStartAddress() + 0x5000)
+                    throw std::runtime_error("Chunk failed");
+            });
+        } catch (const std::runtime_error &) {
+            exceptionForwarded = true;
+        }
+    });
+
+    waitForTask(task);
+
+    TEST_ASSERT(std::all_of(visits.begin(), visits.end(), [](const auto &count) { return count == 1; }));
+    TEST_ASSERT(nestedChunks == 0x100 * 4 + 1, "{}", u64(nestedChunks));
+    TEST_ASSERT(progressCorrect);
+    TEST_ASSERT(exceptionForwarded);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("TaskParallelForInterrupt") {
+    hex::test::TaskManagerScope taskManager;
+
+    std::atomic<u64> processedChunks = 0;
+    std::atomic<bool> started = false;
+
+    auto task = hex::TaskManager::createTask("Test", 0, [&](hex::Task &task) {
+        task.parallelFor({ 0x00, 0x1'0000 }, 1, [&](hex::Task &subtask, hex::Region) {
+            started = true;
+            processedChunks++;
+
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            subtask.update();
+        });
+    });
+
+    while (!started)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    task.interrupt();
+    waitForTask(task);
+
+    TEST_ASSERT(processedChunks < 0x1'0000, "{}", u64(processedChunks));
+
+    TEST_SUCCESS();
+};